@@ -875,47 +875,22 @@ void CG_BuildableStatusParse( const char *filename, buildStat_t *bs )
 #define STATUS_FADE_TIME      200
 #define STATUS_MAX_VIEW_DIST  900.0f
 #define STATUS_PEEK_DIST      20
+#define STATUS_TRACES         4     // visibility tests per frame
+#define STATUS_TRACE_TIMEOUT  1000  // results older than this are retested first
+
 /*
 ==================
-CG_BuildableStatusDisplay
+CG_BuildableStatusOrigin
+
+Center point of a buildable, which the status is drawn at and traced to
 ==================
 */
-static void CG_BuildableStatusDisplay( centity_t *cent )
+static void CG_BuildableStatusOrigin( centity_t *cent, vec3_t origin )
 {
   entityState_t   *es = &cent->currentState;
-  vec3_t          origin;
-  float           healthScale;
-  int             health;
-  float           x, y;
-  vec4_t          color;
-  qboolean        powered, marked;
-  trace_t         tr;
-  float           d;
-  buildStat_t     *bs;
-  int             i, j;
-  int             entNum;
-  vec3_t          trOrigin;
-  vec3_t          right;
-  qboolean        visible = qfalse;
   vec3_t          mins, maxs;
-  entityState_t   *hit;
   int             anim;
 
-  if( BG_FindTeamForBuildable( es->modelindex ) == BIT_ALIENS )
-    bs = &cgs.alienBuildStat;
-  else
-    bs = &cgs.humanBuildStat;
-
-  if( !bs->loaded )
-    return;
-  
-  d = Distance( cent->lerpOrigin, cg.refdef.vieworg );
-  if( d > STATUS_MAX_VIEW_DIST )
-    return;
- 
-  Vector4Copy( bs->foreColor, color );
-
-  // trace for center point 
   BG_FindBBoxForBuildable( es->modelindex, mins, maxs );
 
   // hack for shrunken barricades
@@ -929,11 +904,33 @@ static void CG_BuildableStatusDisplay( centity_t *cent )
   // center point
   origin[ 2 ] += mins[ 2 ];
   origin[ 2 ] += ( fabs( mins[ 2 ] ) + fabs( maxs[ 2 ] ) ) / 2;
+}
+
+/*
+==================
+CG_BuildableStatusTrace
+
+Trace from the view to a buildable and cache whether it can be seen
+==================
+*/
+static void CG_BuildableStatusTrace( centity_t *cent )
+{
+  entityState_t   *es = &cent->currentState;
+  vec3_t          origin;
+  trace_t         tr;
+  int             i, j;
+  int             entNum;
+  vec3_t          trOrigin;
+  vec3_t          right;
+  qboolean        visible = qfalse;
+  entityState_t   *hit;
+
+  CG_BuildableStatusOrigin( cent, origin );
 
   entNum = cg.predictedPlayerState.clientNum;
 
   // if first try fails, step left, step right
-  for( j = 0; j < 3; j++ )
+  for( j = 0; j < 3 && !visible; j++ )
   {
     VectorCopy( cg.refdef.vieworg, trOrigin );
     switch( j )
@@ -977,6 +974,58 @@ static void CG_BuildableStatusDisplay( centity_t *cent )
         break;
     }
   }
+
+  cent->buildableStatus.traceVisible  = visible;
+  cent->buildableStatus.traceTime     = cg.time;
+}
+
+/*
+==================
+CG_BuildableStatusStale
+
+True if a buildable's cached visibility has never been traced or is too old
+to trust, which happens when it comes into view or the builder reselects
+the build weapon
+==================
+*/
+static qboolean CG_BuildableStatusStale( centity_t *cent )
+{
+  int age = cg.time - cent->buildableStatus.traceTime;
+
+  return !cent->buildableStatus.traceTime ||
+         age < 0 || age > STATUS_TRACE_TIMEOUT;
+}
+
+/*
+==================
+CG_BuildableStatusDisplay
+==================
+*/
+static void CG_BuildableStatusDisplay( centity_t *cent, float d )
+{
+  entityState_t   *es = &cent->currentState;
+  vec3_t          origin;
+  float           healthScale;
+  int             health;
+  float           x, y;
+  vec4_t          color;
+  qboolean        powered, marked;
+  buildStat_t     *bs;
+  qboolean        visible;
+
+  if( BG_FindTeamForBuildable( es->modelindex ) == BIT_ALIENS )
+    bs = &cgs.alienBuildStat;
+  else
+    bs = &cgs.humanBuildStat;
+
+  if( !bs->loaded )
+    return;
+
+  Vector4Copy( bs->foreColor, color );
+
+  CG_BuildableStatusOrigin( cent, origin );
+  visible = cent->buildableStatus.traceVisible;
+
   // hack to make the kit obscure view
   if( cg_drawGun.integer && visible &&
       cg.predictedPlayerState.stats[ STAT_PTEAM ] == PTE_HUMANS &&
@@ -1145,21 +1194,120 @@ static void CG_BuildableStatusDisplay( centity_t *cent )
   }
 }
 
-static int QDECL CG_SortDistance( const void *a, const void *b )
+// buildables with a status overlay, kept far to near between frames so the
+// order only needs touching up as the view moves
+static int    statusList[ MAX_GENTITIES ];
+static float  statusDist[ MAX_GENTITIES ];
+static int    numStatus;
+static int    nextStatusTrace;
+
+/*
+==================
+CG_UpdateBuildableStatusList
+
+Drop buildables that have left the snapshot, append ones that have entered
+it and re-sort by distance, starting from last frame's order
+==================
+*/
+static void CG_UpdateBuildableStatusList( void )
 {
-  centity_t    *aent, *bent;
-  float        adist, bdist;
-
-  aent = &cg_entities[ *(int *)a ];
-  bent = &cg_entities[ *(int *)b ];
-  adist = Distance( cg.refdef.vieworg, aent->lerpOrigin );
-  bdist = Distance( cg.refdef.vieworg, bent->lerpOrigin );
-  if( adist > bdist )
-    return -1;
-  else if( adist < bdist )
-    return 1;
-  else
-    return 0;
+  int             i, j, num;
+  float           dist;
+  centity_t       *cent;
+  snapshotIndex_t *index = cg.snapIndex;
+  buildableTeam_t team = BG_FindTeamForWeapon( cg.predictedPlayerState.weapon );
+
+  if( team <= BIT_NONE || team >= BIT_NUM_TEAMS )
+    return;
+
+  for( i = 0; i < index->numBuildables[ team ]; i++ )
+    index->buildables[ team ][ i ]->buildableStatus.seenFrame = cg.clientFrame;
+
+  for( i = j = 0; i < numStatus; i++ )
+  {
+    cent = &cg_entities[ statusList[ i ] ];
+
+    if( cent->buildableStatus.seenFrame == cg.clientFrame )
+      statusList[ j++ ] = statusList[ i ];
+    else
+      cent->buildableStatus.listed = qfalse;
+  }
+  numStatus = j;
+
+  for( i = 0; i < index->numBuildables[ team ]; i++ )
+  {
+    cent = index->buildables[ team ][ i ];
+
+    if( !cent->buildableStatus.listed )
+    {
+      cent->buildableStatus.listed = qtrue;
+      cent->buildableStatus.traceTime = 0;
+      statusList[ numStatus++ ] = cent->currentState.number;
+    }
+  }
+
+  for( i = 0; i < numStatus; i++ )
+    statusDist[ i ] = Distance( cg.refdef.vieworg, cg_entities[ statusList[ i ] ].lerpOrigin );
+
+  // insertion sort, nearly free when little has moved since last frame
+  for( i = 1; i < numStatus; i++ )
+  {
+    num = statusList[ i ];
+    dist = statusDist[ i ];
+
+    for( j = i; j > 0 && statusDist[ j - 1 ] < dist; j-- )
+    {
+      statusList[ j ] = statusList[ j - 1 ];
+      statusDist[ j ] = statusDist[ j - 1 ];
+    }
+
+    statusList[ j ] = num;
+    statusDist[ j ] = dist;
+  }
+}
+
+/*
+==================
+CG_TraceBuildableStatus
+
+Spend this frame's visibility traces on the buildables in range, those
+without a usable result first and then the rest in turn
+==================
+*/
+static void CG_TraceBuildableStatus( void )
+{
+  int       i, j, traces = 0;
+  centity_t *cent;
+
+  for( i = 0; i < numStatus && traces < STATUS_TRACES; i++ )
+  {
+    cent = &cg_entities[ statusList[ i ] ];
+
+    if( statusDist[ i ] <= STATUS_MAX_VIEW_DIST && CG_BuildableStatusStale( cent ) )
+    {
+      CG_BuildableStatusTrace( cent );
+      traces++;
+    }
+  }
+
+  if( nextStatusTrace >= numStatus )
+    nextStatusTrace = 0;
+
+  for( i = 0; i < numStatus && traces < STATUS_TRACES; i++ )
+  {
+    j = ( nextStatusTrace + i ) % numStatus;
+    cent = &cg_entities[ statusList[ j ] ];
+
+    if( statusDist[ j ] <= STATUS_MAX_VIEW_DIST &&
+        cent->buildableStatus.traceTime != cg.time )
+    {
+      CG_BuildableStatusTrace( cent );
+      traces++;
+    }
+  }
+
+  if( numStatus )
+    nextStatusTrace = ( nextStatusTrace + i ) % numStatus;
 }
 
 /*
@@ -1171,9 +1319,6 @@ void CG_DrawBuildableStatus( void )
 {
   int             i;
   centity_t       *cent;
-  entityState_t   *es;
-  int             buildableList[ MAX_ENTITIES_IN_SNAPSHOT ];
-  int             buildables = 0;
 
   switch( cg.predictedPlayerState.weapon )
   {
@@ -1181,19 +1326,19 @@ void CG_DrawBuildableStatus( void )
     case WP_ABUILD2:
     case WP_HBUILD:
     case WP_HBUILD2:
-      for( i = 0; i < cg.snap->numEntities; i++ )
+      CG_UpdateBuildableStatusList( );
+      CG_TraceBuildableStatus( );
+
+      for( i = 0; i < numStatus; i++ )
       {
-        cent  = &cg_entities[ cg.snap->entities[ i ].number ];
-        es    = &cent->currentState;
+        cent = &cg_entities[ statusList[ i ] ];
 
-        if( es->eType == ET_BUILDABLE &&
-            BG_FindTeamForBuildable( es->modelindex ) ==
-            BG_FindTeamForWeapon( cg.predictedPlayerState.weapon ) )
-          buildableList[ buildables++ ] = cg.snap->entities[ i ].number;
+        // an old result is still better than none while it waits its turn
+        if( statusDist[ i ] <= STATUS_MAX_VIEW_DIST &&
+            cent->buildableStatus.traceTime &&
+            cent->buildableStatus.traceTime <= cg.time )
+          CG_BuildableStatusDisplay( cent, statusDist[ i ] );
       }
-      qsort( buildableList, buildables, sizeof( int ), CG_SortDistance );
-      for( i = 0; i < buildables; i++ )
-          CG_BuildableStatusDisplay( &cg_entities[ buildableList[ i ] ] );
       break;
 
     default:
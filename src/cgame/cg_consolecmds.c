@@ -239,6 +239,9 @@ qboolean CG_ConsoleCommand( void )
 
   cmd = CG_Argv( 0 );
 
+  // whatever this is, it may set cvars
+  CG_RequestCvarUpdate( );
+
   //TA: ugly hacky special case
   if( !Q_stricmp( cmd, "ui_menu" ) )
   {
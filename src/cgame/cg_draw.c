@@ -38,102 +38,242 @@ int   sortedTeamPlayers[ TEAM_MAXOVERLAY ];
 int   numSortedTeamPlayers;
 
 //TA UI
-int CG_Text_Width( const char *text, float scale, int limit )
+/*
+===============================================================================
+
+TEXT LAYOUT
+
+The same strings are drawn at the same scale frame after frame, so the
+glyphs, colour changes and size of each are worked out once and kept
+
+===============================================================================
+*/
+
+#define MAX_TEXT_LAYOUTS        256
+#define MAX_TEXT_LAYOUT_CHARS   128
+
+typedef struct textGlyph_s
 {
-  int         count,len;
-  float       out;
+  float       x;              // from the start of the string
   glyphInfo_t *glyph;
+} textGlyph_t;
+
+typedef struct textRun_s
+{
+  int         firstGlyph;
+  int         numGlyphs;
+  int         colorIndex;     // -1 for the colour the text is drawn in
+} textRun_t;
+
+typedef struct textLayout_s
+{
+  qboolean    valid;
+  fontInfo_t  *font;
+  float       scale;
+  float       adjust;
+  int         limit;
+  char        text[ MAX_TEXT_LAYOUT_CHARS ];
+
   float       useScale;
-// FIXME: see ui_main.c, same problem
-//  const unsigned char *s = text;
-  const char  *s = text;
-  fontInfo_t  *font = &cgDC.Assets.textFont;
+  float       width;
+  float       height;
+
+  textGlyph_t *glyphs;
+  int         numGlyphs;
+  textRun_t   *runs;
+  int         numRuns;
+  int         maxGlyphs;      // room in glyphs and runs
+} textLayout_t;
+
+static textLayout_t textLayouts[ MAX_TEXT_LAYOUTS ];
+static textGlyph_t  textLayoutGlyphs[ MAX_TEXT_LAYOUTS ][ MAX_TEXT_LAYOUT_CHARS ];
+static textRun_t    textLayoutRuns[ MAX_TEXT_LAYOUTS ][ MAX_TEXT_LAYOUT_CHARS ];
+
+// strings too long to keep are laid out here each time
+static textLayout_t scratchTextLayout;
+static textGlyph_t  scratchTextGlyphs[ MAX_STRING_CHARS ];
+static textRun_t    scratchTextRuns[ MAX_STRING_CHARS ];
+
+/*
+==============
+CG_ClearTextLayouts
+
+Forget every layout, the fonts they were made with may have changed
+==============
+*/
+void CG_ClearTextLayouts( void )
+{
+  int i;
+
+  for( i = 0; i < MAX_TEXT_LAYOUTS; i++ )
+    textLayouts[ i ].valid = qfalse;
+}
+
+/*
+==============
+CG_RegisterFont
 
+trap_R_RegisterFont for the display context
+==============
+*/
+void CG_RegisterFont( const char *fontName, int pointSize, fontInfo_t *font )
+{
+  trap_R_RegisterFont( fontName, pointSize, font );
+  CG_ClearTextLayouts( );
+}
+
+/*
+==============
+CG_TextFont
+==============
+*/
+static fontInfo_t *CG_TextFont( float scale )
+{
   if( scale <= cg_smallFont.value )
-    font = &cgDC.Assets.smallFont;
+    return &cgDC.Assets.smallFont;
   else if( scale > cg_bigFont.value )
-    font = &cgDC.Assets.bigFont;
+    return &cgDC.Assets.bigFont;
 
-  useScale = scale * font->glyphScale;
-  out = 0;
+  return &cgDC.Assets.textFont;
+}
 
-  if( text )
+/*
+==============
+CG_LayoutText
+
+Work out where each glyph of text goes and where its colour changes
+==============
+*/
+static void CG_LayoutText( textLayout_t *layout, const char *text, float adjust, int limit )
+{
+  const char  *s = text;
+  glyphInfo_t *glyph;
+  textRun_t   *run = NULL;
+  int         len, count = 0, colorIndex = -1;
+  float       x = 0.0f, out = 0.0f, max = 0.0f;
+
+  layout->numGlyphs = 0;
+  layout->numRuns = 0;
+
+  len = strlen( text );
+  if( limit > 0 && len > limit )
+    len = limit;
+
+  while( *s && count < len && layout->numGlyphs < layout->maxGlyphs )
   {
-    len = strlen( text );
-    if( limit > 0 && len > limit )
-      len = limit;
+    if( Q_IsColorString( s ) )
+    {
+      colorIndex = ColorIndex( *( s + 1 ) );
+      s += 2;
+      continue;
+    }
 
-    count = 0;
-    while( s && *s && count < len )
+    //TTimo: FIXME: getting nasty warnings without the cast,
+    //hopefully this doesn't break the VM build
+    glyph = &layout->font->glyphs[ (int)*s ];
+
+    if( !run || run->colorIndex != colorIndex )
     {
-      if( Q_IsColorString( s ) )
-      {
-        s += 2;
-        continue;
-      }
-      else
-      {
-        glyph = &font->glyphs[ (int)*s ];
-        //TTimo: FIXME: getting nasty warnings without the cast,
-        //hopefully this doesn't break the VM build
-        out += glyph->xSkip;
-        s++;
-        count++;
-      }
+      run = &layout->runs[ layout->numRuns++ ];
+      run->firstGlyph = layout->numGlyphs;
+      run->numGlyphs = 0;
+      run->colorIndex = colorIndex;
     }
+
+    layout->glyphs[ layout->numGlyphs ].x = x;
+    layout->glyphs[ layout->numGlyphs ].glyph = glyph;
+    layout->numGlyphs++;
+    run->numGlyphs++;
+
+    if( max < glyph->height )
+      max = glyph->height;
+
+    out += glyph->xSkip;
+    x += ( glyph->xSkip * layout->useScale ) + adjust;
+    s++;
+    count++;
   }
 
-  return out * useScale;
+  layout->width = out * layout->useScale;
+  layout->height = max * layout->useScale;
 }
 
-int CG_Text_Height( const char *text, float scale, int limit )
+/*
+==============
+CG_GetTextLayout
+
+Find or make the layout of text
+==============
+*/
+static textLayout_t *CG_GetTextLayout( const char *text, float scale, float adjust, int limit )
 {
-  int         len, count;
-  float       max;
-  glyphInfo_t *glyph;
-  float       useScale;
-// TTimo: FIXME
-//  const unsigned char *s = text;
-  const char  *s = text;
-  fontInfo_t  *font = &cgDC.Assets.textFont;
+  textLayout_t  *layout;
+  fontInfo_t    *font = CG_TextFont( scale );
+  unsigned int  hash = 0x811c9dc5u;
+  const char    *s;
+  int           len, i;
 
-  if( scale <= cg_smallFont.value )
-    font = &cgDC.Assets.smallFont;
-  else if( scale > cg_bigFont.value )
-    font = &cgDC.Assets.bigFont;
+  for( s = text; *s; s++ )
+  {
+    hash ^= (byte)*s;
+    hash *= 0x01000193u;
+  }
 
-  useScale = scale * font->glyphScale;
-  max = 0;
+  len = s - text;
 
-  if( text )
+  if( len >= MAX_TEXT_LAYOUT_CHARS )
   {
-    len = strlen( text );
-    if( limit > 0 && len > limit )
-      len = limit;
+    layout = &scratchTextLayout;
+    layout->glyphs = scratchTextGlyphs;
+    layout->runs = scratchTextRuns;
+    layout->maxGlyphs = MAX_STRING_CHARS;
+  }
+  else
+  {
+    hash ^= (unsigned int)( scale * 1000.0f ) + (unsigned int)limit * 31u;
+    hash *= 0x01000193u;
+    hash ^= (unsigned int)( adjust * 1000.0f );
+    hash *= 0x01000193u;
 
-    count = 0;
-    while( s && *s && count < len )
-    {
-      if( Q_IsColorString( s ) )
-      {
-        s += 2;
-        continue;
-      }
-      else
-      {
-        glyph = &font->glyphs[ (int)*s ];
-        //TTimo: FIXME: getting nasty warnings without the cast,
-        //hopefully this doesn't break the VM build
-        if( max < glyph->height )
-          max = glyph->height;
+    i = ( hash ^ ( hash >> 16 ) ) % MAX_TEXT_LAYOUTS;
+    layout = &textLayouts[ i ];
 
-        s++;
-        count++;
-      }
-    }
+    if( layout->valid && layout->font == font && layout->scale == scale &&
+        layout->adjust == adjust && layout->limit == limit &&
+        !strcmp( layout->text, text ) )
+      return layout;
+
+    layout->valid = qtrue;
+    layout->scale = scale;
+    layout->adjust = adjust;
+    layout->limit = limit;
+    Q_strncpyz( layout->text, text, sizeof( layout->text ) );
+    layout->glyphs = textLayoutGlyphs[ i ];
+    layout->runs = textLayoutRuns[ i ];
+    layout->maxGlyphs = MAX_TEXT_LAYOUT_CHARS;
   }
 
-  return max * useScale;
+  layout->font = font;
+  layout->useScale = scale * font->glyphScale;
+  CG_LayoutText( layout, text, adjust, limit );
+
+  return layout;
+}
+
+int CG_Text_Width( const char *text, float scale, int limit )
+{
+  if( !text )
+    return 0;
+
+  return CG_GetTextLayout( text, scale, 0.0f, limit )->width;
+}
+
+int CG_Text_Height( const char *text, float scale, int limit )
+{
+  if( !text )
+    return 0;
+
+  return CG_GetTextLayout( text, scale, 0.0f, limit )->height;
 }
 
 void CG_Text_PaintChar( float x, float y, float width, float height, float scale,
@@ -146,147 +286,103 @@ void CG_Text_PaintChar( float x, float y, float width, float height, float scale
   trap_R_DrawStretchPic( x, y, w, h, s, t, s2, t2, hShader );
 }
 
+/*
+==============
+CG_Text_PaintGlyphs
+
+Draw some glyphs of a layout, grown by grow on each side and offset
+==============
+*/
+static void CG_Text_PaintGlyphs( textLayout_t *layout, int first, int num,
+                                 float x, float y, float grow )
+{
+  textGlyph_t *tg;
+  glyphInfo_t *glyph;
+  int         i;
+
+  for( i = 0, tg = &layout->glyphs[ first ]; i < num; i++, tg++ )
+  {
+    glyph = tg->glyph;
+
+    CG_Text_PaintChar( x + tg->x - grow, y - layout->useScale * glyph->top - grow,
+                       glyph->imageWidth + grow * 2.0f,
+                       glyph->imageHeight + grow * 2.0f,
+                       layout->useScale,
+                       glyph->s,
+                       glyph->t,
+                       glyph->s2,
+                       glyph->t2,
+                       glyph->glyph );
+  }
+}
+
 void CG_Text_Paint( float x, float y, float scale, vec4_t color, const char *text,
                     float adjust, int limit, int style )
 {
-  int         len, count;
-  vec4_t      newColor;
-  glyphInfo_t *glyph;
-  float       useScale;
-  fontInfo_t  *font = &cgDC.Assets.textFont;
+  textLayout_t  *layout;
+  textRun_t     *run;
+  vec4_t        newColor;
+  int           i;
 
-  if( scale <= cg_smallFont.value )
-    font = &cgDC.Assets.smallFont;
-  else if( scale > cg_bigFont.value )
-    font = &cgDC.Assets.bigFont;
+  if( !text )
+    return;
 
-  useScale = scale * font->glyphScale;
-  if( text )
+  layout = CG_GetTextLayout( text, scale, adjust, limit );
+
+  // the shadow is the same colour all along, so it goes down in one go
+  if( style == ITEM_TEXTSTYLE_SHADOWED ||
+      style == ITEM_TEXTSTYLE_SHADOWEDMORE )
   {
-// TTimo: FIXME
-//    const unsigned char *s = text;
-    const char *s = text;
+    int ofs = style == ITEM_TEXTSTYLE_SHADOWED ? 1 : 2;
 
-    trap_R_SetColor( color );
-    memcpy( &newColor[ 0 ], &color[ 0 ], sizeof( vec4_t ) );
-    len = strlen( text );
+    VectorCopy( colorBlack, newColor );
+    newColor[ 3 ] = color[ 3 ];
+    trap_R_SetColor( newColor );
+    CG_Text_PaintGlyphs( layout, 0, layout->numGlyphs, x + ofs, y + ofs, 0.0f );
+  }
 
-    if( limit > 0 && len > limit )
-      len = limit;
+  for( i = 0, run = layout->runs; i < layout->numRuns; i++, run++ )
+  {
+    if( run->colorIndex < 0 )
+      Vector4Copy( color, newColor );
+    else
+    {
+      VectorCopy( g_color_table[ run->colorIndex ], newColor );
+      newColor[ 3 ] = color[ 3 ];
+    }
 
-    count = 0;
-    while( s && *s && count < len )
+    if( style == ITEM_TEXTSTYLE_NEON )
     {
-      glyph = &font->glyphs[ (int)*s ];
-      //TTimo: FIXME: getting nasty warnings without the cast,
-      //hopefully this doesn't break the VM build
+      vec4_t glow, inner;
 
-      if( Q_IsColorString( s ) )
-      {
-        memcpy( newColor, g_color_table[ ColorIndex( *( s + 1 ) ) ], sizeof( newColor ) );
-        newColor[ 3 ] = color[ 3 ];
-        trap_R_SetColor( newColor );
-        s += 2;
-        continue;
-      }
-      else
-      {
-        float yadj = useScale * glyph->top;
-        if( style == ITEM_TEXTSTYLE_SHADOWED ||
-            style == ITEM_TEXTSTYLE_SHADOWEDMORE )
-        {
-          int ofs = style == ITEM_TEXTSTYLE_SHADOWED ? 1 : 2;
-          colorBlack[ 3 ] = newColor[ 3 ];
-          trap_R_SetColor( colorBlack );
-          CG_Text_PaintChar( x + ofs, y - yadj + ofs,
-                             glyph->imageWidth,
-                             glyph->imageHeight,
-                             useScale,
-                             glyph->s,
-                             glyph->t,
-                             glyph->s2,
-                             glyph->t2,
-                             glyph->glyph );
-
-          colorBlack[ 3 ] = 1.0;
-          trap_R_SetColor( newColor );
-        }
-        else if( style == ITEM_TEXTSTYLE_NEON )
-        {
-          vec4_t glow, outer, inner, white;
-
-          glow[ 0 ] = newColor[ 0 ] * 0.5;
-          glow[ 1 ] = newColor[ 1 ] * 0.5;
-          glow[ 2 ] = newColor[ 2 ] * 0.5;
-          glow[ 3 ] = newColor[ 3 ] * 0.2;
-
-          outer[ 0 ] = newColor[ 0 ];
-          outer[ 1 ] = newColor[ 1 ];
-          outer[ 2 ] = newColor[ 2 ];
-          outer[ 3 ] = newColor[ 3 ];
-
-          inner[ 0 ] = newColor[ 0 ] * 1.5 > 1.0f ? 1.0f : newColor[ 0 ] * 1.5;
-          inner[ 1 ] = newColor[ 1 ] * 1.5 > 1.0f ? 1.0f : newColor[ 1 ] * 1.5;
-          inner[ 2 ] = newColor[ 2 ] * 1.5 > 1.0f ? 1.0f : newColor[ 2 ] * 1.5;
-          inner[ 3 ] = newColor[ 3 ];
-
-          white[ 0 ] = white[ 1 ] = white[ 2 ] = white[ 3 ] = 1.0f;
-
-          trap_R_SetColor( glow );
-          CG_Text_PaintChar(  x - 3, y - yadj - 3,
-                              glyph->imageWidth + 6,
-                              glyph->imageHeight + 6,
-                              useScale,
-                              glyph->s,
-                              glyph->t,
-                              glyph->s2,
-                              glyph->t2,
-                              glyph->glyph );
-
-          trap_R_SetColor( outer );
-          CG_Text_PaintChar(  x - 1, y - yadj - 1,
-                              glyph->imageWidth + 2,
-                              glyph->imageHeight + 2,
-                              useScale,
-                              glyph->s,
-                              glyph->t,
-                              glyph->s2,
-                              glyph->t2,
-                              glyph->glyph );
-
-          trap_R_SetColor( inner );
-          CG_Text_PaintChar(  x - 0.5, y - yadj - 0.5,
-                              glyph->imageWidth + 1,
-                              glyph->imageHeight + 1,
-                              useScale,
-                              glyph->s,
-                              glyph->t,
-                              glyph->s2,
-                              glyph->t2,
-                              glyph->glyph );
-
-          trap_R_SetColor( white );
-        }
+      glow[ 0 ] = newColor[ 0 ] * 0.5;
+      glow[ 1 ] = newColor[ 1 ] * 0.5;
+      glow[ 2 ] = newColor[ 2 ] * 0.5;
+      glow[ 3 ] = newColor[ 3 ] * 0.2;
 
+      inner[ 0 ] = newColor[ 0 ] * 1.5 > 1.0f ? 1.0f : newColor[ 0 ] * 1.5;
+      inner[ 1 ] = newColor[ 1 ] * 1.5 > 1.0f ? 1.0f : newColor[ 1 ] * 1.5;
+      inner[ 2 ] = newColor[ 2 ] * 1.5 > 1.0f ? 1.0f : newColor[ 2 ] * 1.5;
+      inner[ 3 ] = newColor[ 3 ];
 
-        CG_Text_PaintChar( x, y - yadj,
-                           glyph->imageWidth,
-                           glyph->imageHeight,
-                           useScale,
-                           glyph->s,
-                           glyph->t,
-                           glyph->s2,
-                           glyph->t2,
-                           glyph->glyph );
+      trap_R_SetColor( glow );
+      CG_Text_PaintGlyphs( layout, run->firstGlyph, run->numGlyphs, x, y, 3.0f );
 
-        x += ( glyph->xSkip * useScale ) + adjust;
-        s++;
-        count++;
-      }
+      trap_R_SetColor( newColor );
+      CG_Text_PaintGlyphs( layout, run->firstGlyph, run->numGlyphs, x, y, 1.0f );
+
+      trap_R_SetColor( inner );
+      CG_Text_PaintGlyphs( layout, run->firstGlyph, run->numGlyphs, x, y, 0.5f );
+
+      trap_R_SetColor( colorWhite );
     }
+    else
+      trap_R_SetColor( newColor );
 
-    trap_R_SetColor( NULL );
+    CG_Text_PaintGlyphs( layout, run->firstGlyph, run->numGlyphs, x, y, 0.0f );
   }
+
+  trap_R_SetColor( NULL );
 }
 
 /*
@@ -1230,6 +1230,9 @@ void CG_AddPacketEntities( void )
     CG_AddCEntity( cent );
   }
 
+  // everything has been lerped to where it is this frame
+  CG_InvalidateSolidGrid( );
+
   //make an attempt at drawing bounding boxes of selected entity types
   if( cg_drawBBOX.integer )
   {
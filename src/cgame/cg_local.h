@@ -318,6 +318,7 @@ typedef struct baseParticle_s
   qboolean        overdrawProtection;
   qboolean        realLight;
   qboolean        cullOnStartSolid;
+  qboolean        unsorted;       //blends the same in any order, skip the depth sort
 } baseParticle_t;
 
 
@@ -374,6 +375,8 @@ typedef struct particleEjector_s
 
   int                   nextEjectionTime;
 
+  int                   liveParticles;  //spawned and not yet destroyed
+
   qboolean              valid;
 } particleEjector_t;
 
@@ -505,6 +508,7 @@ typedef struct trailSystem_s
   attachment_t        backAttachment;
 
   int                 destroyTime;
+  int                 numBeams;     //beams still valid
   qboolean            valid;
 } trailSystem_t;
 
@@ -523,9 +527,7 @@ typedef struct trailBeamNode_s
   vec2_t                  jitters[ MAX_TRAIL_BEAM_JITTERS ];
 
   struct trailBeamNode_s  *prev;
-  struct trailBeamNode_s  *next;
-
-  qboolean                used;
+  struct trailBeamNode_s  *next;    //next free node when not in a beam
 } trailBeamNode_t;
 
 typedef struct trailBeam_s
@@ -534,7 +536,12 @@ typedef struct trailBeam_s
   trailSystem_t     *parent;
 
   trailBeamNode_t   nodePool[ MAX_TRAIL_BEAM_NODES ];
-  trailBeamNode_t   *nodes;
+  int               numPoolNodes;   //nodePool entries handed out so far
+  trailBeamNode_t   *freeNodes;     //handed out and returned
+
+  trailBeamNode_t   *nodes;         //front
+  trailBeamNode_t   *lastNode;      //back
+  int               numNodes;
 
   int               lastEvalTime;
 
@@ -593,6 +600,10 @@ typedef struct buildableStatus_s
 {
   int       lastTime;      // Last time status was visible
   qboolean  visible;       // Status is visble?
+  int       traceTime;     // Last time visibility was traced
+  qboolean  traceVisible;  // Result of that trace
+  int       seenFrame;     // Last client frame in the status list
+  qboolean  listed;        // In the persistent status list?
 } buildableStatus_t;
 
 //=================================================
@@ -670,12 +681,37 @@ typedef struct centity_s
   qboolean              zoomed;
 } centity_t;
 
+// typed lists of the entities in a snapshot, built once when it arrives so
+// that nothing else has to walk the snapshot and classify each entity
+typedef struct snapshotIndex_s
+{
+  centity_t   *players[ PTE_NUM_TEAMS ][ MAX_CLIENTS ];
+  int         numPlayers[ PTE_NUM_TEAMS ];
+
+  // grouped by type, each type's run starting at firstBuildable
+  centity_t   *buildables[ BIT_NUM_TEAMS ][ MAX_ENTITIES_IN_SNAPSHOT ];
+  int         numBuildables[ BIT_NUM_TEAMS ];
+  int         firstBuildable[ BA_NUM_BUILDABLES ];
+  int         numBuildablesOfType[ BA_NUM_BUILDABLES ];
+
+  centity_t   *missiles[ MAX_ENTITIES_IN_SNAPSHOT ];
+  int         numMissiles;
+
+  centity_t   *solids[ MAX_ENTITIES_IN_SNAPSHOT ];
+  int         numSolids;
+
+  centity_t   *triggers[ MAX_ENTITIES_IN_SNAPSHOT ];
+  int         numTriggers;
+} snapshotIndex_t;
+
 
 //======================================================================
 
 typedef struct markPoly_s
 {
   struct markPoly_s *prevMark, *nextMark;
+  struct markPoly_s *prevCellMark, *nextCellMark;
+  struct markCell_s *cell;
   int               time;
   qhandle_t         markShader;
   qboolean          alphaFade;    // fade alpha instead of rgb
@@ -744,6 +780,9 @@ typedef struct
   char        headModelName[ MAX_QPATH ];
   char        headSkinName[ MAX_QPATH ];
 
+  struct clientModel_s  *model;           // shared model cache entry
+  qboolean    deferred;                   // drawn with a class model until model loads
+
   qboolean    newAnims;                   // true if using the new mission pack animations
   qboolean    fixedlegs;                  // true if legs yaw is always the same as torso yaw
   qboolean    fixedtorso;                 // true if torso never changes yaw
@@ -926,6 +965,8 @@ typedef struct
 
   snapshot_t    *snap;                              // cg.snap->serverTime <= cg.time
   snapshot_t    *nextSnap;                          // cg.nextSnap->serverTime > cg.time, or NULL
+  snapshotIndex_t *snapIndex;                       // entities of cg.snap by type
+  snapshotIndex_t *nextSnapIndex;                   // entities of cg.nextSnap by type, or NULL
   snapshot_t    activeSnapshots[ 2 ];
 
   float         frameInterpolation;                 // (float)( cg.time - cg.frame->serverTime ) /
@@ -1516,6 +1557,7 @@ extern  vmCvar_t    cg_consoleLatency;
 extern  vmCvar_t    cg_lightFlare;
 extern  vmCvar_t    cg_debugParticles;
 extern  vmCvar_t    cg_debugTrails;
+extern  vmCvar_t    cg_debugTraceStats;
 extern  vmCvar_t    cg_debugPVS;
 extern  vmCvar_t    cg_disableWarningDialogs;
 extern  vmCvar_t    cg_disableScannerPlane;
@@ -1556,6 +1598,7 @@ void        CG_StartMusic( void );
 int         CG_PlayerCount( void );
 
 void        CG_UpdateCvars( void );
+void        CG_RequestCvarUpdate( void );
 
 int         CG_CrosshairPlayer( void );
 int         CG_LastAttacker( void );
@@ -1625,6 +1668,8 @@ void        CG_OwnerDraw( float x, float y, float w, float h, float text_x, floa
 void        CG_Text_Paint( float x, float y, float scale, vec4_t color, const char *text, float adjust, int limit, int style );
 int         CG_Text_Width( const char *text, float scale, int limit );
 int         CG_Text_Height( const char *text, float scale, int limit );
+void        CG_ClearTextLayouts( void );
+void        CG_RegisterFont( const char *fontName, int pointSize, fontInfo_t *font );
 float       CG_GetValue(int ownerDraw);
 void        CG_RunMenuScript(char **args);
 void        CG_SetPrintString( int type, const char *p );
@@ -1645,7 +1690,9 @@ void        CG_Corpse( centity_t *cent );
 void        CG_ResetPlayerEntity( centity_t *cent );
 void        CG_AddRefEntityWithPowerups( refEntity_t *ent, int powerups, int team );
 void        CG_NewClientInfo( int clientNum );
+void        CG_InitClientModels( void );
 void        CG_PrecacheClientInfo( pClass_t class, char *model, char *skin );
+void        CG_LoadDeferredClientModels( void );
 sfxHandle_t CG_CustomSound( int clientNum, const char *soundName );
 void        CG_PlayerDisconnect( vec3_t org );
 void        CG_Bleed( vec3_t origin, vec3_t normal, int entityNum );
@@ -1680,6 +1727,7 @@ void        CG_ModelDoor( centity_t *cent );
 #define MAGIC_TRACE_HACK -2
 
 void        CG_BuildSolidList( void );
+void        CG_InvalidateSolidGrid( void );
 int         CG_PointContents( const vec3_t point, int passEntityNum );
 void        CG_Trace( trace_t *result, const vec3_t start, const vec3_t mins, const vec3_t maxs,
                 const vec3_t end, int skipNumber, int mask );
@@ -30,7 +30,6 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 // display context for new ui stuff
 displayContextDef_t cgDC;
 
-int forceModelModificationCount = -1;
 
 void CG_Init( int serverMessageNum, int serverCommandSequence, int clientNum );
 void CG_Shutdown( void );
@@ -222,6 +221,7 @@ vmCvar_t  cg_consoleLatency;
 vmCvar_t  cg_lightFlare;
 vmCvar_t  cg_debugParticles;
 vmCvar_t  cg_debugTrails;
+vmCvar_t  cg_debugTraceStats;
 vmCvar_t  cg_debugPVS;
 vmCvar_t  cg_disableWarningDialogs;
 vmCvar_t  cg_disableScannerPlane;
@@ -256,8 +256,13 @@ typedef struct
   char      *cvarName;
   char      *defaultString;
   int       cvarFlags;
+  qboolean  everyFrame;         // refreshed every frame rather than on the slow cycle
+  void      (*changed)( void ); // called when the value changes
+  int       modificationCount;
 } cvarTable_t;
 
+static void CG_ForceModelChange( void );
+
 static cvarTable_t cvarTable[ ] =
 {
   { &cg_ignore, "cg_ignore", "0", 0 },  // used for debugging
@@ -265,7 +270,7 @@ static cvarTable_t cvarTable[ ] =
   { &cg_drawGun, "cg_drawGun", "1", CVAR_ARCHIVE },
   { &cg_zoomFov, "cg_zoomfov", "22.5", CVAR_ARCHIVE },
   { &cg_fov, "cg_fov", "90", CVAR_ARCHIVE },
-  { &cg_viewsize, "cg_viewsize", "100", CVAR_ARCHIVE },
+  { &cg_viewsize, "cg_viewsize", "100", CVAR_ARCHIVE, qtrue },
   { &cg_stereoSeparation, "cg_stereoSeparation", "0.4", CVAR_ARCHIVE  },
   { &cg_shadows, "cg_shadows", "1", CVAR_ARCHIVE  },
   { &cg_gibs, "cg_gibs", "1", CVAR_ARCHIVE  },
@@ -307,19 +312,19 @@ static cvarTable_t cvarTable[ ] =
   { &cg_debugAnim, "cg_debuganim", "0", CVAR_CHEAT },
   { &cg_debugPosition, "cg_debugposition", "0", CVAR_CHEAT },
   { &cg_debugEvents, "cg_debugevents", "0", CVAR_CHEAT },
-  { &cg_errorDecay, "cg_errordecay", "100", 0 },
-  { &cg_nopredict, "cg_nopredict", "0", 0 },
-  { &cg_debugMove, "cg_debugMove", "0", 0 },
+  { &cg_errorDecay, "cg_errordecay", "100", 0, qtrue },
+  { &cg_nopredict, "cg_nopredict", "0", 0, qtrue },
+  { &cg_debugMove, "cg_debugMove", "0", 0, qtrue },
   { &cg_noPlayerAnims, "cg_noplayeranims", "0", CVAR_CHEAT },
-  { &cg_showmiss, "cg_showmiss", "0", 0 },
+  { &cg_showmiss, "cg_showmiss", "0", 0, qtrue },
   { &cg_footsteps, "cg_footsteps", "1", CVAR_CHEAT },
   { &cg_tracerChance, "cg_tracerchance", "0.4", CVAR_CHEAT },
   { &cg_tracerWidth, "cg_tracerwidth", "1", CVAR_CHEAT },
   { &cg_tracerLength, "cg_tracerlength", "100", CVAR_CHEAT },
   { &cg_thirdPersonRange, "cg_thirdPersonRange", "40", CVAR_CHEAT },
   { &cg_thirdPersonAngle, "cg_thirdPersonAngle", "0", CVAR_CHEAT },
-  { &cg_thirdPerson, "cg_thirdPerson", "0", CVAR_CHEAT },
-  { &cg_forceModel, "cg_forceModel", "0", CVAR_ARCHIVE  },
+  { &cg_thirdPerson, "cg_thirdPerson", "0", CVAR_CHEAT, qtrue },
+  { &cg_forceModel, "cg_forceModel", "0", CVAR_ARCHIVE, qfalse, CG_ForceModelChange },
   { &cg_predictItems, "cg_predictItems", "1", CVAR_ARCHIVE },
   { &cg_deferPlayers, "cg_deferPlayers", "1", CVAR_ARCHIVE },
   { &cg_drawTeamOverlay, "cg_drawTeamOverlay", "0", CVAR_ARCHIVE },
@@ -343,6 +348,7 @@ static cvarTable_t cvarTable[ ] =
   { &cg_lightFlare, "cg_lightFlare", "3", CVAR_ARCHIVE },
   { &cg_debugParticles, "cg_debugParticles", "0", CVAR_CHEAT },
   { &cg_debugTrails, "cg_debugTrails", "0", CVAR_CHEAT },
+  { &cg_debugTraceStats, "cg_debugTraceStats", "0", CVAR_CHEAT },
   { &cg_debugPVS, "cg_debugPVS", "0", CVAR_CHEAT },
   { &cg_disableWarningDialogs, "cg_disableWarningDialogs", "0", CVAR_ARCHIVE },
   { &cg_disableScannerPlane, "cg_disableScannerPlane", "0", CVAR_ARCHIVE },
@@ -373,20 +379,20 @@ static cvarTable_t cvarTable[ ] =
   // but we also reference them here
 
   { &cg_buildScript, "com_buildScript", "0", 0 }, // force loading of all possible data amd error on failures
-  { &cg_paused, "cl_paused", "0", CVAR_ROM },
+  { &cg_paused, "cl_paused", "0", CVAR_ROM, qtrue },
   { &cg_blood, "com_blood", "1", CVAR_ARCHIVE },
-  { &cg_synchronousClients, "g_synchronousClients", "0", 0 }, // communicated by systeminfo
+  { &cg_synchronousClients, "g_synchronousClients", "0", 0, qtrue }, // communicated by systeminfo
   { &cg_cameraOrbit, "cg_cameraOrbit", "0", CVAR_CHEAT},
   { &cg_cameraOrbitDelay, "cg_cameraOrbitDelay", "50", CVAR_ARCHIVE},
-  { &cg_timescaleFadeEnd, "cg_timescaleFadeEnd", "1", 0},
-  { &cg_timescaleFadeSpeed, "cg_timescaleFadeSpeed", "0", 0},
-  { &cg_timescale, "timescale", "1", 0},
+  { &cg_timescaleFadeEnd, "cg_timescaleFadeEnd", "1", 0, qtrue },
+  { &cg_timescaleFadeSpeed, "cg_timescaleFadeSpeed", "0", 0, qtrue },
+  { &cg_timescale, "timescale", "1", 0, qtrue },
   { &cg_scorePlum, "cg_scorePlums", "1", CVAR_USERINFO | CVAR_ARCHIVE},
   { &cg_smoothClients, "cg_smoothClients", "0", CVAR_USERINFO | CVAR_ARCHIVE},
   { &cg_cameraMode, "com_cameraMode", "0", CVAR_CHEAT},
 
-  { &pmove_fixed, "pmove_fixed", "0", 0},
-  { &pmove_msec, "pmove_msec", "8", 0},
+  { &pmove_fixed, "pmove_fixed", "0", 0, qtrue },
+  { &pmove_msec, "pmove_msec", "8", 0, qtrue },
   { &cg_noTaunt, "cg_noTaunt", "0", CVAR_ARCHIVE},
   { &cg_noProjectileTrail, "cg_noProjectileTrail", "0", CVAR_ARCHIVE},
   { &cg_smallFont, "ui_smallFont", "0.2", CVAR_ARCHIVE},
@@ -400,6 +406,15 @@ static cvarTable_t cvarTable[ ] =
 
 static int   cvarTableSize = sizeof( cvarTable ) / sizeof( cvarTable[0] );
 
+// cvars that aren't refreshed every frame are spread over this many msec
+#define SLOW_CVAR_CYCLE 250
+
+static cvarTable_t  *frameCvars[ sizeof( cvarTable ) / sizeof( cvarTable[0] ) ];
+static cvarTable_t  *slowCvars[ sizeof( cvarTable ) / sizeof( cvarTable[0] ) ];
+static int          numFrameCvars, numSlowCvars;
+static int          nextSlowCvar;
+static qboolean     updateAllCvars;
+
 /*
 =================
 CG_RegisterCvars
@@ -411,10 +426,19 @@ void CG_RegisterCvars( void )
   cvarTable_t *cv;
   char        var[ MAX_TOKEN_CHARS ];
 
+  numFrameCvars = numSlowCvars = 0;
+  nextSlowCvar = 0;
+
   for( i = 0, cv = cvarTable; i < cvarTableSize; i++, cv++ )
   {
     trap_Cvar_Register( cv->vmCvar, cv->cvarName,
       cv->defaultString, cv->cvarFlags );
+    cv->modificationCount = cv->vmCvar->modificationCount;
+
+    if( cv->everyFrame )
+      frameCvars[ numFrameCvars++ ] = cv;
+    else
+      slowCvars[ numSlowCvars++ ] = cv;
   }
 
   //repress standard Q3 console
@@ -423,7 +447,6 @@ void CG_RegisterCvars( void )
   // see if we are also running the server on this machine
   trap_Cvar_VariableStringBuffer( "sv_running", var, sizeof( var ) );
   cgs.localServer = atoi( var );
-  forceModelModificationCount = cg_forceModel.modificationCount;
 
   trap_Cvar_Register( NULL, "model", DEFAULT_MODEL, CVAR_USERINFO | CVAR_ARCHIVE );
   trap_Cvar_Register( NULL, "headmodel", DEFAULT_MODEL, CVAR_USERINFO | CVAR_ARCHIVE );
@@ -677,28 +700,69 @@ static void CG_SetPVars( void )
   }
 }
 
+/*
+=================
+CG_RequestCvarUpdate
+
+Refresh every cvar on the next CG_UpdateCvars, for when a console command
+may have set some
+=================
+*/
+void CG_RequestCvarUpdate( void )
+{
+  updateAllCvars = qtrue;
+}
+
+/*
+=================
+CG_UpdateCvar
+=================
+*/
+static void CG_UpdateCvar( cvarTable_t *cv )
+{
+  trap_Cvar_Update( cv->vmCvar );
+
+  if( cv->modificationCount == cv->vmCvar->modificationCount )
+    return;
+
+  cv->modificationCount = cv->vmCvar->modificationCount;
+
+  if( cv->changed )
+    cv->changed( );
+}
+
 /*
 =================
 CG_UpdateCvars
+
+Prediction and view cvars are refreshed every frame and the rest a few at
+a time, so each is seen within SLOW_CVAR_CYCLE msec
 =================
 */
 void CG_UpdateCvars( void )
 {
-  int         i;
-  cvarTable_t *cv;
+  int         i, count;
 
   CG_SetPVars();
 
-  for( i = 0, cv = cvarTable; i < cvarTableSize; i++, cv++ )
-    trap_Cvar_Update( cv->vmCvar );
+  for( i = 0; i < numFrameCvars; i++ )
+    CG_UpdateCvar( frameCvars[ i ] );
 
-  // check for modications here
+  if( updateAllCvars )
+  {
+    updateAllCvars = qfalse;
+    count = numSlowCvars;
+  }
+  else
+  {
+    count = ( numSlowCvars * cg.frametime + SLOW_CVAR_CYCLE - 1 ) / SLOW_CVAR_CYCLE;
+    count = MIN( MAX( count, 1 ), numSlowCvars );
+  }
 
-  // if force model changed
-  if( forceModelModificationCount != cg_forceModel.modificationCount )
+  for( i = 0; i < count; i++ )
   {
-    forceModelModificationCount = cg_forceModel.modificationCount;
-    CG_ForceModelChange( );
+    CG_UpdateCvar( slowCvars[ nextSlowCvar ] );
+    nextSlowCvar = ( nextSlowCvar + 1 ) % numSlowCvars;
   }
 }
 
@@ -1172,6 +1236,8 @@ static void CG_RegisterClients( void )
 
   cg.charModelFraction = 0.0f;
 
+  CG_InitClientModels( );
+
   //precache all the models/sounds/etc
   for( i = PCL_NONE + 1; i < PCL_NUM_CLASSES;  i++ )
   {
@@ -1887,7 +1953,7 @@ void CG_LoadHudMenu( void )
   cgDC.clearScene           = &trap_R_ClearScene;
   cgDC.addRefEntityToScene  = &trap_R_AddRefEntityToScene;
   cgDC.renderScene          = &trap_R_RenderScene;
-  cgDC.registerFont         = &trap_R_RegisterFont;
+  cgDC.registerFont         = &CG_RegisterFont;
   cgDC.ownerDrawItem        = &CG_OwnerDraw;
   cgDC.getValue             = &CG_GetValue;
   cgDC.ownerDrawVisible     = &CG_OwnerDrawVisible;
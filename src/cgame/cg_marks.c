@@ -40,6 +40,66 @@ markPoly_t  *cg_freeMarkPolys;      // single linked list
 markPoly_t  cg_markPolys[ MAX_MARK_POLYS ];
 static int  markTotal;
 
+// persistent marks are also kept in coarse cells of the world, so whole
+// cells out of view can be skipped without looking at their marks
+#define MARK_CELL_SIZE        256.0f
+#define MARK_CELL_HASH_SIZE   64
+
+typedef struct markCell_s
+{
+  int                 coords[ 3 ];
+  vec3_t              mins, maxs;     // of every mark added since it was empty
+
+  markPoly_t          *marks;         // linked through nextCellMark
+  int                 numMarks;
+
+  int                 activeIndex;    // in activeMarkCells
+  struct markCell_s   *hashNext;      // or next free cell
+} markCell_t;
+
+static markCell_t   markCells[ MAX_MARK_POLYS ];
+static markCell_t   *markCellHash[ MARK_CELL_HASH_SIZE ];
+static markCell_t   *freeMarkCells;
+static markCell_t   *activeMarkCells[ MAX_MARK_POLYS ];
+static int          numActiveMarkCells;
+
+// the polys of visible marks, one run per shader and vertex count
+#define MAX_MARK_BATCHES      32
+
+typedef struct markBatch_s
+{
+  qhandle_t   markShader;
+  int         numVerts;
+  int         numPolys;
+  int         firstVert;
+} markBatch_t;
+
+static markBatch_t  markBatches[ MAX_MARK_BATCHES ];
+static polyVert_t   markBatchVerts[ MAX_MARK_POLYS * MAX_VERTS_ON_POLY ];
+static markPoly_t   *visibleMarks[ MAX_MARK_POLYS ];
+static int          visibleMarkBatches[ MAX_MARK_POLYS ];
+
+// temporary marks such as shadows and creep are made again every frame,
+// usually in exactly the same place, so their fragments are remembered
+#define MARK_CACHE_SIZE           32
+#define MAX_CACHED_MARK_FRAGMENTS 8
+#define MAX_CACHED_MARK_POINTS    64
+
+typedef struct markFragmentCache_s
+{
+  qboolean        valid;
+  vec3_t          origin;
+  vec3_t          dir;
+  float           orientation;
+  float           radius;
+
+  int             numFragments;
+  markFragment_t  fragments[ MAX_CACHED_MARK_FRAGMENTS ];
+  vec3_t          points[ MAX_CACHED_MARK_POINTS ];
+} markFragmentCache_t;
+
+static markFragmentCache_t  markFragmentCache[ MARK_CACHE_SIZE ];
+
 /*
 ===================
 CG_InitMarkPolys
@@ -59,6 +119,140 @@ void CG_InitMarkPolys( void )
 
   for( i = 0; i < MAX_MARK_POLYS - 1; i++ )
     cg_markPolys[ i ].nextMark = &cg_markPolys[ i + 1 ];
+
+  memset( markCells, 0, sizeof( markCells ) );
+  memset( markCellHash, 0, sizeof( markCellHash ) );
+  freeMarkCells = markCells;
+  numActiveMarkCells = 0;
+
+  for( i = 0; i < MAX_MARK_POLYS - 1; i++ )
+    markCells[ i ].hashNext = &markCells[ i + 1 ];
+
+  memset( markFragmentCache, 0, sizeof( markFragmentCache ) );
+}
+
+/*
+==================
+CG_MarkCellHash
+==================
+*/
+static int CG_MarkCellHash( const int coords[ 3 ] )
+{
+  unsigned int hash;
+
+  hash = ( (unsigned int)coords[ 0 ] * 73856093u ) ^
+         ( (unsigned int)coords[ 1 ] * 19349663u ) ^
+         ( (unsigned int)coords[ 2 ] * 83492791u );
+
+  return hash & ( MARK_CELL_HASH_SIZE - 1 );
+}
+
+/*
+==================
+CG_LinkMarkToCell
+
+Put a mark in the cell its centre falls in
+==================
+*/
+static void CG_LinkMarkToCell( markPoly_t *mark )
+{
+  markCell_t  *cell;
+  vec3_t      centre;
+  int         coords[ 3 ];
+  int         i, hash;
+
+  VectorClear( centre );
+
+  for( i = 0; i < mark->poly.numVerts; i++ )
+    VectorAdd( centre, mark->verts[ i ].xyz, centre );
+
+  for( i = 0; i < 3; i++ )
+    coords[ i ] = (int)floor( centre[ i ] / mark->poly.numVerts / MARK_CELL_SIZE );
+
+  hash = CG_MarkCellHash( coords );
+
+  for( cell = markCellHash[ hash ]; cell; cell = cell->hashNext )
+  {
+    if( cell->coords[ 0 ] == coords[ 0 ] &&
+        cell->coords[ 1 ] == coords[ 1 ] &&
+        cell->coords[ 2 ] == coords[ 2 ] )
+      break;
+  }
+
+  if( !cell )
+  {
+    // there is never more than one cell per mark
+    cell = freeMarkCells;
+    freeMarkCells = cell->hashNext;
+
+    VectorCopy( coords, cell->coords );
+    ClearBounds( cell->mins, cell->maxs );
+    cell->marks = NULL;
+    cell->numMarks = 0;
+
+    cell->hashNext = markCellHash[ hash ];
+    markCellHash[ hash ] = cell;
+
+    cell->activeIndex = numActiveMarkCells;
+    activeMarkCells[ numActiveMarkCells++ ] = cell;
+  }
+
+  mark->cell = cell;
+  mark->prevCellMark = NULL;
+  mark->nextCellMark = cell->marks;
+
+  if( cell->marks )
+    cell->marks->prevCellMark = mark;
+
+  cell->marks = mark;
+  cell->numMarks++;
+
+  for( i = 0; i < mark->poly.numVerts; i++ )
+    AddPointToBounds( mark->verts[ i ].xyz, cell->mins, cell->maxs );
+}
+
+/*
+==================
+CG_UnlinkMarkFromCell
+
+Take a mark out of its cell, freeing the cell if it was the last one
+==================
+*/
+static void CG_UnlinkMarkFromCell( markPoly_t *mark )
+{
+  markCell_t  *cell = mark->cell;
+  markCell_t  **prev;
+
+  if( !cell )
+    return;
+
+  if( mark->prevCellMark )
+    mark->prevCellMark->nextCellMark = mark->nextCellMark;
+  else
+    cell->marks = mark->nextCellMark;
+
+  if( mark->nextCellMark )
+    mark->nextCellMark->prevCellMark = mark->prevCellMark;
+
+  mark->cell = NULL;
+
+  if( --cell->numMarks > 0 )
+    return;
+
+  for( prev = &markCellHash[ CG_MarkCellHash( cell->coords ) ]; *prev; prev = &(*prev)->hashNext )
+  {
+    if( *prev == cell )
+    {
+      *prev = cell->hashNext;
+      break;
+    }
+  }
+
+  activeMarkCells[ cell->activeIndex ] = activeMarkCells[ --numActiveMarkCells ];
+  activeMarkCells[ cell->activeIndex ]->activeIndex = cell->activeIndex;
+
+  cell->hashNext = freeMarkCells;
+  freeMarkCells = cell;
 }
 
 
@@ -72,6 +266,8 @@ void CG_FreeMarkPoly( markPoly_t *le )
   if( !le->prevMark )
     CG_Error( "CG_FreeLocalEntity: not active" );
 
+  CG_UnlinkMarkFromCell( le );
+
   // remove from the doubly linked active list
   le->prevMark->nextMark = le->nextMark;
   le->nextMark->prevMark = le->prevMark;
@@ -118,6 +314,74 @@ markPoly_t *CG_AllocMark( void )
 
 
 
+/*
+=================
+CG_MarkFragmentCacheSlot
+
+Where the fragments of a mark with these parameters are cached, if
+anywhere
+=================
+*/
+static markFragmentCache_t *CG_MarkFragmentCacheSlot( const vec3_t origin, const vec3_t dir,
+                                                      float orientation, float radius )
+{
+  unsigned int  hash = 0x811c9dc5u;
+  int           key[ 8 ];
+  int           i;
+
+  memcpy( key, origin, sizeof( vec3_t ) );
+  memcpy( key + 3, dir, sizeof( vec3_t ) );
+  memcpy( key + 6, &orientation, sizeof( float ) );
+  memcpy( key + 7, &radius, sizeof( float ) );
+
+  for( i = 0; i < 8; i++ )
+  {
+    hash ^= (unsigned int)key[ i ];
+    hash *= 0x01000193u;
+  }
+
+  return &markFragmentCache[ ( hash ^ ( hash >> 16 ) ) % MARK_CACHE_SIZE ];
+}
+
+/*
+=================
+CG_CacheMarkFragments
+
+Remember the fragments of a mark, if there aren't too many of them
+=================
+*/
+static void CG_CacheMarkFragments( markFragmentCache_t *cache, const vec3_t origin,
+                                   const vec3_t dir, float orientation, float radius,
+                                   int numFragments, markFragment_t *fragments,
+                                   vec3_t *points )
+{
+  int i, numPoints = 0;
+
+  cache->valid = qfalse;
+
+  if( numFragments > MAX_CACHED_MARK_FRAGMENTS )
+    return;
+
+  for( i = 0; i < numFragments; i++ )
+  {
+    if( numPoints + fragments[ i ].numPoints > MAX_CACHED_MARK_POINTS )
+      return;
+
+    cache->fragments[ i ].firstPoint = numPoints;
+    cache->fragments[ i ].numPoints = fragments[ i ].numPoints;
+    memcpy( cache->points[ numPoints ], points[ fragments[ i ].firstPoint ],
+            fragments[ i ].numPoints * sizeof( vec3_t ) );
+    numPoints += fragments[ i ].numPoints;
+  }
+
+  VectorCopy( origin, cache->origin );
+  VectorCopy( dir, cache->dir );
+  cache->orientation = orientation;
+  cache->radius = radius;
+  cache->numFragments = numFragments;
+  cache->valid = qtrue;
+}
+
 /*
 =================
 CG_ImpactMark
@@ -145,6 +409,7 @@ void CG_ImpactMark( qhandle_t markShader, const vec3_t origin, const vec3_t dir,
   markFragment_t  markFragments[ MAX_MARK_FRAGMENTS ], *mf;
   vec3_t          markPoints[ MAX_MARK_POINTS ];
   vec3_t          projection;
+  markFragmentCache_t *cache = NULL;
 
   if( !cg_addMarks.integer )
     return;
@@ -174,10 +439,28 @@ void CG_ImpactMark( qhandle_t markShader, const vec3_t origin, const vec3_t dir,
   }
 
   // get the fragments
-  VectorScale( dir, -20, projection );
-  numFragments = trap_CM_MarkFragments( 4, (void *)originalPoints,
-          projection, MAX_MARK_POINTS, markPoints[ 0 ],
-          MAX_MARK_FRAGMENTS, markFragments );
+  if( temporary )
+    cache = CG_MarkFragmentCacheSlot( origin, dir, orientation, radius );
+
+  if( cache && cache->valid && VectorCompare( cache->origin, origin ) &&
+      VectorCompare( cache->dir, dir ) && cache->orientation == orientation &&
+      cache->radius == radius )
+  {
+    numFragments = cache->numFragments;
+    memcpy( markFragments, cache->fragments, numFragments * sizeof( markFragment_t ) );
+    memcpy( markPoints, cache->points, sizeof( cache->points ) );
+  }
+  else
+  {
+    VectorScale( dir, -20, projection );
+    numFragments = trap_CM_MarkFragments( 4, (void *)originalPoints,
+            projection, MAX_MARK_POINTS, markPoints[ 0 ],
+            MAX_MARK_FRAGMENTS, markFragments );
+
+    if( cache )
+      CG_CacheMarkFragments( cache, origin, dir, orientation, radius,
+                             numFragments, markFragments, markPoints );
+  }
 
   colors[ 0 ] = red * 255;
   colors[ 1 ] = green * 255;
@@ -225,11 +508,72 @@ void CG_ImpactMark( qhandle_t markShader, const vec3_t origin, const vec3_t dir,
     mark->color[ 2 ] = blue;
     mark->color[ 3 ] = alpha;
     memcpy( mark->verts, verts, mf->numPoints * sizeof( verts[ 0 ] ) );
+    CG_LinkMarkToCell( mark );
     markTotal++;
   }
 }
 
 
+/*
+===============
+CG_MarkCellVisible
+
+Test a cell's bounds against the view frustum
+===============
+*/
+static qboolean CG_MarkCellVisible( markCell_t *cell, cplane_t *frustum )
+{
+  int i;
+
+  for( i = 0; i < 4; i++ )
+  {
+    if( BoxOnPlaneSide( cell->mins, cell->maxs, &frustum[ i ] ) == 2 )
+      return qfalse;
+  }
+
+  return qtrue;
+}
+
+/*
+===============
+CG_SetupMarkFrustum
+
+The four side planes of the view, as the renderer builds them
+===============
+*/
+static void CG_SetupMarkFrustum( cplane_t *frustum )
+{
+  float xs, xc, ys, yc, angle;
+  int   i;
+
+  angle = DEG2RAD( cg.refdef.fov_x * 0.5f );
+  xs = sin( angle );
+  xc = cos( angle );
+
+  VectorScale( cg.refdef.viewaxis[ 0 ], xs, frustum[ 0 ].normal );
+  VectorMA( frustum[ 0 ].normal, xc, cg.refdef.viewaxis[ 1 ], frustum[ 0 ].normal );
+
+  VectorScale( cg.refdef.viewaxis[ 0 ], xs, frustum[ 1 ].normal );
+  VectorMA( frustum[ 1 ].normal, -xc, cg.refdef.viewaxis[ 1 ], frustum[ 1 ].normal );
+
+  angle = DEG2RAD( cg.refdef.fov_y * 0.5f );
+  ys = sin( angle );
+  yc = cos( angle );
+
+  VectorScale( cg.refdef.viewaxis[ 0 ], ys, frustum[ 2 ].normal );
+  VectorMA( frustum[ 2 ].normal, yc, cg.refdef.viewaxis[ 2 ], frustum[ 2 ].normal );
+
+  VectorScale( cg.refdef.viewaxis[ 0 ], ys, frustum[ 3 ].normal );
+  VectorMA( frustum[ 3 ].normal, -yc, cg.refdef.viewaxis[ 2 ], frustum[ 3 ].normal );
+
+  for( i = 0; i < 4; i++ )
+  {
+    frustum[ i ].type = PLANE_NON_AXIAL;
+    frustum[ i ].dist = DotProduct( cg.refdef.vieworg, frustum[ i ].normal );
+    SetPlaneSignbits( &frustum[ i ] );
+  }
+}
+
 /*
 ===============
 CG_AddMarks
@@ -240,50 +584,109 @@ CG_AddMarks
 
 void CG_AddMarks( void )
 {
-  int         j;
-  markPoly_t  *mp, *next;
+  int         i, j, k;
+  markPoly_t  *mp;
+  markCell_t  *cell;
+  markBatch_t *batch;
+  cplane_t    frustum[ 4 ];
   int         t;
   int         fade;
+  int         numVisible = 0, numBatches = 0, numVerts = 0;
 
   if( !cg_addMarks.integer )
     return;
 
-  mp = cg_activeMarkPolys.nextMark;
-  for ( ; mp != &cg_activeMarkPolys; mp = next )
+  // marks are kept newest first, so the old ones are all at the end
+  while( ( mp = cg_activeMarkPolys.prevMark ) != &cg_activeMarkPolys &&
+         cg.time > mp->time + MARK_TOTAL_TIME )
+    CG_FreeMarkPoly( mp );
+
+  // fade all marks out with time
+  for( mp = cg_activeMarkPolys.prevMark; mp != &cg_activeMarkPolys; mp = mp->prevMark )
   {
-    // grab next now, so if the local entity is freed we
-    // still have it
-    next = mp->nextMark;
+    t = mp->time + MARK_TOTAL_TIME - cg.time;
+    if( t >= MARK_FADE_TIME )
+      break;
 
-    // see if it is time to completely remove it
-    if( cg.time > mp->time + MARK_TOTAL_TIME )
+    fade = 255 * t / MARK_FADE_TIME;
+    if( mp->alphaFade )
     {
-      CG_FreeMarkPoly( mp );
-      continue;
+      for( j = 0; j < mp->poly.numVerts; j++ )
+        mp->verts[ j ].modulate[ 3 ] = fade;
+    }
+    else
+    {
+      for( j = 0; j < mp->poly.numVerts; j++ )
+      {
+        mp->verts[ j ].modulate[ 0 ] = mp->color[ 0 ] * fade;
+        mp->verts[ j ].modulate[ 1 ] = mp->color[ 1 ] * fade;
+        mp->verts[ j ].modulate[ 2 ] = mp->color[ 2 ] * fade;
+      }
     }
+  }
 
-    // fade all marks out with time
-    t = mp->time + MARK_TOTAL_TIME - cg.time;
-    if( t < MARK_FADE_TIME )
+  // find the marks in view and which batch each goes in
+  CG_SetupMarkFrustum( frustum );
+
+  for( i = 0; i < numActiveMarkCells; i++ )
+  {
+    cell = activeMarkCells[ i ];
+
+    if( !CG_MarkCellVisible( cell, frustum ) )
+      continue;
+
+    for( mp = cell->marks; mp; mp = mp->nextCellMark )
     {
-      fade = 255 * t / MARK_FADE_TIME;
-      if( mp->alphaFade )
+      for( k = 0; k < numBatches; k++ )
       {
-        for( j = 0; j < mp->poly.numVerts; j++ )
-          mp->verts[ j ].modulate[ 3 ] = fade;
+        if( markBatches[ k ].markShader == mp->markShader &&
+            markBatches[ k ].numVerts == mp->poly.numVerts )
+          break;
       }
-      else
+
+      if( k == numBatches )
       {
-        for( j = 0; j < mp->poly.numVerts; j++ )
+        if( numBatches == MAX_MARK_BATCHES )
         {
-          mp->verts[ j ].modulate[ 0 ] = mp->color[ 0 ] * fade;
-          mp->verts[ j ].modulate[ 1 ] = mp->color[ 1 ] * fade;
-          mp->verts[ j ].modulate[ 2 ] = mp->color[ 2 ] * fade;
+          trap_R_AddPolyToScene( mp->markShader, mp->poly.numVerts, mp->verts );
+          continue;
         }
+
+        batch = &markBatches[ numBatches++ ];
+        batch->markShader = mp->markShader;
+        batch->numVerts = mp->poly.numVerts;
+        batch->numPolys = 0;
       }
+
+      markBatches[ k ].numPolys++;
+      visibleMarks[ numVisible ] = mp;
+      visibleMarkBatches[ numVisible++ ] = k;
     }
+  }
 
-    trap_R_AddPolyToScene( mp->markShader, mp->poly.numVerts, mp->verts );
+  // lay the batches out one after another
+  for( k = 0; k < numBatches; k++ )
+  {
+    batch = &markBatches[ k ];
+    batch->firstVert = numVerts;
+    numVerts += batch->numPolys * batch->numVerts;
+    batch->numPolys = 0;
   }
-}
 
+  for( i = 0; i < numVisible; i++ )
+  {
+    mp = visibleMarks[ i ];
+    batch = &markBatches[ visibleMarkBatches[ i ] ];
+
+    memcpy( &markBatchVerts[ batch->firstVert + batch->numPolys * batch->numVerts ],
+            mp->verts, batch->numVerts * sizeof( polyVert_t ) );
+    batch->numPolys++;
+  }
+
+  for( k = 0; k < numBatches; k++ )
+  {
+    batch = &markBatches[ k ];
+    trap_R_AddPolysToScene( batch->markShader, batch->numVerts,
+                            &markBatchVerts[ batch->firstVert ], batch->numPolys );
+  }
+}
@@ -35,9 +35,103 @@ static int                    numBaseParticles = 0;
 static particleSystem_t     particleSystems[ MAX_PARTICLE_SYSTEMS ];
 static particleEjector_t    particleEjectors[ MAX_PARTICLE_EJECTORS ];
 static particle_t           particles[ MAX_PARTICLES ];
-static particle_t           *sortedParticles[ MAX_PARTICLES ];
 static particle_t           *radixBuffer[ MAX_PARTICLES ];
 
+//particles in use, in the order they were drawn last frame with any new
+//ones on the end, compacted and sorted once a frame
+static particle_t           *activeParticles[ MAX_PARTICLES ];
+static int                  numActiveParticles = 0;
+
+//sort statistics for cg_debugParticles
+static int                  numDepthSortedParticles = 0;
+static int                  numDepthSortShifts = 0;
+static qboolean             depthSortFellBack = qfalse;
+static int                  depthSortMsec = 0;
+
+//slots that can be handed out straight away
+static int                  freeParticles[ MAX_PARTICLES ];
+static int                  numFreeParticles = 0;
+
+//destroyed particles, oldest first, waiting for other systems to notice
+static int                  deadParticles[ MAX_PARTICLES ];
+static int                  firstDeadParticle = 0;
+static int                  numDeadParticles = 0;
+
+static int                  numDroppedParticles = 0;
+
+//scratch space for CG_EvaluateParticlePhysics
+#define PARTICLE_CLUSTER_SIZE   128.0f
+
+static particle_t           *physicsParticles[ MAX_PARTICLES ];
+static vec3_t               physicsOrigins[ MAX_PARTICLES ];
+static float                physicsRadii[ MAX_PARTICLES ];
+static int                  classOffsets[ MAX_BASEPARTICLES + 1 ];
+
+static int                  numParticleTraces = 0;
+static int                  numParticleClusterTraces = 0;
+
+//testPS
+#define MAX_TEST_PARTICLE_SYSTEMS 32
+
+static particleSystem_t     *testPS[ MAX_TEST_PARTICLE_SYSTEMS ];
+static qhandle_t            testPSHandle;
+
+static qboolean             testPSStress = qfalse;
+static int                  testPSFrames;
+static int                  testPSParticles;
+static int                  testPSMsec;
+static int                  testPSTraces;
+static int                  testPSClusterTraces;
+
+/*
+===============
+CG_InitParticlePool
+
+Empty the particle pool
+===============
+*/
+static void CG_InitParticlePool( void )
+{
+  int i;
+
+  memset( particles, 0, sizeof( particles ) );
+
+  //lowest slots first
+  for( i = 0; i < MAX_PARTICLES; i++ )
+    freeParticles[ i ] = MAX_PARTICLES - i - 1;
+
+  numFreeParticles = MAX_PARTICLES;
+  numActiveParticles = 0;
+  firstDeadParticle = numDeadParticles = 0;
+  numDroppedParticles = 0;
+}
+
+/*
+===============
+CG_ReclaimParticles
+
+Return destroyed particles to the free list once other
+systems have had a couple of frames to realise they're gone
+===============
+*/
+static void CG_ReclaimParticles( void )
+{
+  int i;
+
+  while( numDeadParticles > 0 )
+  {
+    i = deadParticles[ firstDeadParticle ];
+
+    //FIXME: the + 1 may be unnecessary
+    if( cg.clientFrame <= particles[ i ].frameWhenInvalidated + 1 )
+      break;
+
+    freeParticles[ numFreeParticles++ ] = i;
+    firstDeadParticle = ( firstDeadParticle + 1 ) % MAX_PARTICLES;
+    numDeadParticles--;
+  }
+}
+
 /*
 ===============
 CG_LerpValues
@@ -116,10 +210,26 @@ static void CG_DestroyParticle( particle_t *p, vec3_t impactNormal )
   }
 
   p->valid = qfalse;
+  p->parent->liveParticles--;
 
   //this gives other systems a couple of
   //frames to realise the particle is gone
   p->frameWhenInvalidated = cg.clientFrame;
+  deadParticles[ ( firstDeadParticle + numDeadParticles ) % MAX_PARTICLES ] = p - particles;
+  numDeadParticles++;
+}
+
+/*
+===============
+CG_UnspawnParticle
+
+Give back a particle that failed to spawn
+===============
+*/
+static void CG_UnspawnParticle( particle_t *p )
+{
+  p->valid = qfalse;
+  freeParticles[ numFreeParticles++ ] = p - particles;
 }
 
 /*
@@ -131,178 +241,186 @@ Introduce a new particle into the world
 */
 static particle_t *CG_SpawnNewParticle( baseParticle_t *bp, particleEjector_t *parent )
 {
-  int                     i, j;
-  particle_t              *p = NULL;
+  int                     j;
+  particle_t              *p;
   particleEjector_t       *pe = parent;
   particleSystem_t        *ps = parent->parent;
   vec3_t                  attachmentPoint, attachmentVelocity;
   vec3_t                  transform[ 3 ];
 
-  for( i = 0; i < MAX_PARTICLES; i++ )
+  if( !numFreeParticles )
   {
-    p = &particles[ i ];
-
-    //FIXME: the + 1 may be unnecessary
-    if( !p->valid && cg.clientFrame > p->frameWhenInvalidated + 1 )
-    {
-      memset( p, 0, sizeof( particle_t ) );
+    numDroppedParticles++;
+    return NULL;
+  }
 
-      //found a free slot
-      p->class = bp;
-      p->parent = pe;
+  //found a free slot
+  p = &particles[ freeParticles[ --numFreeParticles ] ];
+  memset( p, 0, sizeof( particle_t ) );
 
-      p->birthTime = cg.time;
-      p->lifeTime = (int)CG_RandomiseValue( (float)bp->lifeTime, bp->lifeTimeRandFrac );
+  p->class = bp;
+  p->parent = pe;
 
-      p->radius.delay = (int)CG_RandomiseValue( (float)bp->radius.delay, bp->radius.delayRandFrac );
-      p->radius.initial = CG_RandomiseValue( bp->radius.initial, bp->radius.initialRandFrac );
-      p->radius.final = CG_RandomiseValue( bp->radius.final, bp->radius.finalRandFrac );
+  p->birthTime = cg.time;
+  p->lifeTime = (int)CG_RandomiseValue( (float)bp->lifeTime, bp->lifeTimeRandFrac );
 
-      p->alpha.delay = (int)CG_RandomiseValue( (float)bp->alpha.delay, bp->alpha.delayRandFrac );
-      p->alpha.initial = CG_RandomiseValue( bp->alpha.initial, bp->alpha.initialRandFrac );
-      p->alpha.final = CG_RandomiseValue( bp->alpha.final, bp->alpha.finalRandFrac );
+  p->radius.delay = (int)CG_RandomiseValue( (float)bp->radius.delay, bp->radius.delayRandFrac );
+  p->radius.initial = CG_RandomiseValue( bp->radius.initial, bp->radius.initialRandFrac );
+  p->radius.final = CG_RandomiseValue( bp->radius.final, bp->radius.finalRandFrac );
 
-      p->rotation.delay = (int)CG_RandomiseValue( (float)bp->rotation.delay, bp->rotation.delayRandFrac );
-      p->rotation.initial = CG_RandomiseValue( bp->rotation.initial, bp->rotation.initialRandFrac );
-      p->rotation.final = CG_RandomiseValue( bp->rotation.final, bp->rotation.finalRandFrac );
+  p->alpha.delay = (int)CG_RandomiseValue( (float)bp->alpha.delay, bp->alpha.delayRandFrac );
+  p->alpha.initial = CG_RandomiseValue( bp->alpha.initial, bp->alpha.initialRandFrac );
+  p->alpha.final = CG_RandomiseValue( bp->alpha.final, bp->alpha.finalRandFrac );
 
-      p->dLightRadius.delay =
-        (int)CG_RandomiseValue( (float)bp->dLightRadius.delay, bp->dLightRadius.delayRandFrac );
-      p->dLightRadius.initial =
-        CG_RandomiseValue( bp->dLightRadius.initial, bp->dLightRadius.initialRandFrac );
-      p->dLightRadius.final =
-        CG_RandomiseValue( bp->dLightRadius.final, bp->dLightRadius.finalRandFrac );
+  p->rotation.delay = (int)CG_RandomiseValue( (float)bp->rotation.delay, bp->rotation.delayRandFrac );
+  p->rotation.initial = CG_RandomiseValue( bp->rotation.initial, bp->rotation.initialRandFrac );
+  p->rotation.final = CG_RandomiseValue( bp->rotation.final, bp->rotation.finalRandFrac );
 
-      p->colorDelay = CG_RandomiseValue( bp->colorDelay, bp->colorDelayRandFrac );
+  p->dLightRadius.delay =
+    (int)CG_RandomiseValue( (float)bp->dLightRadius.delay, bp->dLightRadius.delayRandFrac );
+  p->dLightRadius.initial =
+    CG_RandomiseValue( bp->dLightRadius.initial, bp->dLightRadius.initialRandFrac );
+  p->dLightRadius.final =
+    CG_RandomiseValue( bp->dLightRadius.final, bp->dLightRadius.finalRandFrac );
 
-      p->bounceMarkRadius = CG_RandomiseValue( bp->bounceMarkRadius, bp->bounceMarkRadiusRandFrac );
-      p->bounceMarkCount =
-        rint( CG_RandomiseValue( (float)bp->bounceMarkCount, bp->bounceMarkCountRandFrac ) );
-      p->bounceSoundCount =
-        rint( CG_RandomiseValue( (float)bp->bounceSoundCount, bp->bounceSoundCountRandFrac ) );
+  p->colorDelay = CG_RandomiseValue( bp->colorDelay, bp->colorDelayRandFrac );
 
-      if( bp->numModels )
-      {
-        p->model = bp->models[ rand( ) % bp->numModels ];
+  p->bounceMarkRadius = CG_RandomiseValue( bp->bounceMarkRadius, bp->bounceMarkRadiusRandFrac );
+  p->bounceMarkCount =
+    rint( CG_RandomiseValue( (float)bp->bounceMarkCount, bp->bounceMarkCountRandFrac ) );
+  p->bounceSoundCount =
+    rint( CG_RandomiseValue( (float)bp->bounceSoundCount, bp->bounceSoundCountRandFrac ) );
 
-        if( bp->modelAnimation.frameLerp < 0 )
-        {
-          bp->modelAnimation.frameLerp = p->lifeTime / bp->modelAnimation.numFrames;
-          bp->modelAnimation.initialLerp = p->lifeTime / bp->modelAnimation.numFrames;
-        }
-      }
-
-      if( !CG_AttachmentPoint( &ps->attachment, attachmentPoint ) )
-        return NULL;
+  if( bp->numModels )
+  {
+    p->model = bp->models[ rand( ) % bp->numModels ];
 
-      VectorCopy( attachmentPoint, p->origin );
+    if( bp->modelAnimation.frameLerp < 0 )
+    {
+      bp->modelAnimation.frameLerp = p->lifeTime / bp->modelAnimation.numFrames;
+      bp->modelAnimation.initialLerp = p->lifeTime / bp->modelAnimation.numFrames;
+    }
+  }
 
-      if( CG_AttachmentAxis( &ps->attachment, transform ) )
-      {
-        vec3_t  transDisplacement;
+  if( !CG_AttachmentPoint( &ps->attachment, attachmentPoint ) )
+  {
+    CG_UnspawnParticle( p );
+    return NULL;
+  }
 
-        VectorMatrixMultiply( bp->displacement, transform, transDisplacement );
-        VectorAdd( p->origin, transDisplacement, p->origin );
-      }
-      else
-        VectorAdd( p->origin, bp->displacement, p->origin );
+  VectorCopy( attachmentPoint, p->origin );
 
-      for( j = 0; j <= 2; j++ )
-        p->origin[ j ] += ( crandom( ) * bp->randDisplacement );
+  if( CG_AttachmentAxis( &ps->attachment, transform ) )
+  {
+    vec3_t  transDisplacement;
 
-      switch( bp->velMoveType )
-      {
-        case PMT_STATIC:
-          if( bp->velMoveValues.dirType == PMD_POINT )
-            VectorSubtract( bp->velMoveValues.point, p->origin, p->velocity );
-          else if( bp->velMoveValues.dirType == PMD_LINEAR )
-            VectorCopy( bp->velMoveValues.dir, p->velocity );
-          break;
+    VectorMatrixMultiply( bp->displacement, transform, transDisplacement );
+    VectorAdd( p->origin, transDisplacement, p->origin );
+  }
+  else
+    VectorAdd( p->origin, bp->displacement, p->origin );
 
-        case PMT_STATIC_TRANSFORM:
-          if( !CG_AttachmentAxis( &ps->attachment, transform ) )
-            return NULL;
+  for( j = 0; j <= 2; j++ )
+    p->origin[ j ] += ( crandom( ) * bp->randDisplacement );
 
-          if( bp->velMoveValues.dirType == PMD_POINT )
-          {
-            vec3_t transPoint;
+  switch( bp->velMoveType )
+  {
+    case PMT_STATIC:
+      if( bp->velMoveValues.dirType == PMD_POINT )
+        VectorSubtract( bp->velMoveValues.point, p->origin, p->velocity );
+      else if( bp->velMoveValues.dirType == PMD_LINEAR )
+        VectorCopy( bp->velMoveValues.dir, p->velocity );
+      break;
 
-            VectorMatrixMultiply( bp->velMoveValues.point, transform, transPoint );
-            VectorSubtract( transPoint, p->origin, p->velocity );
-          }
-          else if( bp->velMoveValues.dirType == PMD_LINEAR )
-            VectorMatrixMultiply( bp->velMoveValues.dir, transform, p->velocity );
-          break;
+    case PMT_STATIC_TRANSFORM:
+      if( !CG_AttachmentAxis( &ps->attachment, transform ) )
+      {
+        CG_UnspawnParticle( p );
+        return NULL;
+      }
 
-        case PMT_TAG:
-        case PMT_CENT_ANGLES:
-          if( bp->velMoveValues.dirType == PMD_POINT )
-            VectorSubtract( attachmentPoint, p->origin, p->velocity );
-          else if( bp->velMoveValues.dirType == PMD_LINEAR )
-          {
-            if( !CG_AttachmentDir( &ps->attachment, p->velocity ) )
-              return NULL;
-          }
-          break;
+      if( bp->velMoveValues.dirType == PMD_POINT )
+      {
+        vec3_t transPoint;
 
-        case PMT_NORMAL:
-          if( !ps->normalValid )
-          {
-            CG_Printf( S_COLOR_RED "ERROR: a particle with velocityType "
-                "normal has no normal\n" );
-            return NULL;
-          }
+        VectorMatrixMultiply( bp->velMoveValues.point, transform, transPoint );
+        VectorSubtract( transPoint, p->origin, p->velocity );
+      }
+      else if( bp->velMoveValues.dirType == PMD_LINEAR )
+        VectorMatrixMultiply( bp->velMoveValues.dir, transform, p->velocity );
+      break;
 
-          VectorCopy( ps->normal, p->velocity );
+    case PMT_TAG:
+    case PMT_CENT_ANGLES:
+      if( bp->velMoveValues.dirType == PMD_POINT )
+        VectorSubtract( attachmentPoint, p->origin, p->velocity );
+      else if( bp->velMoveValues.dirType == PMD_LINEAR )
+      {
+        if( !CG_AttachmentDir( &ps->attachment, p->velocity ) )
+        {
+          CG_UnspawnParticle( p );
+          return NULL;
+        }
+      }
+      break;
 
-          //normal displacement
-          VectorNormalize( p->velocity );
-          VectorMA( p->origin, bp->normalDisplacement, p->velocity, p->origin );
-          break;
+    case PMT_NORMAL:
+      if( !ps->normalValid )
+      {
+        CG_Printf( S_COLOR_RED "ERROR: a particle with velocityType "
+            "normal has no normal\n" );
+        CG_UnspawnParticle( p );
+        return NULL;
       }
 
+      VectorCopy( ps->normal, p->velocity );
+
+      //normal displacement
       VectorNormalize( p->velocity );
-      CG_SpreadVector( p->velocity, bp->velMoveValues.dirRandAngle );
-      VectorScale( p->velocity,
-                   CG_RandomiseValue( bp->velMoveValues.mag, bp->velMoveValues.magRandFrac ),
-                   p->velocity );
+      VectorMA( p->origin, bp->normalDisplacement, p->velocity, p->origin );
+      break;
+  }
 
-      if( CG_AttachmentVelocity( &ps->attachment, attachmentVelocity ) )
-      {
-        VectorMA( p->velocity,
-            CG_RandomiseValue( bp->velMoveValues.parentVelFrac,
-              bp->velMoveValues.parentVelFracRandFrac ), attachmentVelocity, p->velocity );
-      }
+  VectorNormalize( p->velocity );
+  CG_SpreadVector( p->velocity, bp->velMoveValues.dirRandAngle );
+  VectorScale( p->velocity,
+               CG_RandomiseValue( bp->velMoveValues.mag, bp->velMoveValues.magRandFrac ),
+               p->velocity );
 
-      p->lastEvalTime = cg.time;
+  if( CG_AttachmentVelocity( &ps->attachment, attachmentVelocity ) )
+  {
+    VectorMA( p->velocity,
+        CG_RandomiseValue( bp->velMoveValues.parentVelFrac,
+          bp->velMoveValues.parentVelFracRandFrac ), attachmentVelocity, p->velocity );
+  }
 
-      p->valid = qtrue;
+  p->lastEvalTime = cg.time;
 
-      //this particle has a child particle system attached
-      if( bp->childSystemName[ 0 ] != '\0' )
-      {
-        particleSystem_t  *ps = CG_SpawnNewParticleSystem( bp->childSystemHandle );
+  p->valid = qtrue;
+  pe->liveParticles++;
+  activeParticles[ numActiveParticles++ ] = p;
 
-        if( CG_IsParticleSystemValid( &ps ) )
-        {
-          CG_SetAttachmentParticle( &ps->attachment, p );
-          CG_AttachToParticle( &ps->attachment );
-        }
-      }
+  //this particle has a child particle system attached
+  if( bp->childSystemName[ 0 ] != '\0' )
+  {
+    particleSystem_t  *ps = CG_SpawnNewParticleSystem( bp->childSystemHandle );
 
-      //this particle has a child trail system attached
-      if( bp->childTrailSystemName[ 0 ] != '\0' )
-      {
-        trailSystem_t *ts = CG_SpawnNewTrailSystem( bp->childTrailSystemHandle );
+    if( CG_IsParticleSystemValid( &ps ) )
+    {
+      CG_SetAttachmentParticle( &ps->attachment, p );
+      CG_AttachToParticle( &ps->attachment );
+    }
+  }
 
-        if( CG_IsTrailSystemValid( &ts ) )
-        {
-          CG_SetAttachmentParticle( &ts->frontAttachment, p );
-          CG_AttachToParticle( &ts->frontAttachment );
-        }
-      }
+  //this particle has a child trail system attached
+  if( bp->childTrailSystemName[ 0 ] != '\0' )
+  {
+    trailSystem_t *ts = CG_SpawnNewTrailSystem( bp->childTrailSystemHandle );
 
-      break;
+    if( CG_IsTrailSystemValid( &ts ) )
+    {
+      CG_SetAttachmentParticle( &ts->frontAttachment, p );
+      CG_AttachToParticle( &ts->frontAttachment );
     }
   }
 
@@ -321,12 +439,10 @@ introducing new particles
 static void CG_SpawnNewParticles( void )
 {
   int                   i, j;
-  particle_t            *p;
   particleSystem_t      *ps;
   particleEjector_t     *pe;
   baseParticleEjector_t *bpe;
   float                 lerpFrac;
-  int                   count;
 
   for( i = 0; i < MAX_PARTICLE_EJECTORS; i++ )
   {
@@ -363,22 +479,9 @@ static void CG_SpawnNewParticles( void )
         }
       }
 
-      if( pe->count == 0 || ps->lazyRemove )
-      {
-        count = 0;
-
-        //wait for child particles to die before declaring this pe invalid
-        for( j = 0; j < MAX_PARTICLES; j++ )
-        {
-          p = &particles[ j ];
-
-          if( p->valid && p->parent == pe )
-            count++;
-        }
-
-        if( !count )
-          pe->valid = qfalse;
-      }
+      //wait for child particles to die before declaring this pe invalid
+      if( ( pe->count == 0 || ps->lazyRemove ) && !pe->liveParticles )
+        pe->valid = qfalse;
     }
   }
 }
@@ -1062,6 +1165,12 @@ static qboolean CG_ParseParticle( baseParticle_t *bp, char **text_p )
 
       continue;
     }
+    else if( !Q_stricmp( token, "unsorted" ) )
+    {
+      bp->unsorted = qtrue;
+
+      continue;
+    }
     else if( !Q_stricmp( token, "dynamicLight" ) )
     {
       bp->dynamicLight = qtrue;
@@ -1704,6 +1813,8 @@ void CG_LoadParticleSystems( void )
   numBaseParticleEjectors = 0;
   numBaseParticles = 0;
 
+  CG_InitParticlePool( );
+
   for( i = 0; i < MAX_BASEPARTICLE_SYSTEMS; i++ )
   {
     baseParticleSystem_t  *bps = &baseParticleSystems[ i ];
@@ -1922,29 +2033,32 @@ Destroy inactive particle systems
 */
 static void CG_GarbageCollectParticleSystems( void )
 {
-  int               i, j, count;
+  int               i;
+  int               count[ MAX_PARTICLE_SYSTEMS ];
   particleSystem_t  *ps;
   particleEjector_t *pe;
   int               centNum;
 
+  //count the ejectors of every system in one pass
+  memset( count, 0, sizeof( count ) );
+
+  for( i = 0; i < MAX_PARTICLE_EJECTORS; i++ )
+  {
+    pe = &particleEjectors[ i ];
+
+    if( pe->valid )
+      count[ pe->parent - particleSystems ]++;
+  }
+
   for( i = 0; i < MAX_PARTICLE_SYSTEMS; i++ )
   {
     ps = &particleSystems[ i ];
-    count = 0;
 
     //don't bother checking already invalid systems
     if( !ps->valid )
       continue;
 
-    for( j = 0; j < MAX_PARTICLE_EJECTORS; j++ )
-    {
-      pe = &particleEjectors[ j ];
-
-      if( pe->valid && pe->parent == ps )
-        count++;
-    }
-
-    if( !count )
+    if( !count[ i ] )
       ps->valid = qfalse;
 
     //check systems where the parent cent has left the PVS
@@ -1985,79 +2099,83 @@ static float CG_CalculateTimeFrac( int birth, int life, int delay )
 
 /*
 ===============
-CG_EvaluateParticlePhysics
+CG_ParticleAccelerationBase
 
-Compute the physics on a specific particle
+The part of a particle class's acceleration that comes from its
+system's attachment, the same for every particle in the system
 ===============
 */
-static void CG_EvaluateParticlePhysics( particle_t *p )
+static qboolean CG_ParticleAccelerationBase( baseParticle_t *bp, particleSystem_t *ps, vec3_t base )
 {
-  particleSystem_t  *ps = p->parent->parent;
-  baseParticle_t    *bp = p->class;
-  vec3_t            acceleration, newOrigin;
-  vec3_t            mins, maxs;
-  float             deltaTime, bounce, radius, dot;
-  trace_t           trace;
-  vec3_t            transform[ 3 ];
-
-  if( p->atRest )
-  {
-    VectorClear( p->velocity );
-    return;
-  }
+  vec3_t  transform[ 3 ];
 
   switch( bp->accMoveType )
   {
     case PMT_STATIC:
       if( bp->accMoveValues.dirType == PMD_POINT )
-        VectorSubtract( bp->accMoveValues.point, p->origin, acceleration );
-      else if( bp->accMoveValues.dirType == PMD_LINEAR )
-        VectorCopy( bp->accMoveValues.dir, acceleration );
-
+        VectorCopy( bp->accMoveValues.point, base );
+      else
+        VectorCopy( bp->accMoveValues.dir, base );
       break;
 
     case PMT_STATIC_TRANSFORM:
       if( !CG_AttachmentAxis( &ps->attachment, transform ) )
-        return;
+        return qfalse;
 
       if( bp->accMoveValues.dirType == PMD_POINT )
-      {
-        vec3_t transPoint;
-
-        VectorMatrixMultiply( bp->accMoveValues.point, transform, transPoint );
-        VectorSubtract( transPoint, p->origin, acceleration );
-      }
-      else if( bp->accMoveValues.dirType == PMD_LINEAR )
-        VectorMatrixMultiply( bp->accMoveValues.dir, transform, acceleration );
+        VectorMatrixMultiply( bp->accMoveValues.point, transform, base );
+      else
+        VectorMatrixMultiply( bp->accMoveValues.dir, transform, base );
       break;
 
     case PMT_TAG:
     case PMT_CENT_ANGLES:
       if( bp->accMoveValues.dirType == PMD_POINT )
-      {
-        vec3_t point;
-
-        if( !CG_AttachmentPoint( &ps->attachment, point ) )
-          return;
-
-        VectorSubtract( point, p->origin, acceleration );
-      }
-      else if( bp->accMoveValues.dirType == PMD_LINEAR )
-      {
-        if( !CG_AttachmentDir( &ps->attachment, acceleration ) )
-          return;
-      }
-      break;
+        return CG_AttachmentPoint( &ps->attachment, base );
+      else
+        return CG_AttachmentDir( &ps->attachment, base );
 
     case PMT_NORMAL:
       if( !ps->normalValid )
-        return;
-
-      VectorCopy( ps->normal, acceleration );
+        return qfalse;
 
+      VectorCopy( ps->normal, base );
       break;
   }
 
+  return qtrue;
+}
+
+/*
+===============
+CG_ParticleCollides
+
+A class that never bounces has no use for a trace
+===============
+*/
+static qboolean CG_ParticleCollides( baseParticle_t *bp )
+{
+  return bp->bounceFrac != 0.0f || bp->bounceFracRandFrac != 0.0f;
+}
+
+/*
+===============
+CG_MoveParticle
+
+Integrate a particle's velocity and work out where it is going this frame
+===============
+*/
+static void CG_MoveParticle( particle_t *p, const vec3_t base, vec3_t newOrigin )
+{
+  baseParticle_t    *bp = p->class;
+  vec3_t            acceleration;
+  float             deltaTime;
+
+  if( bp->accMoveType != PMT_NORMAL && bp->accMoveValues.dirType == PMD_POINT )
+    VectorSubtract( base, p->origin, acceleration );
+  else
+    VectorCopy( base, acceleration );
+
 #define MAX_ACC_RADIUS 1000.0f
 
   if( bp->accMoveValues.dirType == PMD_POINT )
@@ -2086,36 +2204,33 @@ static void CG_EvaluateParticlePhysics( particle_t *p )
                  acceleration );
   }
 
-  radius = CG_LerpValues( p->radius.initial,
-                 p->radius.final,
-                 CG_CalculateTimeFrac( p->birthTime,
-                                       p->lifeTime,
-                                       p->radius.delay ) );
-
-  VectorSet( mins, -radius, -radius, -radius );
-  VectorSet( maxs, radius, radius, radius );
-
-  bounce = CG_RandomiseValue( bp->bounceFrac, bp->bounceFracRandFrac );
-
   deltaTime = (float)( cg.time - p->lastEvalTime ) * 0.001;
   VectorMA( p->velocity, deltaTime, acceleration, p->velocity );
   VectorMA( p->origin, deltaTime, p->velocity, newOrigin );
   p->lastEvalTime = cg.time;
+}
 
-  // we're not doing particle physics, but at least cull them in solids
-  if( !cg_bounceParticles.integer )
-  {
-    int contents = trap_CM_PointContents( newOrigin, 0 ); 
+/*
+===============
+CG_CollideParticle
 
-    if( ( contents & CONTENTS_SOLID ) || ( contents & CONTENTS_NODROP ) )
-      CG_DestroyParticle( p, NULL );
-    else 
-      VectorCopy( newOrigin, p->origin );
-    return;
-  }
+Trace a particle from its origin to newOrigin and bounce or cull it
+===============
+*/
+static void CG_CollideParticle( particle_t *p, const vec3_t newOrigin, float radius, int skipNumber )
+{
+  baseParticle_t    *bp = p->class;
+  vec3_t            mins, maxs;
+  float             bounce, dot;
+  trace_t           trace;
 
-  CG_Trace( &trace, p->origin, mins, maxs, newOrigin,
-      CG_AttachmentCentNum( &ps->attachment ), CONTENTS_SOLID );
+  VectorSet( mins, -radius, -radius, -radius );
+  VectorSet( maxs, radius, radius, radius );
+
+  bounce = CG_RandomiseValue( bp->bounceFrac, bp->bounceFracRandFrac );
+
+  CG_Trace( &trace, p->origin, mins, maxs, newOrigin, skipNumber, CONTENTS_SOLID );
+  numParticleTraces++;
 
   //not hit anything or not a collider
   if( trace.fraction == 1.0f || bounce == 0.0f )
@@ -2164,12 +2279,211 @@ static void CG_EvaluateParticlePhysics( particle_t *p )
   VectorCopy( trace.endpos, p->origin );
 }
 
+/*
+===============
+CG_CollideParticleCluster
+
+Collide physicsParticles[ first ] to physicsParticles[ last - 1 ], which
+share a system and lie within a box of side PARTICLE_CLUSTER_SIZE. One
+trace of the whole box usually shows that none of them can hit anything
+===============
+*/
+static void CG_CollideParticleCluster( int first, int last, const vec3_t mins, const vec3_t maxs )
+{
+  particle_t  *p;
+  int         skipNumber, i;
+  trace_t     trace;
+
+  skipNumber = CG_AttachmentCentNum( &physicsParticles[ first ]->parent->parent->attachment );
+
+  if( last - first > 1 )
+  {
+    CG_Trace( &trace, vec3_origin, mins, maxs, vec3_origin, skipNumber, CONTENTS_SOLID );
+    numParticleClusterTraces++;
+
+    if( !trace.startsolid && !trace.allsolid && trace.fraction == 1.0f )
+    {
+      for( i = first; i < last; i++ )
+        VectorCopy( physicsOrigins[ i ], physicsParticles[ i ]->origin );
+
+      return;
+    }
+  }
+
+  for( i = first; i < last; i++ )
+  {
+    p = physicsParticles[ i ];
+    CG_CollideParticle( p, physicsOrigins[ i ], physicsRadii[ i ], skipNumber );
+  }
+}
+
+/*
+===============
+CG_EvaluateParticlePhysics
+
+Compute the physics on a list of particles, a class at a time
+===============
+*/
+static void CG_EvaluateParticlePhysics( particle_t **list, int numParticles )
+{
+  particle_t        *p;
+  baseParticle_t    *bp;
+  particleSystem_t  *ps, *basePS;
+  vec3_t            base, mins, maxs, pMins, pMaxs;
+  float             radius, maxRadius;
+  qboolean          baseValid = qfalse, collides;
+  int               i, j, k, start, end, first;
+
+  //group the particles by class, keeping their order within a class
+  memset( classOffsets, 0, ( numBaseParticles + 1 ) * sizeof( int ) );
+
+  for( i = 0; i < numParticles; i++ )
+  {
+    if( list[ i ]->valid )
+      classOffsets[ list[ i ]->class - baseParticles + 1 ]++;
+  }
+
+  for( i = 1; i <= numBaseParticles; i++ )
+    classOffsets[ i ] += classOffsets[ i - 1 ];
+
+  for( i = 0; i < numParticles; i++ )
+  {
+    if( list[ i ]->valid )
+      physicsParticles[ classOffsets[ list[ i ]->class - baseParticles ]++ ] = list[ i ];
+  }
+
+  numParticles = classOffsets[ numBaseParticles ];
+
+  for( start = 0; start < numParticles; start = end )
+  {
+    bp = physicsParticles[ start ]->class;
+    collides = cg_bounceParticles.integer && CG_ParticleCollides( bp );
+    basePS = NULL;
+
+    for( end = start; end < numParticles && physicsParticles[ end ]->class == bp; end++ )
+    {
+      p = physicsParticles[ end ];
+      ps = p->parent->parent;
+      physicsRadii[ end ] = -1.0f;
+
+      if( p->atRest )
+      {
+        VectorClear( p->velocity );
+        continue;
+      }
+
+      //attachments only need looking at once per system
+      if( ps != basePS )
+      {
+        basePS = ps;
+        baseValid = CG_ParticleAccelerationBase( bp, ps, base );
+      }
+
+      if( !baseValid )
+        continue;
+
+      CG_MoveParticle( p, base, physicsOrigins[ end ] );
+
+      // we're not doing particle physics, but at least cull them in solids
+      if( !cg_bounceParticles.integer )
+      {
+        int contents = trap_CM_PointContents( physicsOrigins[ end ], 0 );
+
+        if( ( contents & CONTENTS_SOLID ) || ( contents & CONTENTS_NODROP ) )
+          CG_DestroyParticle( p, NULL );
+        else
+          VectorCopy( physicsOrigins[ end ], p->origin );
+
+        continue;
+      }
+
+      if( !collides )
+      {
+        VectorCopy( physicsOrigins[ end ], p->origin );
+        continue;
+      }
+
+      physicsRadii[ end ] = CG_LerpValues( p->radius.initial,
+                                           p->radius.final,
+                                           CG_CalculateTimeFrac( p->birthTime,
+                                                                 p->lifeTime,
+                                                                 p->radius.delay ) );
+    }
+
+    if( !collides )
+      continue;
+
+    //trace neighbouring particles of the same system together
+    for( i = start; i < end; i = j )
+    {
+      if( physicsRadii[ i ] < 0.0f )
+      {
+        j = i + 1;
+        continue;
+      }
+
+      first = i;
+      ps = physicsParticles[ i ]->parent->parent;
+      ClearBounds( mins, maxs );
+      maxRadius = 0.0f;
+
+      for( j = i; j < end; j++ )
+      {
+        p = physicsParticles[ j ];
+
+        if( physicsRadii[ j ] < 0.0f || p->parent->parent != ps )
+          break;
+
+        VectorCopy( mins, pMins );
+        VectorCopy( maxs, pMaxs );
+        AddPointToBounds( p->origin, pMins, pMaxs );
+        AddPointToBounds( physicsOrigins[ j ], pMins, pMaxs );
+        radius = MAX( maxRadius, physicsRadii[ j ] );
+
+        if( j > first )
+        {
+          for( k = 0; k < 3; k++ )
+          {
+            if( pMaxs[ k ] - pMins[ k ] + 2.0f * radius > PARTICLE_CLUSTER_SIZE )
+              break;
+          }
+
+          if( k < 3 )
+            break;
+        }
+
+        VectorCopy( pMins, mins );
+        VectorCopy( pMaxs, maxs );
+        maxRadius = radius;
+      }
+
+      //the box swept by the cluster, padded a little for the trace epsilon
+      for( k = 0; k < 3; k++ )
+      {
+        mins[ k ] -= maxRadius + 1.0f;
+        maxs[ k ] += maxRadius + 1.0f;
+      }
+
+      CG_CollideParticleCluster( first, j, mins, maxs );
+    }
+  }
+}
+
 
 #define GETKEY(x,y) (((x)>>y)&0xFF)
 
+//sort keys are whole units of distance from the view, so particles
+//that barely move relative to each other keep their order
+#define MAX_PARTICLE_SORT_KEY     0xFFFFFF
+
+//shifts per particle the insertion sort may make before giving up
+#define MAX_PARTICLE_SORT_SHIFTS  4
+
 /*
 ===============
 CG_Radix
+
+One pass of a descending radix sort
 ===============
 */
 static void CG_Radix( int bits, int size, particle_t **source, particle_t **dest )
@@ -2183,10 +2497,10 @@ static void CG_Radix( int bits, int size, particle_t **source, particle_t **dest
   for( i = 0; i < size; i++ )
     count[ GETKEY( source[ i ]->sortKey, bits ) ]++;
 
-  index[ 0 ] = 0;
+  index[ 255 ] = 0;
 
-  for( i = 1; i < 256; i++ )
-    index[ i ] = index[ i - 1 ] + count[ i - 1 ];
+  for( i = 254; i >= 0; i-- )
+    index[ i ] = index[ i + 1 ] + count[ i + 1 ];
 
   for( i = 0; i < size; i++ )
     dest[ index[ GETKEY( source[ i ]->sortKey, bits ) ]++ ] = source[ i ];
@@ -2196,7 +2510,7 @@ static void CG_Radix( int bits, int size, particle_t **source, particle_t **dest
 ===============
 CG_RadixSort
 
-Radix sort with 4 byte size buckets
+Radix sort 3 byte keys into descending order
 ===============
 */
 static void CG_RadixSort( particle_t **source, particle_t **temp, int size )
@@ -2204,62 +2518,105 @@ static void CG_RadixSort( particle_t **source, particle_t **temp, int size )
   CG_Radix( 0,   size, source, temp );
   CG_Radix( 8,   size, temp, source );
   CG_Radix( 16,  size, source, temp );
-  CG_Radix( 24,  size, temp, source );
+
+  memcpy( source, temp, size * sizeof( particle_t * ) );
+}
+
+/*
+===============
+CG_ParticleDepthSorted
+
+Everything is drawn back to front unless its class is marked unsorted,
+meaning it blends the same in any order
+===============
+*/
+static qboolean CG_ParticleDepthSorted( baseParticle_t *bp )
+{
+  return !bp->unsorted;
 }
 
 /*
 ===============
 CG_CompactAndSortParticles
 
-Depth sort the particles
+Drop destroyed particles and depth sort the rest, far to near, after
+those that don't need sorting. Last frame's order is the starting point,
+so usually only a few particles need to move
 ===============
 */
 static void CG_CompactAndSortParticles( void )
 {
-  int     i, j = 0;
-  int     numParticles;
-  vec3_t  delta;
+  int         i, j = 0, k = 0;
+  int         first, limit, start;
+  particle_t  *p;
+  vec3_t      delta;
+  float       distance;
+  qboolean    depthSort = cg_depthSortParticles.integer;
+
+  //drop the particles destroyed since last frame, moving the ones that
+  //need sorting to the end
+  for( i = 0; i < numActiveParticles; i++ )
+  {
+    p = activeParticles[ i ];
 
-  for( i = 0; i < MAX_PARTICLES; i++ )
-    sortedParticles[ i ] = &particles[ i ];
+    if( !p->valid )
+      continue;
 
-  if( !cg_depthSortParticles.integer )
-    return;
+    if( depthSort && CG_ParticleDepthSorted( p->class ) )
+      radixBuffer[ k++ ] = p;
+    else
+      activeParticles[ j++ ] = p;
+  }
 
-  for( i = MAX_PARTICLES - 1; i >= 0; i-- )
-  {
-    if( sortedParticles[ i ]->valid )
-    {
-      //find the first hole
-      while( j < MAX_PARTICLES && sortedParticles[ j ]->valid )
-        j++;
+  first = j;
+  memcpy( activeParticles + first, radixBuffer, k * sizeof( particle_t * ) );
+  numActiveParticles = first + k;
 
-      //no more holes
-      if( j >= i )
-        break;
+  numDepthSortedParticles = k;
+  numDepthSortShifts = 0;
+  depthSortFellBack = qfalse;
+  depthSortMsec = 0;
 
-      sortedParticles[ j ] = sortedParticles[ i ];
-    }
-  }
+  if( !k )
+    return;
 
-  numParticles = i;
+  start = trap_Milliseconds( );
 
   //set sort keys
-  for( i = 0; i < numParticles; i++ )
+  for( i = first; i < numActiveParticles; i++ )
   {
-    VectorSubtract( sortedParticles[ i ]->origin, cg.refdef.vieworg, delta );
-    sortedParticles[ i ]->sortKey = (int)DotProduct( delta, delta );
+    p = activeParticles[ i ];
+    VectorSubtract( p->origin, cg.refdef.vieworg, delta );
+    distance = VectorLength( delta );
+
+    if( distance >= (float)MAX_PARTICLE_SORT_KEY )
+      p->sortKey = MAX_PARTICLE_SORT_KEY;
+    else
+      p->sortKey = (int)distance;
   }
 
-  CG_RadixSort( sortedParticles, radixBuffer, numParticles );
+  //insertion sort, cheap while the view changes little
+  limit = k * MAX_PARTICLE_SORT_SHIFTS;
 
-  //FIXME: wtf?
-  //reverse order of particles array
-  for( i = 0; i < numParticles; i++ )
-    radixBuffer[ i ] = sortedParticles[ numParticles - i - 1 ];
+  for( i = first + 1; i < numActiveParticles && numDepthSortShifts <= limit; i++ )
+  {
+    p = activeParticles[ i ];
 
-  for( i = 0; i < numParticles; i++ )
-    sortedParticles[ i ] = radixBuffer[ i ];
+    for( j = i; j > first && activeParticles[ j - 1 ]->sortKey < p->sortKey; j-- )
+      activeParticles[ j ] = activeParticles[ j - 1 ];
+
+    activeParticles[ j ] = p;
+    numDepthSortShifts += i - j;
+  }
+
+  //too far out of order, start again
+  if( numDepthSortShifts > limit )
+  {
+    depthSortFellBack = qtrue;
+    CG_RadixSort( activeParticles + first, radixBuffer, k );
+  }
+
+  depthSortMsec = trap_Milliseconds( ) - start;
 }
 
 /*
@@ -2421,6 +2778,54 @@ static void CG_RenderParticle( particle_t *p )
   trap_R_AddRefEntityToScene( &re );
 }
 
+/*
+===============
+CG_ReportTestPSStress
+
+Print the physics throughput measured since testPS was given a count
+===============
+*/
+static void CG_ReportTestPSStress( void )
+{
+  testPSStress = qfalse;
+
+  CG_Printf( "testPS: %d particles evaluated over %d frames in %dms",
+             testPSParticles, testPSFrames, testPSMsec );
+
+  if( testPSMsec > 0 )
+    CG_Printf( ", %d particles/ms", testPSParticles / testPSMsec );
+
+  CG_Printf( "\n        %d particle traces, %d cluster traces\n",
+             testPSTraces, testPSClusterTraces );
+}
+
+/*
+===============
+CG_UpdateTestPSStress
+
+Add a frame's physics to the testPS measurement, and report it once
+every test system has gone
+===============
+*/
+static void CG_UpdateTestPSStress( int msec )
+{
+  int i;
+
+  testPSFrames++;
+  testPSParticles += numActiveParticles;
+  testPSMsec += msec;
+  testPSTraces += numParticleTraces;
+  testPSClusterTraces += numParticleClusterTraces;
+
+  for( i = 0; i < MAX_TEST_PARTICLE_SYSTEMS; i++ )
+  {
+    if( CG_IsParticleSystemValid( &testPS[ i ] ) )
+      return;
+  }
+
+  CG_ReportTestPSStress( );
+}
+
 /*
 ===============
 CG_AddParticles
@@ -2430,10 +2835,15 @@ Add particles to the scene
 */
 void CG_AddParticles( void )
 {
-  int           i;
+  int           i, start;
   particle_t    *p;
   int           numPS = 0, numPE = 0, numP = 0;
 
+  numDroppedParticles = 0;
+
+  //free the slots of particles destroyed a couple of frames ago
+  CG_ReclaimParticles( );
+
   //remove expired particle systems
   CG_GarbageCollectParticleSystems( );
 
@@ -2443,21 +2853,29 @@ void CG_AddParticles( void )
   //sorting
   CG_CompactAndSortParticles( );
 
-  for( i = 0; i < MAX_PARTICLES; i++ )
+  for( i = 0; i < numActiveParticles; i++ )
   {
-    p = sortedParticles[ i ];
+    p = activeParticles[ i ];
 
-    if( p->valid )
-    {
-      if( p->birthTime + p->lifeTime > cg.time )
-      {
-        //particle is active
-        CG_EvaluateParticlePhysics( p );
-        CG_RenderParticle( p );
-      }
-      else
-        CG_DestroyParticle( p, NULL );
-    }
+    if( p->birthTime + p->lifeTime <= cg.time )
+      CG_DestroyParticle( p, NULL );
+  }
+
+  numParticleTraces = numParticleClusterTraces = 0;
+  start = trap_Milliseconds( );
+
+  CG_EvaluateParticlePhysics( activeParticles, numActiveParticles );
+
+  if( testPSStress )
+    CG_UpdateTestPSStress( trap_Milliseconds( ) - start );
+
+  //particles culled by their physics this frame are still drawn once
+  for( i = 0; i < numActiveParticles; i++ )
+  {
+    p = activeParticles[ i ];
+
+    if( p->birthTime + p->lifeTime > cg.time )
+      CG_RenderParticle( p );
   }
 
   if( cg_debugParticles.integer >= 2 )
@@ -2470,12 +2888,18 @@ void CG_AddParticles( void )
       if( particleEjectors[ i ].valid )
         numPE++;
 
-    for( i = 0; i < MAX_PARTICLES; i++ )
-      if( particles[ i ].valid )
+    for( i = 0; i < numActiveParticles; i++ )
+      if( activeParticles[ i ]->valid )
         numP++;
 
-    CG_Printf( "PS: %d  PE: %d  P: %d\n", numPS, numPE, numP );
+    CG_Printf( "PS: %d  PE: %d  P: %d  free: %d  dropped: %d  "
+               "sorted: %d in %dms, %d shifts%s\n",
+               numPS, numPE, numP, numFreeParticles, numDroppedParticles,
+               numDepthSortedParticles, depthSortMsec, numDepthSortShifts,
+               depthSortFellBack ? ", radix" : "" );
   }
+  else if( cg_debugParticles.integer >= 1 && numDroppedParticles )
+    CG_Printf( "P pool exhausted, %d particles dropped\n", numDroppedParticles );
 }
 
 /*
@@ -2514,27 +2938,33 @@ void CG_ParticleSystemEntity( centity_t *cent )
   }
 }
 
-static particleSystem_t *testPS;
-static qhandle_t        testPSHandle;
-
 /*
 ===============
 CG_DestroyTestPS_f
 
-Destroy the test a particle system
+Destroy the test particle systems
 ===============
 */
 void CG_DestroyTestPS_f( void )
 {
-  if( CG_IsParticleSystemValid( &testPS ) )
-    CG_DestroyParticleSystem( &testPS );
+  int i;
+
+  for( i = 0; i < MAX_TEST_PARTICLE_SYSTEMS; i++ )
+  {
+    if( CG_IsParticleSystemValid( &testPS[ i ] ) )
+      CG_DestroyParticleSystem( &testPS[ i ] );
+  }
+
+  if( testPSStress )
+    CG_ReportTestPSStress( );
 }
 
 /*
 ===============
 CG_TestPS_f
 
-Test a particle system
+Test a particle system. Given a count, spawn that many copies in
+front of the view and measure the particle physics until they are gone
 ===============
 */
 void CG_TestPS_f( void )
@@ -2542,26 +2972,51 @@ void CG_TestPS_f( void )
   vec3_t  origin;
   vec3_t  up = { 0.0f, 0.0f, 1.0f };
   char    psName[ MAX_QPATH ];
+  int     i, count = 1;
 
   if( trap_Argc( ) < 2 )
+  {
+    CG_Printf( "usage: testPS <particle system> [count]\n" );
     return;
+  }
 
   Q_strncpyz( psName, CG_Argv( 1 ), MAX_QPATH );
   testPSHandle = CG_RegisterParticleSystem( psName );
 
+  if( trap_Argc( ) > 2 )
+    count = atoi( CG_Argv( 2 ) );
+
+  if( count < 1 )
+    count = 1;
+  else if( count > MAX_TEST_PARTICLE_SYSTEMS )
+    count = MAX_TEST_PARTICLE_SYSTEMS;
+
   if( testPSHandle )
   {
     CG_DestroyTestPS_f( );
 
-    testPS = CG_SpawnNewParticleSystem( testPSHandle );
+    for( i = 0; i < count; i++ )
+    {
+      testPS[ i ] = CG_SpawnNewParticleSystem( testPSHandle );
+
+      //rows of eight, 32 units apart
+      VectorMA( cg.refdef.vieworg, 100, cg.refdef.viewaxis[ 0 ], origin );
+      VectorMA( origin, ( ( i % 8 ) - 3.5f ) * 32.0f, cg.refdef.viewaxis[ 1 ], origin );
+      VectorMA( origin, ( i / 8 ) * 32.0f, cg.refdef.viewaxis[ 2 ], origin );
 
-    VectorMA( cg.refdef.vieworg, 100, cg.refdef.viewaxis[ 0 ], origin );
+      if( CG_IsParticleSystemValid( &testPS[ i ] ) )
+      {
+        CG_SetAttachmentPoint( &testPS[ i ]->attachment, origin );
+        CG_SetParticleSystemNormal( testPS[ i ], up );
+        CG_AttachToPoint( &testPS[ i ]->attachment );
+      }
+    }
 
-    if( CG_IsParticleSystemValid( &testPS ) )
+    if( trap_Argc( ) > 2 )
     {
-      CG_SetAttachmentPoint( &testPS->attachment, origin );
-      CG_SetParticleSystemNormal( testPS, up );
-      CG_AttachToPoint( &testPS->attachment );
+      testPSStress = qtrue;
+      testPSFrames = testPSParticles = testPSMsec = 0;
+      testPSTraces = testPSClusterTraces = 0;
     }
   }
 }
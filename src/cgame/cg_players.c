@@ -538,7 +538,6 @@ static void CG_LoadClientInfo( clientInfo_t *ci )
   const char  *dir, *fallback;
   int         i;
   const char  *s;
-  int         clientNum;
 
   if( !CG_RegisterClientModelname( ci, ci->modelName, ci->skinName ) )
   {
@@ -604,9 +603,20 @@ static void CG_LoadClientInfo( clientInfo_t *ci )
     }
   }
 
-  // reset any existing players and bodies, because they might be in bad
-  // frames for this new model
-  clientNum = ci - cgs.clientinfo;
+}
+
+/*
+===================
+CG_ResetClientEntities
+
+Reset any existing players and bodies of a client, because they might be
+in bad frames for a new model
+===================
+*/
+static void CG_ResetClientEntities( int clientNum )
+{
+  int i;
+
   for( i = 0; i < MAX_GENTITIES; i++ )
   {
     if( cg_entities[ i ].currentState.clientNum == clientNum &&
@@ -679,35 +689,219 @@ static int CG_GetCorpseNum( pClass_t class )
 }
 
 
+/*
+=============================================================================
+
+CLIENT MODEL CACHE
+
+Every clientinfo and corpseinfo holds a reference to a shared entry keyed by
+model and skin, so a model is only ever loaded once. Entries that aren't
+loaded yet are finished off a few per frame by CG_LoadDeferredClientModels
+while their clients are drawn with their class's precached model
+
+=============================================================================
+*/
+
+#define MAX_CLIENT_MODELS       ( MAX_CLIENTS + PCL_NUM_CLASSES )
+#define CLIENT_MODEL_HASH_SIZE  64
+#define CLIENT_MODEL_LOAD_MSEC  4     // frame time to spend on deferred loads
+
+typedef struct clientModel_s
+{
+  clientInfo_t          info;       // model, skin, animations and sounds
+  qboolean              loaded;
+  int                   refCount;   // clientinfos and corpseinfos using it
+
+  struct clientModel_s  *hashNext;
+} clientModel_t;
+
+static clientModel_t  clientModels[ MAX_CLIENT_MODELS ];
+static clientModel_t  *clientModelHash[ CLIENT_MODEL_HASH_SIZE ];
+static int            numClientModels;
+
 /*
 ======================
-CG_ScanForExistingClientInfo
+CG_InitClientModels
 ======================
 */
-static qboolean CG_ScanForExistingClientInfo( clientInfo_t *ci )
+void CG_InitClientModels( void )
 {
-  int   i;
-  clientInfo_t  *match;
+  memset( clientModels, 0, sizeof( clientModels ) );
+  memset( clientModelHash, 0, sizeof( clientModelHash ) );
+  numClientModels = 0;
+}
+
+/*
+======================
+CG_ClientModelHash
+======================
+*/
+static int CG_ClientModelHash( const char *modelName, const char *skinName )
+{
+  int           i;
+  unsigned int  hash = 0;
+
+  for( i = 0; modelName[ i ]; i++ )
+    hash = hash * 31 + tolower( modelName[ i ] );
+
+  hash = hash * 31 + '/';
+
+  for( i = 0; skinName[ i ]; i++ )
+    hash = hash * 31 + tolower( skinName[ i ] );
+
+  return hash & ( CLIENT_MODEL_HASH_SIZE - 1 );
+}
+
+/*
+======================
+CG_FindClientModel
+
+Find the cache entry for a model and skin, making a new unloaded one if
+there isn't one already
+======================
+*/
+static clientModel_t *CG_FindClientModel( const char *modelName, const char *skinName )
+{
+  int           i, hash = CG_ClientModelHash( modelName, skinName );
+  clientModel_t *cm, **prev;
+
+  for( cm = clientModelHash[ hash ]; cm; cm = cm->hashNext )
+  {
+    if( !Q_stricmp( modelName, cm->info.modelName ) &&
+        !Q_stricmp( skinName, cm->info.skinName ) )
+      return cm;
+  }
+
+  if( numClientModels < MAX_CLIENT_MODELS )
+    cm = &clientModels[ numClientModels++ ];
+  else
+  {
+    // reuse an entry nothing refers to any more
+    for( i = 0; i < MAX_CLIENT_MODELS; i++ )
+    {
+      if( !clientModels[ i ].refCount )
+        break;
+    }
+
+    if( i == MAX_CLIENT_MODELS )
+      CG_Error( "CG_FindClientModel: MAX_CLIENT_MODELS hit" );
+
+    cm = &clientModels[ i ];
+
+    prev = &clientModelHash[ CG_ClientModelHash( cm->info.modelName, cm->info.skinName ) ];
+    while( *prev != cm )
+      prev = &(*prev)->hashNext;
+
+    *prev = cm->hashNext;
+  }
+
+  memset( cm, 0, sizeof( *cm ) );
+  Q_strncpyz( cm->info.modelName, modelName, sizeof( cm->info.modelName ) );
+  Q_strncpyz( cm->info.skinName, skinName, sizeof( cm->info.skinName ) );
+  cm->info.infoValid = qtrue;
+
+  cm->hashNext = clientModelHash[ hash ];
+  clientModelHash[ hash ] = cm;
+
+  return cm;
+}
 
+/*
+======================
+CG_LoadClientModel
+======================
+*/
+static void CG_LoadClientModel( clientModel_t *cm )
+{
+  if( cm->loaded )
+    return;
+
+  CG_LoadClientInfo( &cm->info );
+  cm->loaded = qtrue;
+}
+
+/*
+======================
+CG_ReleaseClientModel
+======================
+*/
+static void CG_ReleaseClientModel( clientInfo_t *ci )
+{
+  if( ci->model )
+    ci->model->refCount--;
+
+  ci->model = NULL;
+}
+
+/*
+======================
+CG_DeferredClientClass
+
+The class whose precached model stands in for a client's until it loads
+======================
+*/
+static pClass_t CG_DeferredClientClass( int clientNum, clientInfo_t *ci )
+{
+  int           i;
+  entityState_t *es = &cg_entities[ clientNum ].currentState;
+
+  // a different skin of a class model
   for( i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++ )
   {
-    match = &cgs.corpseinfo[ i ];
+    if( cgs.corpseinfo[ i ].infoValid &&
+        !Q_stricmp( ci->modelName, cgs.corpseinfo[ i ].modelName ) )
+      return i;
+  }
 
-    if( !match->infoValid )
+  // whatever the client's last known to be playing as
+  i = ( es->misc >> 8 ) & 0xFF;
+  if( es->eType == ET_PLAYER && i > PCL_NONE && i < PCL_NUM_CLASSES &&
+      cgs.corpseinfo[ i ].infoValid )
+    return i;
+
+  return PCL_HUMAN;
+}
+
+/*
+======================
+CG_LoadDeferredClientModels
+
+Load models that were deferred, as many as fit in the frame's budget, and
+hand them to the clients waiting on them
+======================
+*/
+void CG_LoadDeferredClientModels( void )
+{
+  int           i, j, start;
+  clientModel_t *cm;
+  clientInfo_t  *ci;
+
+  start = trap_Milliseconds( );
+
+  for( i = 0; i < numClientModels; i++ )
+  {
+    cm = &clientModels[ i ];
+
+    if( cm->loaded || !cm->refCount )
       continue;
 
-    if( !Q_stricmp( ci->modelName, match->modelName ) &&
-        !Q_stricmp( ci->skinName, match->skinName ) )
+    if( trap_Milliseconds( ) - start >= CLIENT_MODEL_LOAD_MSEC )
+      break;
+
+    CG_LoadClientModel( cm );
+
+    for( j = 0; j < MAX_CLIENTS; j++ )
     {
-      // this clientinfo is identical, so use it's handles
-      CG_CopyClientInfoModel( match, ci );
+      ci = &cgs.clientinfo[ j ];
 
-      return qtrue;
+      if( ci->infoValid && ci->deferred && ci->model == cm )
+      {
+        CG_CopyClientInfoModel( &cm->info, ci );
+        ci->deferred = qfalse;
+        CG_ResetClientEntities( j );
+      }
     }
   }
-
-  // shouldn't happen
-  return qfalse;
 }
 
 
@@ -745,8 +939,13 @@ void CG_PrecacheClientInfo( pClass_t class, char *model, char *skin )
   newInfo.infoValid = qtrue;
 
   // actually register the models
+  CG_ReleaseClientModel( ci );
   *ci = newInfo;
-  CG_LoadClientInfo( ci );
+
+  ci->model = CG_FindClientModel( ci->modelName, ci->skinName );
+  ci->model->refCount++;
+  CG_LoadClientModel( ci->model );
+  CG_CopyClientInfoModel( &ci->model->info, ci );
 }
 
 
@@ -768,6 +967,7 @@ void CG_NewClientInfo( int clientNum )
   configstring = CG_ConfigString( clientNum + CS_PLAYERS );
   if( !configstring[ 0 ] )
   {
+    CG_ReleaseClientModel( ci );
     memset( ci, 0, sizeof( *ci ) );
     return;   // player just left
   }
@@ -854,12 +1054,30 @@ void CG_NewClientInfo( int clientNum )
 
   // replace whatever was there with the new one
   newInfo.infoValid = qtrue;
+  CG_ReleaseClientModel( ci );
   *ci = newInfo;
 
-  // scan for an existing clientinfo that matches this modelname
-  // so we can avoid loading checks if possible
-  if( !CG_ScanForExistingClientInfo( ci ) )
-    CG_LoadClientInfo( ci );
+  ci->model = CG_FindClientModel( ci->modelName, ci->skinName );
+  ci->model->refCount++;
+
+  if( !ci->model->loaded )
+  {
+    // the local client and anyone there at startup are loaded now, everyone
+    // else borrows their class's model until the real one has been loaded
+    if( cg.loading || !cg_deferPlayers.integer || clientNum == cg.clientNum )
+    {
+      CG_LoadClientModel( ci->model );
+      CG_ResetClientEntities( clientNum );
+    }
+    else
+    {
+      CG_CopyClientInfoModel( &cgs.corpseinfo[ CG_DeferredClientClass( clientNum, ci ) ], ci );
+      ci->deferred = qtrue;
+      return;
+    }
+  }
+
+  CG_CopyClientInfoModel( &ci->model->info, ci );
 }
 
 
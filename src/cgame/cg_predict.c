@@ -32,154 +32,399 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 static  pmove_t   cg_pmove;
 
 static  int     cg_numSolidEntities;
-static  centity_t *cg_solidEntities[MAX_ENTITIES_IN_SNAPSHOT];
+static  centity_t **cg_solidEntities;
 static  int     cg_numTriggerEntities;
-static  centity_t *cg_triggerEntities[MAX_ENTITIES_IN_SNAPSHOT];
+static  centity_t **cg_triggerEntities;
+
+// the solid list is filed into a hashed grid of columns so a trace only
+// tests the entities near it. Entities move every frame so the grid is
+// rebuilt the first time it's needed each frame and after they've been
+// lerped, with some slack for anything that has moved in between
+#define SOLID_CELL_SIZE         256
+#define SOLID_CELL_HASH         256
+#define SOLID_CELL_SLACK        64.0f
+#define MAX_SOLID_QUERY_CELLS   16    // traces covering more than this test every solid
+#define MAX_SOLID_CELL_LINKS    ( MAX_ENTITIES_IN_SNAPSHOT * 16 )
+
+typedef struct
+{
+  int     solid;    // index into cg_solidEntities
+  int     x, y;     // cell
+  int     next;
+} solidCellLink_t;
+
+static  solidCellLink_t solidCellLinks[ MAX_SOLID_CELL_LINKS ];
+static  int     numSolidCellLinks;
+static  int     solidCells[ SOLID_CELL_HASH ];    // first link, -1 for none
+static  vec3_t  solidMins[ MAX_ENTITIES_IN_SNAPSHOT ];
+static  vec3_t  solidMaxs[ MAX_ENTITIES_IN_SNAPSHOT ];
+static  int     bmodelSolids[ MAX_ENTITIES_IN_SNAPSHOT ];
+static  int     numBModelSolids;
+static  int     solidQueryStamps[ MAX_ENTITIES_IN_SNAPSHOT ];
+static  int     solidQuery;
+static  qboolean solidGridValid;
+static  int     solidGridFrame;
+
+// cg_debugTraceStats
+static  int     numTraces;
+static  int     numSolidCandidates;
+static  int     numSolidTests;
+static  int     numFullSolidScans;
 
 /*
 ====================
 CG_BuildSolidList
 
-When a new cg.snap has been set, this function builds a sublist
-of the entities that are actually solid, to make for more
-efficient collision detection
+When a new cg.snap has been set, this function picks the solid and
+trigger lists of the snapshot to collide against, which are built
+along with the rest of its index
 ====================
 */
 void CG_BuildSolidList( void )
 {
-  int           i;
-  centity_t     *cent;
-  snapshot_t    *snap;
-  entityState_t *ent;
-
-  cg_numSolidEntities = 0;
-  cg_numTriggerEntities = 0;
+  snapshotIndex_t *index;
 
   if( cg.nextSnap && !cg.nextFrameTeleport && !cg.thisFrameTeleport )
-    snap = cg.nextSnap;
+    index = cg.nextSnapIndex;
   else
-    snap = cg.snap;
+    index = cg.snapIndex;
+
+  cg_numSolidEntities = index->numSolids;
+  cg_solidEntities = index->solids;
+  cg_numTriggerEntities = index->numTriggers;
+  cg_triggerEntities = index->triggers;
+
+  solidGridValid = qfalse;
+}
+
+/*
+====================
+CG_InvalidateSolidGrid
 
-  for( i = 0; i < snap->numEntities; i++ )
+Entities have moved, so the grid has to be rebuilt before the next trace
+====================
+*/
+void CG_InvalidateSolidGrid( void )
+{
+  solidGridValid = qfalse;
+}
+
+/*
+====================
+CG_SolidCellHash
+====================
+*/
+static int CG_SolidCellHash( int x, int y )
+{
+  return ( ( x * 73856093 ) ^ ( y * 19349663 ) ) & ( SOLID_CELL_HASH - 1 );
+}
+
+/*
+====================
+CG_SolidBBox
+
+The bounding box encoded in an entity's solid field
+====================
+*/
+static void CG_SolidBBox( entityState_t *ent, vec3_t bmins, vec3_t bmaxs )
+{
+  int x, zd, zu;
+
+  x = ( ent->solid & 255 );
+  zd = ( ( ent->solid >> 8 ) & 255 );
+  zu = ( ( ent->solid >> 16 ) & 255 ) - 32;
+
+  bmins[ 0 ] = bmins[ 1 ] = -x;
+  bmaxs[ 0 ] = bmaxs[ 1 ] = x;
+  bmins[ 2 ] = -zd;
+  bmaxs[ 2 ] = zu;
+}
+
+/*
+====================
+CG_TraceStats
+====================
+*/
+static void CG_TraceStats( void )
+{
+  if( cg_debugTraceStats.integer && numTraces )
   {
-    cent = &cg_entities[ snap->entities[ i ].number ];
+    CG_Printf( "traces: %d  solids: %d  candidates: %d  tests: %d  (%d without grid)  full scans: %d\n",
+               numTraces, cg_numSolidEntities, numSolidCandidates, numSolidTests,
+               numTraces * cg_numSolidEntities, numFullSolidScans );
+  }
+
+  numTraces = numSolidCandidates = numSolidTests = numFullSolidScans = 0;
+}
+
+/*
+====================
+CG_BuildSolidGrid
+====================
+*/
+static void CG_BuildSolidGrid( void )
+{
+  int           i, x, y, x0, y0, x1, y1, hash;
+  entityState_t *ent;
+  centity_t     *cent;
+
+  if( solidGridFrame != cg.clientFrame )
+  {
+    CG_TraceStats( );
+    solidGridFrame = cg.clientFrame;
+  }
+  else if( solidGridValid )
+    return;
+
+  memset( solidCells, -1, sizeof( solidCells ) );
+  numSolidCellLinks = 0;
+  numBModelSolids = 0;
+
+  for( i = 0; i < cg_numSolidEntities; i++ )
+  {
+    cent = cg_solidEntities[ i ];
     ent = &cent->currentState;
 
-    if( ent->eType == ET_ITEM || ent->eType == ET_PUSH_TRIGGER || ent->eType == ET_TELEPORT_TRIGGER )
+    // bmodels are few and their bounds aren't known here, so always test them
+    if( ent->solid == SOLID_BMODEL )
     {
-      cg_triggerEntities[ cg_numTriggerEntities ] = cent;
-      cg_numTriggerEntities++;
+      bmodelSolids[ numBModelSolids++ ] = i;
       continue;
     }
 
-    if( cent->nextState.solid && ent->eType != ET_MISSILE )
+    CG_SolidBBox( ent, solidMins[ i ], solidMaxs[ i ] );
+
+    x0 = (int)floor( ( cent->lerpOrigin[ 0 ] + solidMins[ i ][ 0 ] - SOLID_CELL_SLACK ) / SOLID_CELL_SIZE );
+    y0 = (int)floor( ( cent->lerpOrigin[ 1 ] + solidMins[ i ][ 1 ] - SOLID_CELL_SLACK ) / SOLID_CELL_SIZE );
+    x1 = (int)floor( ( cent->lerpOrigin[ 0 ] + solidMaxs[ i ][ 0 ] + SOLID_CELL_SLACK ) / SOLID_CELL_SIZE );
+    y1 = (int)floor( ( cent->lerpOrigin[ 1 ] + solidMaxs[ i ][ 1 ] + SOLID_CELL_SLACK ) / SOLID_CELL_SIZE );
+
+    for( x = x0; x <= x1; x++ )
     {
-      cg_solidEntities[ cg_numSolidEntities ] = cent;
-      cg_numSolidEntities++;
-      continue;
+      for( y = y0; y <= y1; y++ )
+      {
+        if( numSolidCellLinks >= MAX_SOLID_CELL_LINKS )
+          break;
+
+        hash = CG_SolidCellHash( x, y );
+
+        solidCellLinks[ numSolidCellLinks ].solid = i;
+        solidCellLinks[ numSolidCellLinks ].x = x;
+        solidCellLinks[ numSolidCellLinks ].y = y;
+        solidCellLinks[ numSolidCellLinks ].next = solidCells[ hash ];
+        solidCells[ hash ] = numSolidCellLinks++;
+      }
     }
   }
+
+  solidGridValid = qtrue;
 }
 
 /*
 ====================
-CG_ClipMoveToEntities
-
+CG_ClipMoveToEntity
 ====================
 */
-static void CG_ClipMoveToEntities ( const vec3_t start, const vec3_t mins,
-    const vec3_t maxs, const vec3_t end, int skipNumber,
+static void CG_ClipMoveToEntity( centity_t *cent, qboolean predictedPlayer,
+    const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end,
     int mask, trace_t *tr, traceType_t collisionType )
 {
-  int           i, j, x, zd, zu;
   trace_t       trace;
-  entityState_t *ent;
+  entityState_t *ent = &cent->currentState;
   clipHandle_t  cmodel;
   vec3_t        bmins, bmaxs;
   vec3_t        origin, angles;
-  centity_t     *cent;
 
-  //SUPAR HACK
-  //this causes a trace to collide with the local player
-  if( skipNumber == MAGIC_TRACE_HACK )
-    j = cg_numSolidEntities + 1;
+  if( ent->solid == SOLID_BMODEL )
+  {
+    // special value for bmodel
+    cmodel = trap_CM_InlineModel( ent->modelindex );
+    VectorCopy( cent->lerpAngles, angles );
+    BG_EvaluateTrajectory( &cent->currentState.pos, cg.physicsTime, origin );
+  }
   else
-    j = cg_numSolidEntities;
-
-  for( i = 0; i < j; i++ )
   {
-    if( i < cg_numSolidEntities )
-      cent = cg_solidEntities[ i ];
-    else
-      cent = &cg.predictedPlayerEntity;
+    // encoded bbox
+    CG_SolidBBox( ent, bmins, bmaxs );
 
-    ent = &cent->currentState;
+    if( predictedPlayer )
+      BG_FindBBoxForClass( ( ent->misc >> 8 ) & 0xFF, bmins, bmaxs, NULL, NULL, NULL );
 
-    if( ent->number == skipNumber )
-      continue;
+    cmodel = trap_CM_TempBoxModel( bmins, bmaxs );
+    VectorCopy( vec3_origin, angles );
+    VectorCopy( cent->lerpOrigin, origin );
+  }
 
-    if( ent->solid == SOLID_BMODEL )
+  numSolidTests++;
+
+  if( collisionType == TT_CAPSULE )
+  {
+    trap_CM_TransformedCapsuleTrace ( &trace, start, end,
+      mins, maxs, cmodel,  mask, origin, angles );
+  }
+  else if( collisionType == TT_AABB )
+  {
+    trap_CM_TransformedBoxTrace ( &trace, start, end,
+      mins, maxs, cmodel,  mask, origin, angles );
+  }
+  else if( collisionType == TT_BISPHERE )
+  {
+    trap_CM_TransformedBiSphereTrace( &trace, start, end,
+      mins[ 0 ], maxs[ 0 ], cmodel, mask, origin );
+  }
+
+  if( trace.allsolid || trace.fraction < tr->fraction )
+  {
+    trace.entityNum = ent->number;
+
+    if( tr->lateralFraction < trace.lateralFraction )
     {
-      // special value for bmodel
-      cmodel = trap_CM_InlineModel( ent->modelindex );
-      VectorCopy( cent->lerpAngles, angles );
-      BG_EvaluateTrajectory( &cent->currentState.pos, cg.physicsTime, origin );
+      float oldLateralFraction = tr->lateralFraction;
+      *tr = trace;
+      tr->lateralFraction = oldLateralFraction;
     }
     else
+      *tr = trace;
+  }
+  else if( trace.startsolid )
+    tr->startsolid = qtrue;
+}
+
+/*
+====================
+CG_ClipMoveToSolid
+
+Clip against one of the solid list if its box touches the swept box
+====================
+*/
+static void CG_ClipMoveToSolid( int solid, const vec3_t traceMins, const vec3_t traceMaxs,
+    const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end,
+    int skipNumber, int mask, trace_t *tr, traceType_t collisionType )
+{
+  int       i;
+  centity_t *cent = cg_solidEntities[ solid ];
+
+  if( solidQueryStamps[ solid ] == solidQuery )
+    return;
+
+  solidQueryStamps[ solid ] = solidQuery;
+  numSolidCandidates++;
+
+  if( cent->currentState.number == skipNumber )
+    return;
+
+  if( cent->currentState.solid != SOLID_BMODEL )
+  {
+    for( i = 0; i < 3; i++ )
     {
-      // encoded bbox
-      x = ( ent->solid & 255 );
-      zd = ( ( ent->solid >> 8 ) & 255 );
-      zu = ( ( ent->solid >> 16 ) & 255 ) - 32;
-
-      bmins[ 0 ] = bmins[ 1 ] = -x;
-      bmaxs[ 0 ] = bmaxs[ 1 ] = x;
-      bmins[ 2 ] = -zd;
-      bmaxs[ 2 ] = zu;
-
-      if( i == cg_numSolidEntities )
-        BG_FindBBoxForClass( ( ent->misc >> 8 ) & 0xFF, bmins, bmaxs, NULL, NULL, NULL );
-
-      cmodel = trap_CM_TempBoxModel( bmins, bmaxs );
-      VectorCopy( vec3_origin, angles );
-      VectorCopy( cent->lerpOrigin, origin );
+      if( cent->lerpOrigin[ i ] + solidMins[ solid ][ i ] > traceMaxs[ i ] ||
+          cent->lerpOrigin[ i ] + solidMaxs[ solid ][ i ] < traceMins[ i ] )
+        return;
     }
+  }
 
+  CG_ClipMoveToEntity( cent, qfalse, start, mins, maxs, end, mask, tr, collisionType );
+}
+
+/*
+====================
+CG_ClipMoveToEntities
 
-    if( collisionType == TT_CAPSULE )
+====================
+*/
+static void CG_ClipMoveToEntities ( const vec3_t start, const vec3_t mins,
+    const vec3_t maxs, const vec3_t end, int skipNumber,
+    int mask, trace_t *tr, traceType_t collisionType )
+{
+  int             i, x, y, x0, y0, x1, y1, link;
+  vec3_t          traceMins, traceMaxs;
+  float           radius;
+  solidCellLink_t *l;
+
+  CG_BuildSolidGrid( );
+
+  numTraces++;
+  solidQuery++;
+
+  // the box swept by the trace, with a little extra for the epsilons
+  for( i = 0; i < 3; i++ )
+  {
+    if( start[ i ] < end[ i ] )
     {
-      trap_CM_TransformedCapsuleTrace ( &trace, start, end,
-        mins, maxs, cmodel,  mask, origin, angles );
+      traceMins[ i ] = start[ i ] - 1.0f;
+      traceMaxs[ i ] = end[ i ] + 1.0f;
     }
-    else if( collisionType == TT_AABB )
+    else
     {
-      trap_CM_TransformedBoxTrace ( &trace, start, end,
-        mins, maxs, cmodel,  mask, origin, angles );
+      traceMins[ i ] = end[ i ] - 1.0f;
+      traceMaxs[ i ] = start[ i ] + 1.0f;
     }
-    else if( collisionType == TT_BISPHERE )
+
+    if( collisionType == TT_BISPHERE )
     {
-      trap_CM_TransformedBiSphereTrace( &trace, start, end,
-        mins[ 0 ], maxs[ 0 ], cmodel, mask, origin );
+      radius = MAX( mins[ 0 ], maxs[ 0 ] );
+      traceMins[ i ] -= radius;
+      traceMaxs[ i ] += radius;
     }
-
-    if( trace.allsolid || trace.fraction < tr->fraction )
+    else
     {
-      trace.entityNum = ent->number;
+      if( mins )
+        traceMins[ i ] += mins[ i ];
 
-      if( tr->lateralFraction < trace.lateralFraction )
+      if( maxs )
+        traceMaxs[ i ] += maxs[ i ];
+    }
+  }
+
+  for( i = 0; i < numBModelSolids && !tr->allsolid; i++ )
+  {
+    CG_ClipMoveToSolid( bmodelSolids[ i ], traceMins, traceMaxs,
+      start, mins, maxs, end, skipNumber, mask, tr, collisionType );
+  }
+
+  x0 = (int)floor( traceMins[ 0 ] / SOLID_CELL_SIZE );
+  y0 = (int)floor( traceMins[ 1 ] / SOLID_CELL_SIZE );
+  x1 = (int)floor( traceMaxs[ 0 ] / SOLID_CELL_SIZE );
+  y1 = (int)floor( traceMaxs[ 1 ] / SOLID_CELL_SIZE );
+
+  if( ( x1 - x0 + 1 ) * ( y1 - y0 + 1 ) > MAX_SOLID_QUERY_CELLS )
+  {
+    // long traces are cheaper to test against everything
+    numFullSolidScans++;
+
+    for( i = 0; i < cg_numSolidEntities && !tr->allsolid; i++ )
+    {
+      CG_ClipMoveToSolid( i, traceMins, traceMaxs,
+        start, mins, maxs, end, skipNumber, mask, tr, collisionType );
+    }
+  }
+  else
+  {
+    for( x = x0; x <= x1; x++ )
+    {
+      for( y = y0; y <= y1; y++ )
       {
-        float oldLateralFraction = tr->lateralFraction;
-        *tr = trace;
-        tr->lateralFraction = oldLateralFraction;
+        for( link = solidCells[ CG_SolidCellHash( x, y ) ];
+             link >= 0 && !tr->allsolid; link = l->next )
+        {
+          l = &solidCellLinks[ link ];
+
+          if( l->x == x && l->y == y )
+          {
+            CG_ClipMoveToSolid( l->solid, traceMins, traceMaxs,
+              start, mins, maxs, end, skipNumber, mask, tr, collisionType );
+          }
+        }
       }
-      else
-        *tr = trace;
     }
-    else if( trace.startsolid )
-      tr->startsolid = qtrue;
+  }
 
-    if( tr->allsolid )
-      return;
+  //SUPAR HACK
+  //this causes a trace to collide with the local player
+  if( skipNumber == MAGIC_TRACE_HACK && !tr->allsolid )
+  {
+    CG_ClipMoveToEntity( &cg.predictedPlayerEntity, qtrue,
+      start, mins, maxs, end, mask, tr, collisionType );
   }
 }
 
@@ -256,18 +501,18 @@ int   CG_PointContents( const vec3_t point, int passEntityNum )
 
   contents = trap_CM_PointContents (point, 0);
 
-  for( i = 0; i < cg_numSolidEntities; i++ )
+  CG_BuildSolidGrid( );
+
+  // only bmodels have contents
+  for( i = 0; i < numBModelSolids; i++ )
   {
-    cent = cg_solidEntities[ i ];
+    cent = cg_solidEntities[ bmodelSolids[ i ] ];
 
     ent = &cent->currentState;
 
     if( ent->number == passEntityNum )
       continue;
 
-    if( ent->solid != SOLID_BMODEL ) // special value for bmodel
-      continue;
-
     cmodel = trap_CM_InlineModel( ent->modelindex );
 
     if( !cmodel )
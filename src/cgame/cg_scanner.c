@@ -54,53 +54,51 @@ void CG_UpdateEntityPositions( void )
   entityPositions.numAlienClients = 0;
   entityPositions.numHumanClients = 0;
 
-  for( i = 0; i < cg.snap->numEntities; i++ )
+  for( i = 0; i < cg.snapIndex->numBuildables[ BIT_ALIENS ]; i++ )
   {
-    cent = &cg_entities[ cg.snap->entities[ i ].number ];
-
-    if( cent->currentState.eType == ET_BUILDABLE )
-    {
-      //TA: add to list of item positions (for creep)
-      if( cent->currentState.modelindex2 == BIT_ALIENS )
-      {
-        VectorCopy( cent->lerpOrigin, entityPositions.alienBuildablePos[
-            entityPositions.numAlienBuildables ] );
-        entityPositions.alienBuildableTimes[
-            entityPositions.numAlienBuildables ] = cent->miscTime;
-
-        if( entityPositions.numAlienBuildables < MAX_GENTITIES )
-          entityPositions.numAlienBuildables++;
-      }
-      else if( cent->currentState.modelindex2 == BIT_HUMANS )
-      {
-        VectorCopy( cent->lerpOrigin, entityPositions.humanBuildablePos[
-            entityPositions.numHumanBuildables ] );
-
-        if( entityPositions.numHumanBuildables < MAX_GENTITIES )
-          entityPositions.numHumanBuildables++;
-      }
-    }
-    else if( cent->currentState.eType == ET_PLAYER )
-    {
-      int team = cent->currentState.misc & 0x00FF;
-
-      if( team == PTE_ALIENS )
-      {
-        VectorCopy( cent->lerpOrigin, entityPositions.alienClientPos[
-            entityPositions.numAlienClients ] );
-
-        if( entityPositions.numAlienClients < MAX_CLIENTS )
-          entityPositions.numAlienClients++;
-      }
-      else if( team == PTE_HUMANS )
-      {
-        VectorCopy( cent->lerpOrigin, entityPositions.humanClientPos[
-            entityPositions.numHumanClients ] );
-
-        if( entityPositions.numHumanClients < MAX_CLIENTS )
-          entityPositions.numHumanClients++;
-      }
-    }
+    cent = cg.snapIndex->buildables[ BIT_ALIENS ][ i ];
+
+    //TA: add to list of item positions (for creep)
+    VectorCopy( cent->lerpOrigin, entityPositions.alienBuildablePos[
+        entityPositions.numAlienBuildables ] );
+    entityPositions.alienBuildableTimes[
+        entityPositions.numAlienBuildables ] = cent->miscTime;
+
+    if( entityPositions.numAlienBuildables < MAX_GENTITIES )
+      entityPositions.numAlienBuildables++;
+  }
+
+  for( i = 0; i < cg.snapIndex->numBuildables[ BIT_HUMANS ]; i++ )
+  {
+    cent = cg.snapIndex->buildables[ BIT_HUMANS ][ i ];
+
+    VectorCopy( cent->lerpOrigin, entityPositions.humanBuildablePos[
+        entityPositions.numHumanBuildables ] );
+
+    if( entityPositions.numHumanBuildables < MAX_GENTITIES )
+      entityPositions.numHumanBuildables++;
+  }
+
+  for( i = 0; i < cg.snapIndex->numPlayers[ PTE_ALIENS ]; i++ )
+  {
+    cent = cg.snapIndex->players[ PTE_ALIENS ][ i ];
+
+    VectorCopy( cent->lerpOrigin, entityPositions.alienClientPos[
+        entityPositions.numAlienClients ] );
+
+    if( entityPositions.numAlienClients < MAX_CLIENTS )
+      entityPositions.numAlienClients++;
+  }
+
+  for( i = 0; i < cg.snapIndex->numPlayers[ PTE_HUMANS ]; i++ )
+  {
+    cent = cg.snapIndex->players[ PTE_HUMANS ][ i ];
+
+    VectorCopy( cent->lerpOrigin, entityPositions.humanClientPos[
+        entityPositions.numHumanClients ] );
+
+    if( entityPositions.numHumanClients < MAX_CLIENTS )
+      entityPositions.numHumanClients++;
   }
 }
 
@@ -72,6 +72,102 @@ static void CG_TransitionEntity( centity_t *cent )
 }
 
 
+static snapshotIndex_t snapshotIndexes[ 2 ];
+
+/*
+==================
+CG_BuildSnapshotIndex
+
+Sort the entities of a snapshot into typed lists, in one pass
+==================
+*/
+static snapshotIndex_t *CG_BuildSnapshotIndex( snapshot_t *snap )
+{
+  int             i, type, team;
+  int             runs[ BIT_NUM_TEAMS ], next[ BA_NUM_BUILDABLES ];
+  int             numBuildables = 0;
+  entityState_t   *buildables[ MAX_ENTITIES_IN_SNAPSHOT ];
+  centity_t       *cent;
+  entityState_t   *es;
+  snapshotIndex_t *index;
+
+  // don't write over the index of the snapshot still in use
+  if( cg.snapIndex == &snapshotIndexes[ 0 ] )
+    index = &snapshotIndexes[ 1 ];
+  else
+    index = &snapshotIndexes[ 0 ];
+
+  memset( index->numPlayers, 0, sizeof( index->numPlayers ) );
+  memset( index->numBuildablesOfType, 0, sizeof( index->numBuildablesOfType ) );
+  index->numMissiles = 0;
+  index->numSolids = 0;
+  index->numTriggers = 0;
+
+  for( i = 0; i < snap->numEntities; i++ )
+  {
+    es = &snap->entities[ i ];
+    cent = &cg_entities[ es->number ];
+
+    if( es->eType == ET_ITEM || es->eType == ET_PUSH_TRIGGER || es->eType == ET_TELEPORT_TRIGGER )
+    {
+      index->triggers[ index->numTriggers++ ] = cent;
+      continue;
+    }
+
+    if( es->solid && es->eType != ET_MISSILE )
+      index->solids[ index->numSolids++ ] = cent;
+
+    switch( es->eType )
+    {
+      case ET_PLAYER:
+        team = es->misc & 0x00FF;
+
+        if( team >= PTE_NONE && team < PTE_NUM_TEAMS &&
+            index->numPlayers[ team ] < MAX_CLIENTS )
+          index->players[ team ][ index->numPlayers[ team ]++ ] = cent;
+        break;
+
+      case ET_BUILDABLE:
+        if( es->modelindex > BA_NONE && es->modelindex < BA_NUM_BUILDABLES )
+        {
+          index->numBuildablesOfType[ es->modelindex ]++;
+          buildables[ numBuildables++ ] = es;
+        }
+        break;
+
+      case ET_MISSILE:
+        index->missiles[ index->numMissiles++ ] = cent;
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  // lay the types out one after another in their team's list
+  memset( runs, 0, sizeof( runs ) );
+  for( type = BA_NONE + 1; type < BA_NUM_BUILDABLES; type++ )
+  {
+    team = BG_FindTeamForBuildable( type );
+
+    index->firstBuildable[ type ] = runs[ team ];
+    runs[ team ] += index->numBuildablesOfType[ type ];
+  }
+
+  memcpy( next, index->firstBuildable, sizeof( next ) );
+  memcpy( index->numBuildables, runs, sizeof( index->numBuildables ) );
+
+  for( i = 0; i < numBuildables; i++ )
+  {
+    type = buildables[ i ]->modelindex;
+    team = BG_FindTeamForBuildable( type );
+
+    index->buildables[ team ][ next[ type ]++ ] = &cg_entities[ buildables[ i ]->number ];
+  }
+
+  return index;
+}
+
 /*
 ==================
 CG_SetInitialSnapshot
@@ -93,6 +189,9 @@ void CG_SetInitialSnapshot( snapshot_t *snap )
 
   BG_PlayerStateToEntityState( &snap->ps, &cg_entities[ snap->ps.clientNum ].currentState, qfalse );
 
+  cg.snapIndex = CG_BuildSnapshotIndex( snap );
+  cg.nextSnapIndex = NULL;
+
   // sort out solid entities
   CG_BuildSolidList( );
 
@@ -155,6 +254,7 @@ static void CG_TransitionSnapshot( void )
   // move nextSnap to snap and do the transitions
   oldFrame = cg.snap;
   cg.snap = cg.nextSnap;
+  cg.snapIndex = cg.nextSnapIndex;
 
   BG_PlayerStateToEntityState( &cg.snap->ps, &cg_entities[ cg.snap->ps.clientNum ].currentState, qfalse );
   cg_entities[ cg.snap->ps.clientNum ].interpolate = qfalse;
@@ -169,6 +269,10 @@ static void CG_TransitionSnapshot( void )
   }
 
   cg.nextSnap = NULL;
+  cg.nextSnapIndex = NULL;
+
+  // entities that weren't interpolated have jumped
+  CG_InvalidateSolidGrid( );
 
   // check for playerstate transition events
   if( oldFrame )
@@ -204,6 +308,7 @@ static void CG_SetNextSnap( snapshot_t *snap )
   centity_t     *cent;
 
   cg.nextSnap = snap;
+  cg.nextSnapIndex = CG_BuildSnapshotIndex( snap );
 
   BG_PlayerStateToEntityState( &snap->ps, &cg_entities[ snap->ps.clientNum ].nextState, qfalse );
   cg_entities[ cg.snap->ps.clientNum ].interpolate = qtrue;
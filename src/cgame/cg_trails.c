@@ -267,105 +267,51 @@ Allocates a trailBeamNode_t from a trailBeam_t's nodePool
 static trailBeamNode_t *CG_AllocateBeamNode( trailBeam_t *tb )
 {
   baseTrailBeam_t *btb = tb->class;
-  int             i;
   trailBeamNode_t *tbn;
 
-  for( i = 0; i < MAX_TRAIL_BEAM_NODES; i++ )
+  if( tb->freeNodes )
   {
-    tbn = &tb->nodePool[ i ];
-    if( !tbn->used )
-    {
-      tbn->timeLeft = btb->segmentTime;
-      tbn->prev = NULL;
-      tbn->next = NULL;
-      tbn->used = qtrue;
-      return tbn;
-    }
-  }
-
-  // no space left
-  return NULL;
-}
-
-/*
-===============
-CG_DestroyBeamNode
-
-Removes a node from a beam
-Returns the new head
-===============
-*/
-static trailBeamNode_t *CG_DestroyBeamNode( trailBeamNode_t *tbn )
-{
-  trailBeamNode_t *newHead = NULL;
-
-  if( tbn->prev )
-  {
-    if( tbn->next )
-    {
-      // node is in the middle
-      tbn->prev->next = tbn->next;
-      tbn->next->prev = tbn->prev;
-    }
-    else // node is at the back
-      tbn->prev->next = NULL;
-
-    // find the new head (shouldn't have changed)
-    newHead = tbn->prev;
-
-    while( newHead->prev )
-      newHead = newHead->prev;
+    tbn = tb->freeNodes;
+    tb->freeNodes = tbn->next;
   }
-  else if( tbn->next )
+  else if( tb->numPoolNodes < MAX_TRAIL_BEAM_NODES )
+    tbn = &tb->nodePool[ tb->numPoolNodes++ ];
+  else
   {
-    //node is at the front
-    tbn->next->prev = NULL;
-    newHead = tbn->next;
+    // no space left
+    return NULL;
   }
 
-  tbn->prev = NULL;
-  tbn->next = NULL;
-  tbn->used = qfalse;
+  memset( tbn, 0, sizeof( trailBeamNode_t ) );
+  tbn->timeLeft = btb->segmentTime;
 
-  return newHead;
+  return tbn;
 }
 
 /*
 ===============
-CG_FindLastBeamNode
+CG_DestroyBeamNode
 
-Returns the last beam node in a beam
+Removes a node from a beam and returns it to the beam's pool
 ===============
 */
-static trailBeamNode_t *CG_FindLastBeamNode( trailBeam_t *tb )
+static void CG_DestroyBeamNode( trailBeam_t *tb, trailBeamNode_t *tbn )
 {
-  trailBeamNode_t *i = tb->nodes;
-
-  while( i && i->next )
-    i = i->next;
-
-  return i;
-}
+  if( tbn->prev )
+    tbn->prev->next = tbn->next;
+  else
+    tb->nodes = tbn->next;
 
-/*
-===============
-CG_CountBeamNodes
+  if( tbn->next )
+    tbn->next->prev = tbn->prev;
+  else
+    tb->lastNode = tbn->prev;
 
-Returns the number of nodes in a beam
-===============
-*/
-static int CG_CountBeamNodes( trailBeam_t *tb )
-{
-  trailBeamNode_t *i = tb->nodes;
-  int             numNodes = 0;
-
-  while( i )
-  {
-    numNodes++;
-    i = i->next;
-  }
+  tb->numNodes--;
 
-  return numNodes;
+  tbn->prev = NULL;
+  tbn->next = tb->freeNodes;
+  tb->freeNodes = tbn;
 }
 
 /*
@@ -380,24 +326,19 @@ static trailBeamNode_t *CG_PrependBeamNode( trailBeam_t *tb )
 {
   trailBeamNode_t *i;
 
-  if( tb->nodes )
+  i = CG_AllocateBeamNode( tb );
+
+  if( i )
   {
-    // prepend another node
-    i = CG_AllocateBeamNode( tb );
+    i->next = tb->nodes;
 
-    if( i )
-    {
-      i->next = tb->nodes;
+    if( tb->nodes )
       tb->nodes->prev = i;
-      tb->nodes = i;
-    }
-  }
-  else //add first node
-  {
-    i = CG_AllocateBeamNode( tb );
+    else //first node
+      tb->lastNode = i;
 
-    if( i )
-      tb->nodes = i;
+    tb->nodes = i;
+    tb->numNodes++;
   }
 
   return i;
@@ -413,32 +354,42 @@ Returns the new node
 */
 static trailBeamNode_t *CG_AppendBeamNode( trailBeam_t *tb )
 {
-  trailBeamNode_t *last, *i;
+  trailBeamNode_t *i;
 
-  if( tb->nodes )
-  {
-    // append another node
-    last = CG_FindLastBeamNode( tb );
-    i = CG_AllocateBeamNode( tb );
+  i = CG_AllocateBeamNode( tb );
 
-    if( i )
-    {
-      last->next = i;
-      i->prev = last;
-      i->next = NULL;
-    }
-  }
-  else //add first node
+  if( i )
   {
-    i = CG_AllocateBeamNode( tb );
+    i->prev = tb->lastNode;
 
-    if( i )
+    if( tb->lastNode )
+      tb->lastNode->next = i;
+    else //first node
       tb->nodes = i;
+
+    tb->lastNode = i;
+    tb->numNodes++;
   }
 
   return i;
 }
 
+/*
+===============
+CG_DestroyTrailBeam
+
+Mark a beam as finished
+===============
+*/
+static void CG_DestroyTrailBeam( trailBeam_t *tb )
+{
+  tb->valid = qfalse;
+  tb->parent->numBeams--;
+
+  if( cg_debugTrails.integer >= 1 )
+    CG_Printf( "TB %s destroyed\n", tb->parent->class->name );
+}
+
 /*
 ===============
 CG_ApplyJitters
@@ -474,7 +425,7 @@ static void CG_ApplyJitters( trailBeam_t *tb )
   }
 
   start = tb->nodes;
-  end = CG_FindLastBeamNode( tb );
+  end = tb->lastNode;
 
   if( !btb->jitterAttachments )
   {
@@ -561,7 +512,7 @@ static void CG_UpdateBeam( trailBeam_t *tb )
   // first make sure this beam has enough nodes
   if( ts->destroyTime <= 0 )
   {
-    nodesToAdd = btb->numSegments - CG_CountBeamNodes( tb ) + 1;
+    nodesToAdd = btb->numSegments - tb->numNodes + 1;
 
     while( nodesToAdd-- )
     {
@@ -578,7 +529,7 @@ static void CG_UpdateBeam( trailBeam_t *tb )
     }
   }
 
-  numNodes = CG_CountBeamNodes( tb );
+  numNodes = tb->numNodes;
 
   for( i = tb->nodes; i; i = i->next )
     VectorCopy( i->refPosition, i->position );
@@ -590,7 +541,7 @@ static void CG_UpdateBeam( trailBeam_t *tb )
 
     if( ts->destroyTime > 0 && ( cg.time - ts->destroyTime ) >= btb->fadeOutTime )
     {
-      tb->valid = qfalse;
+      CG_DestroyTrailBeam( tb );
       return;
     }
 
@@ -614,7 +565,7 @@ static void CG_UpdateBeam( trailBeam_t *tb )
     // beam from one attachment
 
     // cull the trail tail
-    i = CG_FindLastBeamNode( tb );
+    i = tb->lastNode;
 
     if( i && i->timeLeft >= 0 )
     {
@@ -622,11 +573,11 @@ static void CG_UpdateBeam( trailBeam_t *tb )
 
       if( i->timeLeft < 0 )
       {
-        tb->nodes = CG_DestroyBeamNode( i );
+        CG_DestroyBeamNode( tb, i );
 
         if( !tb->nodes )
         {
-          tb->valid = qfalse;
+          CG_DestroyTrailBeam( tb );
           return;
         }
 
@@ -1247,6 +1198,7 @@ static trailBeam_t *CG_SpawnNewTrailBeam( baseTrailBeam_t *btb,
       tb->parent = ts;
 
       tb->valid = qtrue;
+      ts->numBeams++;
 
       if( cg_debugTrails.integer >= 1 )
         CG_Printf( "TB %s created\n", ts->class->name );
@@ -1361,29 +1313,19 @@ Destroy inactive trail systems
 */
 static void CG_GarbageCollectTrailSystems( void )
 {
-  int           i, j, count;
+  int           i;
   trailSystem_t *ts;
-  trailBeam_t   *tb;
   int           centNum;
 
   for( i = 0; i < MAX_TRAIL_SYSTEMS; i++ )
   {
     ts = &trailSystems[ i ];
-    count = 0;
 
     //don't bother checking already invalid systems
     if( !ts->valid )
       continue;
 
-    for( j = 0; j < MAX_TRAIL_BEAMS; j++ )
-    {
-      tb = &trailBeams[ j ];
-
-      if( tb->valid && tb->parent == ts )
-        count++;
-    }
-
-    if( !count )
+    if( !ts->numBeams )
       ts->valid = qfalse;
 
     //check systems where the parent cent has left the PVS
@@ -1422,7 +1364,7 @@ void CG_AddTrails( void )
 {
   int           i;
   trailBeam_t   *tb;
-  int           numTS = 0, numTB = 0;
+  int           numTS = 0, numTB = 0, numTBN = 0;
 
   //remove expired trail systems
   CG_GarbageCollectTrailSystems( );
@@ -1445,10 +1387,15 @@ void CG_AddTrails( void )
         numTS++;
 
     for( i = 0; i < MAX_TRAIL_BEAMS; i++ )
+    {
       if( trailBeams[ i ].valid )
+      {
         numTB++;
+        numTBN += trailBeams[ i ].numNodes;
+      }
+    }
 
-    CG_Printf( "TS: %d  TB: %d\n", numTS, numTB );
+    CG_Printf( "TS: %d  TB: %d  TBN: %d\n", numTS, numTB, numTBN );
   }
 }
 
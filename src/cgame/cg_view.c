@@ -1260,6 +1260,9 @@ void CG_DrawActiveFrame( int serverTime, stereoFrame_t stereoView, qboolean demo
   // this counter will be bumped for every valid scene we generate
   cg.clientFrame++;
 
+  // finish off some of the player models that were put off
+  CG_LoadDeferredClientModels( );
+
   // update cg.predictedPlayerState
   CG_PredictPlayerState( );
 
@@ -1344,7 +1344,7 @@ qboolean BG_FindReplaceableTestForBuildable( int bclass )
 BG_FindOverrideForBuildable
 ==============
 */
-static buildableAttributeOverrides_t *BG_FindOverrideForBuildable( int bclass )
+buildableAttributeOverrides_t *BG_FindOverrideForBuildable( int bclass )
 {
   return &bg_buildableOverrideList[ bclass ];
 }
@@ -2824,7 +2824,7 @@ int BG_FindCostOfClass( int pclass )
 BG_FindOverrideForClass
 ==============
 */
-static classAttributeOverrides_t *BG_FindOverrideForClass( int pclass )
+classAttributeOverrides_t *BG_FindOverrideForClass( int pclass )
 {
   return &bg_classOverrideList[ pclass ];
 }
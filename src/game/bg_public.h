@@ -1163,6 +1163,7 @@ int       BG_FindDCCTestForBuildable( int bclass );
 int       BG_FindUniqueTestForBuildable( int bclass );
 qboolean  BG_FindReplaceableTestForBuildable( int bclass );
 qboolean  BG_FindTransparentTestForBuildable( int bclass );
+buildableAttributeOverrides_t *BG_FindOverrideForBuildable( int bclass );
 void      BG_InitBuildableOverrides( void );
 
 int       BG_FindClassNumForName( char *name );
@@ -1197,6 +1198,7 @@ float     BG_FindBuildDistForClass( int pclass );
 int       BG_ClassCanEvolveFromTo( int fclass, int tclass, int credits, int num );
 int       BG_FindCostOfClass( int pclass );
 int       BG_FindValueOfClass( int pclass );
+classAttributeOverrides_t *BG_FindOverrideForClass( int pclass );
 void      BG_InitClassOverrides( void );
 
 int       BG_FindPriceForWeapon( int weapon );
@@ -276,8 +276,8 @@ void ClientImpacts( gentity_t *ent, pmove_t *pm )
     // if our movement is blocked by another player's real position,
     // don't use the unlagged position for them because they are 
     // blocking or server-side Pmove() from reaching it
-    if( other->client && other->client->unlaggedCalc.used )
-      other->client->unlaggedCalc.used = qfalse;
+    if( other->client )
+      level.unlaggedCalc.used[ other - g_entities ] = qfalse;
 
     //charge attack
     if( ent->client->ps.weapon == WP_ALEVEL4 &&
@@ -1143,8 +1143,8 @@ void SendPendingPredictableEvents( playerState_t *ps )
 ==============
  G_UnlaggedStore
 
- Called on every server frame.  Stores position data for the client at that 
- into client->unlaggedHist[] and the time into level.unlaggedTimes[].  
+ Called on every server frame.  Stores position data for all clients at that 
+ time into level.unlaggedHist[] and the time into level.unlaggedTimes[].  
  This data is used by G_UnlaggedCalc()
 ==============
 */
@@ -1152,7 +1152,7 @@ void G_UnlaggedStore( void )
 {
   int i = 0;
   gentity_t *ent;
-  unlagged_t *save;
+  unlaggedMarker_t *save;
   
   if( !g_unlagged.integer )
     return;
@@ -1161,20 +1161,23 @@ void G_UnlaggedStore( void )
     level.unlaggedIndex = 0;
 
   level.unlaggedTimes[ level.unlaggedIndex ] = level.time;
+
+  // the marker times have moved on, so any cached resolutions are stale
+  memset( level.unlaggedResolve, 0, sizeof( level.unlaggedResolve ) );
+
+  save = &level.unlaggedHist[ level.unlaggedIndex ];
+  memset( save->used, 0, sizeof( save->used ) );
  
-  for( i = 0; i < level.maxclients; i++ )
+  for( i = 0, ent = g_entities; i < level.maxclients; i++, ent++ )
   {
-    ent = &g_entities[ i ];
-    save = &ent->client->unlaggedHist[ level.unlaggedIndex ];
-    save->used = qfalse; 
     if( !ent->r.linked || !( ent->r.contents & CONTENTS_BODY ) )
       continue;
     if( ent->client->pers.connected != CON_CONNECTED )
       continue; 
-    VectorCopy( ent->r.mins, save->mins );
-    VectorCopy( ent->r.maxs, save->maxs );
-    VectorCopy( ent->s.pos.trBase, save->origin );
-    save->used = qtrue;
+    VectorCopy( ent->r.mins, save->mins[ i ] );
+    VectorCopy( ent->r.maxs, save->maxs[ i ] );
+    VectorCopy( ent->s.pos.trBase, save->origin[ i ] );
+    save->used[ i ] = qtrue;
   }
 }
 
@@ -1189,91 +1192,231 @@ void G_UnlaggedStore( void )
 void G_UnlaggedClear( gentity_t *ent )
 {
   int i;
+  int clientNum = ent - g_entities;
 
   for( i = 0; i < MAX_UNLAGGED_MARKERS; i++ )
-    ent->client->unlaggedHist[ i ].used = qfalse;
+    level.unlaggedHist[ i ].used[ clientNum ] = qfalse;
 }
 
 /*
 ==============
- G_UnlaggedCalc
+ G_UnlaggedResolveTime
 
- Loops through all active clients and calculates their predicted position
- for time then stores it in client->unlaggedCalc
+ Find the pair of markers in a ring of marker times that time falls
+ between, and how far between them it is
 ==============
 */
-void G_UnlaggedCalc( int time, gentity_t *rewindEnt )
+static void G_UnlaggedResolveTime( const int *times, int newest, int time,
+                                   unlaggedResolve_t *r )
 {
-  int i = 0;
-  gentity_t *ent;
+  int i;
   int startIndex;
-  int stopIndex;
-  int frameMsec;
-  float lerp;
+  int stopIndex = newest;
 
-  if( !g_unlagged.integer )
-    return;
- 
-  // clear any calculated values from a previous run
-  for( i = 0; i < level.maxclients; i++ )
-  {
-    ent = &g_entities[ i ];
-    ent->client->unlaggedCalc.used = qfalse;
-  }
+  r->valid = qtrue;
+  r->time = time;
 
   // client is on the current frame, no need for unlagged
-  if( level.unlaggedTimes[ level.unlaggedIndex ] <= time )
+  r->rewind = ( times[ newest ] > time );
+  if( !r->rewind )
     return;
 
-  startIndex = level.unlaggedIndex;
+  startIndex = newest;
   for( i = 1; i < MAX_UNLAGGED_MARKERS; i++ )
   {
     stopIndex = startIndex;
     if( --startIndex < 0 )
       startIndex = MAX_UNLAGGED_MARKERS - 1;
-    if( level.unlaggedTimes[ startIndex ] <= time )
+    if( times[ startIndex ] <= time )
       break;
   }
+
+  r->startIndex = startIndex;
+  r->stopIndex = stopIndex;
+
   if( i == MAX_UNLAGGED_MARKERS )
   {
     // if we searched all markers and the oldest one still isn't old enough
     // just use the oldest marker with no lerping
-    lerp = 0.0f;
+    r->lerp = 0.0f;
   }
   else
   {
     // lerp between two markers
-    frameMsec = level.unlaggedTimes[ stopIndex ] - level.unlaggedTimes[ startIndex ];
-    lerp = ( float )( time - level.unlaggedTimes[ startIndex ] ) / ( float )frameMsec;
+    r->lerp = ( float )( time - times[ startIndex ] ) /
+              ( float )( times[ stopIndex ] - times[ startIndex ] );
   }
-  
-  for( i = 0; i < level.maxclients; i++ )
+}
+
+/*
+==============
+ G_UnlaggedLookup
+
+ Resolve time against a ring of marker times, reusing the result from
+ cache if the same time has been resolved since the cache was cleared
+==============
+*/
+static unlaggedResolve_t *G_UnlaggedLookup( unlaggedResolve_t *cache,
+                                            const int *times, int newest,
+                                            int time, qboolean *hit )
+{
+  unlaggedResolve_t *r = &cache[ time & ( UNLAGGED_RESOLVE_CACHE - 1 ) ];
+
+  *hit = ( r->valid && r->time == time );
+  if( !*hit )
+    G_UnlaggedResolveTime( times, newest, time, r );
+
+  return r;
+}
+
+/*
+==============
+ G_UnlaggedLerpMarkers
+
+ Lerp every client between two markers into out.  Positions are lerped
+ unconditionally so the loop has no branches, used[] says which are valid
+==============
+*/
+static void G_UnlaggedLerpMarkers( const unlaggedMarker_t *start,
+                                   const unlaggedMarker_t *stop, float lerp,
+                                   int numClients, unlaggedMarker_t *out )
+{
+  int i;
+
+  for( i = 0; i < numClients; i++ )
   {
-    ent = &g_entities[ i ];
-    if( ent == rewindEnt )
-      continue;
-    if( !ent->r.linked || !( ent->r.contents & CONTENTS_BODY ) )
-      continue;
-    if( ent->client->pers.connected != CON_CONNECTED )
-      continue;
-    if( !ent->client->unlaggedHist[ startIndex ].used )
-      continue;
-    if( !ent->client->unlaggedHist[ stopIndex ].used )
+    VectorLerp( lerp, start->mins[ i ], stop->mins[ i ], out->mins[ i ] );
+    VectorLerp( lerp, start->maxs[ i ], stop->maxs[ i ], out->maxs[ i ] );
+    VectorLerp( lerp, start->origin[ i ], stop->origin[ i ], out->origin[ i ] );
+    out->used[ i ] = ( start->used[ i ] && stop->used[ i ] );
+  }
+}
+
+/*
+==============
+ G_UnlaggedCalc
+
+ Loops through all active clients and calculates their predicted position
+ for time then stores it in level.unlaggedCalc
+==============
+*/
+void G_UnlaggedCalc( int time, gentity_t *rewindEnt )
+{
+  int i = 0;
+  gentity_t *ent;
+  unlaggedResolve_t *r;
+  qboolean hit;
+
+  if( !g_unlagged.integer )
+    return;
+
+  r = G_UnlaggedLookup( level.unlaggedResolve, level.unlaggedTimes,
+                        level.unlaggedIndex, time, &hit );
+
+  if( !r->rewind )
+  {
+    // clear any calculated values from a previous run
+    memset( level.unlaggedCalc.used, 0, sizeof( level.unlaggedCalc.used ) );
+    return;
+  }
+
+  G_UnlaggedLerpMarkers( &level.unlaggedHist[ r->startIndex ],
+    &level.unlaggedHist[ r->stopIndex ], r->lerp, level.maxclients,
+    &level.unlaggedCalc );
+
+  // drop anyone who has become unrewindable since the markers were stored
+  for( i = 0, ent = g_entities; i < level.maxclients; i++, ent++ )
+  {
+    if( !level.unlaggedCalc.used[ i ] )
       continue;
+    if( ent == rewindEnt || !ent->r.linked ||
+        !( ent->r.contents & CONTENTS_BODY ) ||
+        ent->client->pers.connected != CON_CONNECTED )
+      level.unlaggedCalc.used[ i ] = qfalse;
+  }
+}
+
+#define UNLAGGED_BENCH_MARKERS  8
+#define UNLAGGED_BENCH_FRAMES   100
+
+static unlaggedMarker_t unlaggedBenchHist[ UNLAGGED_BENCH_MARKERS ];
+static unlaggedMarker_t unlaggedBenchCalc;
+
+/*
+==============
+ G_UnlaggedBenchmark
 
-    // between two unlagged markers
-    VectorLerp( lerp, ent->client->unlaggedHist[ startIndex ].mins,
-      ent->client->unlaggedHist[ stopIndex ].mins,
-      ent->client->unlaggedCalc.mins );
-    VectorLerp( lerp, ent->client->unlaggedHist[ startIndex ].maxs,
-      ent->client->unlaggedHist[ stopIndex ].maxs,
-      ent->client->unlaggedCalc.maxs );
-    VectorLerp( lerp, ent->client->unlaggedHist[ startIndex ].origin,
-      ent->client->unlaggedHist[ stopIndex ].origin,
-      ent->client->unlaggedCalc.origin );
-
-    ent->client->unlaggedCalc.used = qtrue;
+ Time the rewind of MAX_CLIENTS synthetic clients.  Each simulated frame
+ every client fires shots/UNLAGGED_BENCH_FRAMES shots at a time given by
+ its own ping, which is how G_UnlaggedCalc() is driven in a full game
+==============
+*/
+void G_UnlaggedBenchmark( int shots )
+{
+  int               times[ MAX_UNLAGGED_MARKERS ];
+  unlaggedResolve_t cache[ UNLAGGED_RESOLVE_CACHE ];
+  unlaggedResolve_t *r;
+  int               i, j, frame, newest = MAX_UNLAGGED_MARKERS - 1;
+  int               shotsPerFrame, fired = 0, hits = 0;
+  int               start, msec;
+  qboolean          hit;
+
+  if( shots < UNLAGGED_BENCH_FRAMES * MAX_CLIENTS )
+    shots = UNLAGGED_BENCH_FRAMES * MAX_CLIENTS;
+
+  shotsPerFrame = shots / UNLAGGED_BENCH_FRAMES;
+
+  for( i = 0; i < UNLAGGED_BENCH_MARKERS; i++ )
+  {
+    for( j = 0; j < MAX_CLIENTS; j++ )
+    {
+      VectorSet( unlaggedBenchHist[ i ].origin[ j ], j * 64.0f, i * 8.0f, 0.0f );
+      VectorSet( unlaggedBenchHist[ i ].mins[ j ], -15.0f, -15.0f, -24.0f );
+      VectorSet( unlaggedBenchHist[ i ].maxs[ j ], 15.0f, 15.0f, 32.0f );
+      unlaggedBenchHist[ i ].used[ j ] = qtrue;
+    }
+  }
+
+  for( i = 0; i < MAX_UNLAGGED_MARKERS; i++ )
+    times[ i ] = ( i - MAX_UNLAGGED_MARKERS ) * 50;
+
+  start = trap_Milliseconds( );
+
+  for( frame = 0; frame < UNLAGGED_BENCH_FRAMES; frame++ )
+  {
+    if( ++newest >= MAX_UNLAGGED_MARKERS )
+      newest = 0;
+    times[ newest ] = frame * 50;
+    memset( cache, 0, sizeof( cache ) );
+
+    for( i = 0; i < shotsPerFrame; i++ )
+    {
+      // pings between 0 and 315ms, one per client
+      int time = times[ newest ] - 5 * ( i % MAX_CLIENTS ) - 1;
+
+      r = G_UnlaggedLookup( cache, times, newest, time, &hit );
+      if( hit )
+        hits++;
+
+      if( r->rewind )
+      {
+        G_UnlaggedLerpMarkers(
+          &unlaggedBenchHist[ r->startIndex % UNLAGGED_BENCH_MARKERS ],
+          &unlaggedBenchHist[ r->stopIndex % UNLAGGED_BENCH_MARKERS ],
+          r->lerp, MAX_CLIENTS, &unlaggedBenchCalc );
+      }
+
+      fired++;
+    }
   }
+
+  msec = trap_Milliseconds( ) - start;
+
+  G_Printf( "unlagged: %d shots against %d clients in %dms", fired,
+    MAX_CLIENTS, msec );
+  if( msec > 0 )
+    G_Printf( " (%d shots/sec)", (int)( fired * 1000.0f / msec ) );
+  G_Printf( ", %d of %d resolutions from cache\n", hits, fired );
 }
 
 /*
@@ -1322,7 +1465,7 @@ void G_UnlaggedOn( gentity_t *attacker, vec3_t muzzle, float range )
 {
   int i = 0;
   gentity_t *ent;
-  unlagged_t *calc;
+  unlaggedMarker_t *calc = &level.unlaggedCalc;
   
   if( !g_unlagged.integer )
     return;
@@ -1333,23 +1476,22 @@ void G_UnlaggedOn( gentity_t *attacker, vec3_t muzzle, float range )
   for( i = 0; i < level.maxclients; i++ )
   {
     ent = &g_entities[ i ];
-    calc = &ent->client->unlaggedCalc;
 
-    if( !calc->used )
+    if( !calc->used[ i ] )
       continue;
     if( ent->client->unlaggedBackup.used )
       continue;
     if( !ent->r.linked || !( ent->r.contents & CONTENTS_BODY ) )
       continue;
-    if( VectorCompare( ent->r.currentOrigin, calc->origin ) )
+    if( VectorCompare( ent->r.currentOrigin, calc->origin[ i ] ) )
       continue;
     if( muzzle )
     {
-      float r1 = Distance( calc->origin, calc->maxs );
-      float r2 = Distance( calc->origin, calc->mins );
+      float r1 = Distance( calc->origin[ i ], calc->maxs[ i ] );
+      float r2 = Distance( calc->origin[ i ], calc->mins[ i ] );
       float maxRadius = ( r1 > r2 ) ? r1 : r2;
 
-      if( Distance( muzzle, calc->origin ) > range + maxRadius )
+      if( Distance( muzzle, calc->origin[ i ] ) > range + maxRadius )
         continue; 
     }
 
@@ -1360,9 +1502,9 @@ void G_UnlaggedOn( gentity_t *attacker, vec3_t muzzle, float range )
     ent->client->unlaggedBackup.used = qtrue;
 
     // move the client to the calculated unlagged position
-    VectorCopy( calc->mins, ent->r.mins );
-    VectorCopy( calc->maxs, ent->r.maxs );
-    VectorCopy( calc->origin, ent->r.currentOrigin );
+    VectorCopy( calc->mins[ i ], ent->r.mins );
+    VectorCopy( calc->maxs[ i ], ent->r.maxs );
+    VectorCopy( calc->origin[ i ], ent->r.currentOrigin );
     trap_LinkEntity( ent );
   }
 }
@@ -1390,7 +1532,8 @@ void G_UnlaggedOn( gentity_t *attacker, vec3_t muzzle, float range )
 */
 static void G_UnlaggedDetectCollisions( gentity_t *ent )
 {
-  unlagged_t *calc;
+  unlaggedMarker_t *calc = &level.unlaggedCalc;
+  int clientNum = ent - g_entities;
   trace_t tr;
   float r1, r2;
   float range;
@@ -1400,8 +1543,6 @@ static void G_UnlaggedDetectCollisions( gentity_t *ent )
   if( !ent->client->pers.useUnlagged )
     return;
 
-  calc = &ent->client->unlaggedCalc;
-
   // if the client isn't moving, this is not necessary
   if( VectorCompare( ent->client->oldOrigin, ent->client->ps.origin ) )
     return;
@@ -1410,8 +1551,8 @@ static void G_UnlaggedDetectCollisions( gentity_t *ent )
 
   // increase the range by the player's largest possible radius since it's
   // the players bounding box that collides, not their origin
-  r1 = Distance( calc->origin, calc->mins );
-  r2 = Distance( calc->origin, calc->maxs );
+  r1 = Distance( calc->origin[ clientNum ], calc->mins[ clientNum ] );
+  r2 = Distance( calc->origin[ clientNum ], calc->maxs[ clientNum ] );
   range += ( r1 > r2 ) ? r1 : r2;
 
   G_UnlaggedOn( ent, ent->client->oldOrigin, range );
@@ -1419,7 +1560,7 @@ static void G_UnlaggedDetectCollisions( gentity_t *ent )
   trap_Trace(&tr, ent->client->oldOrigin, ent->r.mins, ent->r.maxs,
     ent->client->ps.origin, ent->s.number,  MASK_PLAYERSOLID );
   if( tr.entityNum >= 0 && tr.entityNum < MAX_CLIENTS )
-    g_entities[ tr.entityNum ].client->unlaggedCalc.used = qfalse; 
+    calc->used[ tr.entityNum ] = qfalse;
 
   G_UnlaggedOff( );
 }
@@ -1840,6 +1981,7 @@ void ClientThink_real( gentity_t *ent )
         //hovel is empty
         G_SetBuildableAnim( hovel, BANIM_ATTACK2, qfalse );
         hovel->active = qfalse;
+        level.buildableGeneration++;
       }
       else
       {
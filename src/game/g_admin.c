@@ -1602,6 +1602,7 @@ qboolean G_admin_cmd_check( gentity_t *ent, qboolean say )
     if( G_admin_permission( ent, g_admin_commands[ i ]->flag ) )
     {
       trap_SendConsoleCommand( EXEC_APPEND, g_admin_commands[ i ]->exec );
+      G_RequestCvarUpdate( );
       admin_log( ent, cmd, skip );
       G_admin_adminlog_log( ent, cmd, NULL, skip, qtrue );
     }
@@ -1635,6 +1636,7 @@ qboolean G_admin_cmd_check( gentity_t *ent, qboolean say )
         }
       }
       g_admin_cmds[ i ].handler( ent, skip );
+      G_RequestCvarUpdate( );
       admin_log( ent, cmd, skip );
       G_admin_adminlog_log( ent, cmd, NULL, skip, qtrue );
     }
@@ -1837,6 +1839,196 @@ void G_admin_namelog_update( gclient_t *client, qboolean disconnect )
   g_admin_namelog[ i ] = namelog;
 }
 
+static qboolean admin_readcache_records( fileHandle_t f, void **records,
+  int maxRecords, int size, int *count, int *remaining )
+{
+  int i;
+
+  if( !G_ReadConfigCacheData( f, count, sizeof( int ), remaining ) ||
+      *count < 0 || *count > maxRecords )
+  {
+    *count = 0;
+    return qfalse;
+  }
+
+  for( i = 0; i < *count; i++ )
+  {
+    records[ i ] = G_Alloc( size );
+    if( !G_ReadConfigCacheData( f, records[ i ], size, remaining ) )
+      return qfalse;
+  }
+  return qtrue;
+}
+
+// is this admin config line a seen stamp?
+static qboolean admin_seenline( const char *line )
+{
+  while( *line == ' ' || *line == '\t' )
+    line++;
+
+  return !Q_stricmpn( line, "seen", 4 ) &&
+         ( line[ 4 ] == ' ' || line[ 4 ] == '\t' || line[ 4 ] == '=' );
+}
+
+// hash the admin config for the cache, leaving out the seen stamps that
+// G_admin_seen_update changes whenever an admin connects, so that the
+// rewrite at the end of every map doesn't make the cache stale
+static unsigned int admin_cachekey( const char *cnf )
+{
+  unsigned int hash = CONFIG_HASH_INIT;
+  const char *end;
+
+  while( *cnf )
+  {
+    end = strchr( cnf, '\n' );
+    if( !end )
+      end = cnf + strlen( cnf );
+    else
+      end++;
+
+    if( !admin_seenline( cnf ) )
+      hash = G_HashConfigData( hash, cnf, end - cnf );
+    cnf = end;
+  }
+  return hash;
+}
+
+// the cache was built from a config that may have had different seen
+// stamps, so take them from the config itself. Returns qfalse if the
+// [admin] sections don't line up with the cached admins
+static qboolean admin_readcache_seen( const char *cnf, int ac )
+{
+  const char *line, *end;
+  int i;
+  qboolean admin_open = qfalse;
+
+  for( i = 0; i < ac; i++ )
+    g_admin_admins[ i ]->seen = 0;
+
+  i = -1;
+  for( line = cnf; *line; line = end )
+  {
+    end = strchr( line, '\n' );
+    if( !end )
+      end = line + strlen( line );
+    else
+      end++;
+
+    while( *line == ' ' || *line == '\t' )
+      line++;
+
+    if( *line == '[' )
+    {
+      admin_open = !Q_stricmpn( line, "[admin]", 7 );
+      if( admin_open && ++i >= ac )
+        return qfalse;
+    }
+    else if( admin_open && admin_seenline( line ) )
+    {
+      line += 4;
+      while( *line == ' ' || *line == '\t' || *line == '=' )
+        line++;
+      g_admin_admins[ i ]->seen = atoi( line );
+    }
+  }
+  return i + 1 == ac;
+}
+
+// load the parsed admin config saved by admin_writecache, if g_admin hasn't
+// changed since other than in its seen stamps
+static qboolean admin_readcache( const char *cnf,
+  int *lc, int *ac, int *bc, int *cc )
+{
+  configSources_t sources;
+  fileHandle_t f;
+  int len;
+  unsigned int key;
+  qboolean ok;
+
+  // g_admin is checked by admin_cachekey rather than as a cache source
+  sources.numSources = 0;
+  len = G_ReadConfigCache( "admin.bin", &sources, &f );
+  if( len < 0 )
+    return qfalse;
+
+  ok = G_ReadConfigCacheData( f, &key, sizeof( key ), &len ) &&
+       key == admin_cachekey( cnf ) &&
+       admin_readcache_records( f, (void **)g_admin_levels, MAX_ADMIN_LEVELS,
+         sizeof( g_admin_level_t ), lc, &len ) &&
+       admin_readcache_records( f, (void **)g_admin_admins, MAX_ADMIN_ADMINS,
+         sizeof( g_admin_admin_t ), ac, &len ) &&
+       admin_readcache_records( f, (void **)g_admin_bans, MAX_ADMIN_BANS,
+         sizeof( g_admin_ban_t ), bc, &len ) &&
+       admin_readcache_records( f, (void **)g_admin_commands, MAX_ADMIN_COMMANDS,
+         sizeof( g_admin_command_t ), cc, &len ) &&
+       len == 0 &&
+       admin_readcache_seen( cnf, *ac );
+  trap_FS_FCloseFile( f );
+
+  if( !ok )
+  {
+    G_admin_cleanup();
+    *lc = *ac = *bc = *cc = 0;
+  }
+  return ok;
+}
+
+static void admin_writecache( const char *cnf,
+  int lc, int ac, int bc, int cc )
+{
+  configSources_t sources;
+  fileHandle_t f;
+  unsigned int key;
+  int i;
+
+  sources.numSources = 0;
+  if( !( f = G_WriteConfigCache( "admin.bin", &sources ) ) )
+    return;
+
+  key = admin_cachekey( cnf );
+  trap_FS_Write( &key, sizeof( key ), f );
+  trap_FS_Write( &lc, sizeof( int ), f );
+  for( i = 0; i < lc; i++ )
+    trap_FS_Write( g_admin_levels[ i ], sizeof( g_admin_level_t ), f );
+  trap_FS_Write( &ac, sizeof( int ), f );
+  for( i = 0; i < ac; i++ )
+    trap_FS_Write( g_admin_admins[ i ], sizeof( g_admin_admin_t ), f );
+  trap_FS_Write( &bc, sizeof( int ), f );
+  for( i = 0; i < bc; i++ )
+    trap_FS_Write( g_admin_bans[ i ], sizeof( g_admin_ban_t ), f );
+  trap_FS_Write( &cc, sizeof( int ), f );
+  for( i = 0; i < cc; i++ )
+    trap_FS_Write( g_admin_commands[ i ], sizeof( g_admin_command_t ), f );
+  trap_FS_FCloseFile( f );
+}
+
+static void admin_readconfig_done( gentity_t *ent,
+  int lc, int ac, int bc, int cc )
+{
+  int i;
+
+  ADMP( va( "^3!readconfig: ^7loaded %d levels, %d admins, %d bans, %d commands\n",
+          lc, ac, bc, cc ) );
+  if( lc == 0 )
+    admin_default_levels();
+  else
+  {
+    char n[ MAX_NAME_LENGTH ] = {""};
+ 
+    // max printable name length for formatting 
+    for( i = 0; i < MAX_ADMIN_LEVELS && g_admin_levels[ i ]; i++ )
+    {
+      G_DecolorString( g_admin_levels[ i ]->name, n );
+      if( strlen( n ) > admin_level_maxname )
+        admin_level_maxname = strlen( n );
+    }
+  }
+  // reset adminLevel
+  for( i = 0; i < level.maxclients; i++ )
+    if( level.clients[ i ].pers.connected != CON_DISCONNECTED )
+      level.clients[ i ].pers.adminLevel = G_admin_level( &g_entities[ i ] );
+}
+
 qboolean G_admin_readconfig( gentity_t *ent, int skiparg )
 {
   g_admin_level_t * l = NULL;
@@ -1849,7 +2041,6 @@ qboolean G_admin_readconfig( gentity_t *ent, int skiparg )
   char *cnf, *cnf2;
   char *t;
   qboolean level_open, admin_open, ban_open, command_open;
-  int i;
 
   admin_level_maxname = 0; // reset this or all sorts of weird shit happens
 
@@ -1871,12 +2062,20 @@ qboolean G_admin_readconfig( gentity_t *ent, int skiparg )
     admin_default_levels();
     return qfalse;
   }
+
   cnf = G_Alloc( len + 1 );
   cnf2 = cnf;
   trap_FS_Read( cnf, len, f );
   *( cnf + len ) = '\0';
   trap_FS_FCloseFile( f );
 
+  if( admin_readcache( cnf2, &lc, &ac, &bc, &cc ) )
+  {
+    G_Free( cnf2 );
+    admin_readconfig_done( ent, lc, ac, bc, cc );
+    return qtrue;
+  }
+
   t = COM_Parse( &cnf );
   level_open = admin_open = ban_open = command_open = qfalse;
   while( *t )
@@ -2092,27 +2291,9 @@ qboolean G_admin_readconfig( gentity_t *ent, int skiparg )
     g_admin_bans[ bc++ ] = b;
   if( command_open )
     g_admin_commands[ cc++ ] = c;
+  admin_writecache( cnf2, lc, ac, bc, cc );
   G_Free( cnf2 );
-  ADMP( va( "^3!readconfig: ^7loaded %d levels, %d admins, %d bans, %d commands\n",
-          lc, ac, bc, cc ) );
-  if( lc == 0 )
-    admin_default_levels();
-  else
-  {
-    char n[ MAX_NAME_LENGTH ] = {""};
- 
-    // max printable name length for formatting 
-    for( i = 0; i < MAX_ADMIN_LEVELS && g_admin_levels[ i ]; i++ )
-    {
-      G_DecolorString( g_admin_levels[ i ]->name, n );
-      if( strlen( n ) > admin_level_maxname )
-        admin_level_maxname = strlen( n );
-    }
-  }
-  // reset adminLevel
-  for( i = 0; i < level.maxclients; i++ )
-    if( level.clients[ i ].pers.connected != CON_DISCONNECTED )
-      level.clients[ i ].pers.adminLevel = G_admin_level( &g_entities[ i ] );
+  admin_readconfig_done( ent, lc, ac, bc, cc );
   return qtrue;
 }
 
@@ -5350,7 +5531,7 @@ qboolean G_admin_listrotation( gentity_t *ent, int skiparg )
           statusColor = 3;
           status = "current slot";
         }
-        else if ( !G_MapExists( mapRotations.rotations[ i ].maps[ j ].name ) )
+        else if ( !mapRotations.rotations[ i ].maps[ j ].exists )
         {
           statusColor = 1;
           status = "missing";
@@ -6450,6 +6631,7 @@ qboolean G_admin_nobuild( gentity_t *ent, int skiparg )
 	level.nbMarkers[ tmp ].Marker->noBuild.isNB = qfalse;
 	level.nbMarkers[ tmp ].Marker->noBuild.Area = 0.0f;
 	level.nbMarkers[ tmp ].Marker->noBuild.Height = 0.0f;
+	level.buildableGeneration++;
 	
 	// Free the entitiy and null it out...
 	G_FreeEntity( level.nbMarkers[ tmp ].Marker );
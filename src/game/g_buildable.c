@@ -551,7 +551,7 @@ void A_CreepRecede( gentity_t *self )
 
   //creep is still receeding
   if( ( self->timestamp + 10000 ) > level.time )
-    self->nextthink = level.time + 500;
+    G_SetNextThink( self, level.time + 500 );
   else //creep has died
     G_FreeEntity( self );
 }
@@ -593,7 +593,7 @@ void ASpawn_Melt( gentity_t *self )
 
   //not dead yet
   if( ( self->timestamp + 10000 ) > level.time )
-    self->nextthink = level.time + 500;
+    G_SetNextThink( self, level.time + 500 );
   else //dead now
     G_FreeEntity( self );
 }
@@ -620,7 +620,7 @@ void ASpawn_Blast( gentity_t *self )
   G_AddEvent( self, EV_ALIEN_BUILDABLE_EXPLOSION, DirToByte( dir ) );
   self->timestamp = level.time;
   self->think = ASpawn_Melt;
-  self->nextthink = level.time + 500; //wait .5 seconds before damaging others
+  G_SetNextThink( self, level.time + 500 ); //wait .5 seconds before damaging others
 
   self->r.contents = 0;    //stop collisions...
   trap_LinkEntity( self ); //...requires a relink
@@ -658,12 +658,13 @@ void ASpawn_Die( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int
   G_SetIdleBuildableAnim( self, BANIM_DESTROYED );
 
   self->die = nullDieFunction;
+  G_AccountBuildable( self );
   self->think = ASpawn_Blast;
 
   if( self->spawned )
-    self->nextthink = level.time + 5000;
+    G_SetNextThink( self, level.time + 5000 );
   else
-    self->nextthink = level.time; //blast immediately
+    G_SetNextThink( self, level.time ); //blast immediately
 
   self->s.eFlags &= ~EF_FIRING; //prevent any firing effects
 
@@ -776,7 +777,7 @@ void ASpawn_Think( gentity_t *self )
 
   G_CreepSlow( self );
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 }
 
 /*
@@ -899,7 +900,7 @@ void AOvermind_Think( gentity_t *self )
 
   G_CreepSlow( self );
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 }
 
 
@@ -950,7 +951,7 @@ void ABarricade_Blast( gentity_t *self )
   G_AddEvent( self, EV_ALIEN_BUILDABLE_EXPLOSION, DirToByte( dir ) );
   self->timestamp = level.time;
   self->think = A_CreepRecede;
-  self->nextthink = level.time + 500; //wait .5 seconds before damaging others
+  G_SetNextThink( self, level.time + 500 ); //wait .5 seconds before damaging others
 
   self->r.contents = 0;    //stop collisions...
   trap_LinkEntity( self ); //...requires a relink
@@ -1064,13 +1065,14 @@ void AGeneric_Die( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, i
   G_SetIdleBuildableAnim( self, BANIM_DESTROYED );
 
   self->die = nullDieFunction;
+  G_AccountBuildable( self );
   self->think = ABarricade_Blast;
   self->s.eFlags &= ~EF_FIRING; //prevent any firing effects
 
   if( self->spawned )
-    self->nextthink = level.time + 5000;
+    G_SetNextThink( self, level.time + 5000 );
   else
-    self->nextthink = level.time; //blast immediately
+    G_SetNextThink( self, level.time ); //blast immediately
 
   if( attacker && attacker->client )
   {
@@ -1134,7 +1136,7 @@ void ABarricade_Think( gentity_t *self )
 
   G_CreepSlow( self );
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 
   // Shrink if unpowered
   ABarricade_Shrink( self, !self->powered );
@@ -1206,7 +1208,7 @@ void AAcidTube_Damage( gentity_t *self )
 
   G_CreepSlow( self );
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 }
 
 /*
@@ -1256,7 +1258,7 @@ void AAcidTube_Think( gentity_t *self )
           continue;
         self->timestamp = level.time;
         self->think = AAcidTube_Damage;
-        self->nextthink = level.time + 100;
+        G_SetNextThink( self, level.time + 100 );
         G_SetBuildableAnim( self, BANIM_ATTACK1, qfalse );
         return;
       }
@@ -1265,7 +1267,7 @@ void AAcidTube_Think( gentity_t *self )
 
   G_CreepSlow( self );
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 }
 
 
@@ -1294,7 +1296,7 @@ void AHive_Think( gentity_t *self )
 
   self->powered = G_IsOvermindBuilt( );
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 
   VectorAdd( self->s.origin, range, maxs );
   VectorSubtract( self->s.origin, range, mins );
@@ -1479,6 +1481,7 @@ void AHovel_Use( gentity_t *self, gentity_t *other, gentity_t *activator )
       }
 
       self->active = qtrue;
+      level.buildableGeneration++;
       G_SetBuildableAnim( self, BANIM_ATTACK1, qfalse );
 
       //prevent lerping
@@ -1530,7 +1533,7 @@ void AHovel_Think( gentity_t *self )
 
   G_CreepSlow( self );
 
-  self->nextthink = level.time + 200;
+  G_SetNextThink( self, level.time + 200 );
 }
 
 /*
@@ -1575,8 +1578,9 @@ void AHovel_Die( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int
   self->s.eFlags &= ~EF_FIRING; //prevent any firing effects
   self->timestamp = level.time;
   self->think = ASpawn_Melt;
-  self->nextthink = level.time + 500; //wait .5 seconds before damaging others
+  G_SetNextThink( self, level.time + 500 ); //wait .5 seconds before damaging others
   self->die = nullDieFunction;
+  G_AccountBuildable( self );
 
   //if the hovel is occupied free the occupant
   if( self->active )
@@ -1697,7 +1701,7 @@ void ABooster_Think( gentity_t *self )
 
   G_CreepSlow( self );
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 
   if( !self->spawned || !self->powered || self->health <= 0 )
     return;
@@ -1874,7 +1878,7 @@ void ATrapper_Think( gentity_t *self )
 
   G_CreepSlow( self );
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 
   //if there is no creep nearby die
   if( !G_FindCreep( self ) )
@@ -1944,7 +1948,7 @@ void HRepeater_Think( gentity_t *self )
 
   self->powered = reactor;
 
-  self->nextthink = level.time + POWER_REFRESH_TIME;
+  G_SetNextThink( self, level.time + POWER_REFRESH_TIME );
 }
 
 /*
@@ -2026,7 +2030,7 @@ void HReactor_Think( gentity_t *self )
     self->lastHealth = self->health;
   }
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 }
 
 /*
@@ -2087,7 +2091,7 @@ Think for armoury
 void HArmoury_Think( gentity_t *self )
 {
   //make sure we have power
-  self->nextthink = level.time + POWER_REFRESH_TIME;
+  G_SetNextThink( self, level.time + POWER_REFRESH_TIME );
 
   self->powered = G_FindPower( self );
 }
@@ -2111,7 +2115,7 @@ Think for dcc
 void HDCC_Think( gentity_t *self )
 {
   //make sure we have power
-  self->nextthink = level.time + POWER_REFRESH_TIME;
+  G_SetNextThink( self, level.time + POWER_REFRESH_TIME );
 
   self->powered = G_FindPower( self );
 }
@@ -2136,7 +2140,7 @@ void HMedistat_Think( gentity_t *self )
   gentity_t *player;
   qboolean  occupied = qfalse;
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 
   //make sure we have power
   if( !( self->powered = G_FindPower( self ) ) )
@@ -2149,7 +2153,7 @@ void HMedistat_Think( gentity_t *self )
       self->enemy = NULL;
     }
 
-    self->nextthink = level.time + POWER_REFRESH_TIME;
+    G_SetNextThink( self, level.time + POWER_REFRESH_TIME );
     return;
   }
 
@@ -2460,7 +2464,7 @@ void HMGTurret_Think( gentity_t *self )
 {
   int firespeed = BG_FindFireSpeedForBuildable( self->s.modelindex );
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 
   //used for client side muzzle flashes
   self->s.eFlags &= ~EF_FIRING;
@@ -2484,7 +2488,7 @@ void HMGTurret_Think( gentity_t *self )
       }
     }
 
-    self->nextthink = level.time + POWER_REFRESH_TIME;
+    G_SetNextThink( self, level.time + POWER_REFRESH_TIME );
     return;
   }
 
@@ -2547,13 +2551,13 @@ void HTeslaGen_Think( gentity_t *self )
   int       i, num;
   gentity_t *enemy;
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 
   //if not powered don't do anything and check again for power next think
   if( !( self->powered = G_FindPower( self ) ) || !( self->dcced = G_FindDCC( self ) ) )
   {
     self->s.eFlags &= ~EF_FIRING;
-    self->nextthink = level.time + POWER_REFRESH_TIME;
+    G_SetNextThink( self, level.time + POWER_REFRESH_TIME );
     return;
   }
 
@@ -2629,7 +2633,7 @@ void HSpawn_Disappear( gentity_t *self )
   self->timestamp = level.time;
 
   self->think = freeBuildable;
-  self->nextthink = level.time + 100;
+  G_SetNextThink( self, level.time + 100 );
 
   self->r.contents = 0;    //stop collisions...
   trap_LinkEntity( self ); //...requires a relink
@@ -2661,7 +2665,7 @@ void HSpawn_Blast( gentity_t *self )
     self->splashRadius, self, 0, self->splashMethodOfDeath );
 
   self->think = freeBuildable;
-  self->nextthink = level.time + 100;
+  G_SetNextThink( self, level.time + 100 );
 
   self->r.contents = 0;    //stop collisions...
   trap_LinkEntity( self ); //...requires a relink
@@ -2702,18 +2706,19 @@ void HSpawn_Die( gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int
 
   self->die = nullDieFunction;
   self->powered = qfalse; //free up power
+  G_AccountBuildable( self );
   //prevent any firing effects and cancel structure protection
   self->s.eFlags &= ~( EF_FIRING | EF_DBUILDER );
 
   if( self->spawned )
   {
     self->think = HSpawn_Blast;
-    self->nextthink = level.time + HUMAN_DETONATION_DELAY;
+    G_SetNextThink( self, level.time + HUMAN_DETONATION_DELAY );
   }
   else
   {
     self->think = HSpawn_Disappear;
-    self->nextthink = level.time; //blast immediately
+    G_SetNextThink( self, level.time ); //blast immediately
   }
 
   if( attacker && attacker->client )
@@ -2837,7 +2842,7 @@ void HSpawn_Think( gentity_t *self )
     self->lastHealth = self->health;
   }
 
-  self->nextthink = level.time + BG_FindNextThinkForBuildable( self->s.modelindex );
+  G_SetNextThink( self, level.time + BG_FindNextThinkForBuildable( self->s.modelindex ) );
 }
 
 
@@ -2846,6 +2851,196 @@ void HSpawn_Think( gentity_t *self )
 //==================================================================================
 
 
+/*
+============
+G_ApplyBuildableAccount
+
+Add (sign 1) or remove (sign -1) a set of BPA_* flags for a buildable type
+to or from the level totals
+============
+*/
+static void G_ApplyBuildableAccount( buildable_t buildable, int flags, int sign )
+{
+  int team, bp;
+
+  if( !( flags & BPA_COUNTED ) )
+    return;
+
+  team = BG_FindTeamForBuildable( buildable );
+  bp = sign * BG_FindBuildPointsForBuildable( buildable );
+
+  level.buildPointsUsed[ team ] += bp;
+
+  if( flags & BPA_POWERED )
+    level.poweredBuildPointsUsed[ team ] += bp;
+
+  if( BG_FindReplaceableTestForBuildable( buildable ) )
+  {
+    level.replaceableBuildPointsUsed[ team ] += bp;
+
+    if( flags & BPA_POWERED )
+      level.poweredReplaceableBuildPointsUsed[ team ] += bp;
+  }
+
+  if( flags & BPA_ALIVE )
+  {
+    if( buildable == BA_A_SPAWN )
+      level.numAlienSpawns += sign;
+    else if( buildable == BA_H_SPAWN )
+      level.numHumanSpawns += sign;
+  }
+
+  if( flags & BPA_ACTIVE )
+  {
+    if( buildable == BA_A_OVERMIND )
+      level.numOverminds += sign;
+    else if( buildable == BA_H_REACTOR )
+      level.numReactors += sign;
+  }
+}
+
+/*
+============
+G_BuildableAccountFlags
+
+Work out which BPA_* flags an entity should currently contribute
+============
+*/
+static int G_BuildableAccountFlags( gentity_t *ent )
+{
+  int flags;
+
+  if( !ent->inuse || ent->s.eType != ET_BUILDABLE ||
+      ent->s.modelindex <= BA_NONE || ent->s.modelindex >= BA_NUM_BUILDABLES )
+    return 0;
+
+  flags = BPA_COUNTED;
+
+  if( ent->powered )
+    flags |= BPA_POWERED;
+
+  if( ent->health > 0 )
+  {
+    flags |= BPA_ALIVE;
+
+    if( ent->spawned )
+      flags |= BPA_ACTIVE;
+  }
+
+  return flags;
+}
+
+/*
+============
+G_AccountBuildable
+
+Bring a buildable's contribution to the running build point, spawn and
+reactor/overmind totals up to date. Cheap when nothing has changed, so it
+is called whenever a buildable is placed, finishes building, dies or thinks
+============
+*/
+void G_AccountBuildable( gentity_t *ent )
+{
+  int flags = G_BuildableAccountFlags( ent );
+
+  if( flags == ent->bpAccount &&
+      ( !flags || ent->bpAccountBuildable == ent->s.modelindex ) )
+    return;
+
+  G_ApplyBuildableAccount( ent->bpAccountBuildable, ent->bpAccount, -1 );
+  G_ApplyBuildableAccount( ent->s.modelindex, flags, 1 );
+
+  ent->bpAccount = flags;
+  ent->bpAccountBuildable = ent->s.modelindex;
+  level.buildableGeneration++;
+}
+
+/*
+============
+G_UnaccountBuildable
+
+Remove a buildable's contribution from the running totals, called when
+the entity is freed
+============
+*/
+void G_UnaccountBuildable( gentity_t *ent )
+{
+  G_ApplyBuildableAccount( ent->bpAccountBuildable, ent->bpAccount, -1 );
+
+  ent->bpAccount = 0;
+  ent->bpAccountBuildable = BA_NONE;
+  level.buildableGeneration++;
+}
+
+/*
+============
+G_CheckBuildableAccounting
+
+Recount every buildable and compare against the running totals, reporting
+any drift. The totals are left matching the recount
+============
+*/
+void G_CheckBuildableAccounting( void )
+{
+  int       i;
+  gentity_t *ent;
+  int       used[ BIT_NUM_TEAMS ], replaceable[ BIT_NUM_TEAMS ];
+  int       powered[ BIT_NUM_TEAMS ], poweredReplaceable[ BIT_NUM_TEAMS ];
+  int       alienSpawns, humanSpawns, overminds, reactors;
+
+  memcpy( used, level.buildPointsUsed, sizeof( used ) );
+  memcpy( replaceable, level.replaceableBuildPointsUsed, sizeof( replaceable ) );
+  memcpy( powered, level.poweredBuildPointsUsed, sizeof( powered ) );
+  memcpy( poweredReplaceable, level.poweredReplaceableBuildPointsUsed,
+          sizeof( poweredReplaceable ) );
+  alienSpawns = level.numAlienSpawns;
+  humanSpawns = level.numHumanSpawns;
+  overminds = level.numOverminds;
+  reactors = level.numReactors;
+
+  memset( level.buildPointsUsed, 0, sizeof( level.buildPointsUsed ) );
+  memset( level.replaceableBuildPointsUsed, 0, sizeof( level.replaceableBuildPointsUsed ) );
+  memset( level.poweredBuildPointsUsed, 0, sizeof( level.poweredBuildPointsUsed ) );
+  memset( level.poweredReplaceableBuildPointsUsed, 0,
+          sizeof( level.poweredReplaceableBuildPointsUsed ) );
+  level.numAlienSpawns = level.numHumanSpawns = 0;
+  level.numOverminds = level.numReactors = 0;
+
+  for( i = 1, ent = g_entities + i; i < level.num_entities; i++, ent++ )
+  {
+    ent->bpAccount = G_BuildableAccountFlags( ent );
+    ent->bpAccountBuildable = ent->s.modelindex;
+    G_ApplyBuildableAccount( ent->bpAccountBuildable, ent->bpAccount, 1 );
+  }
+  level.buildableGeneration++;
+
+  for( i = BIT_ALIENS; i < BIT_NUM_TEAMS; i++ )
+  {
+    if( used[ i ] != level.buildPointsUsed[ i ] ||
+        replaceable[ i ] != level.replaceableBuildPointsUsed[ i ] ||
+        powered[ i ] != level.poweredBuildPointsUsed[ i ] ||
+        poweredReplaceable[ i ] != level.poweredReplaceableBuildPointsUsed[ i ] )
+    {
+      G_Printf( S_COLOR_YELLOW "G_CheckBuildableAccounting: team %d BP drift "
+        "used %d/%d replaceable %d/%d powered %d/%d powered replaceable %d/%d\n",
+        i, used[ i ], level.buildPointsUsed[ i ],
+        replaceable[ i ], level.replaceableBuildPointsUsed[ i ],
+        powered[ i ], level.poweredBuildPointsUsed[ i ],
+        poweredReplaceable[ i ], level.poweredReplaceableBuildPointsUsed[ i ] );
+    }
+  }
+
+  if( alienSpawns != level.numAlienSpawns || humanSpawns != level.numHumanSpawns ||
+      overminds != level.numOverminds || reactors != level.numReactors )
+  {
+    G_Printf( S_COLOR_YELLOW "G_CheckBuildableAccounting: count drift "
+      "aspawns %d/%d hspawns %d/%d overminds %d/%d reactors %d/%d\n",
+      alienSpawns, level.numAlienSpawns, humanSpawns, level.numHumanSpawns,
+      overminds, level.numOverminds, reactors, level.numReactors );
+  }
+}
+
+
 /*
 ============
 G_BuildableTouchTriggers
@@ -2974,6 +3169,10 @@ void G_BuildableThink( gentity_t *ent, int msec )
 
   //fall back on normal physics routines
   G_Physics( ent, msec );
+
+  //pick up power and spawn state changes made while thinking
+  if( ent->inuse )
+    G_AccountBuildable( ent );
 }
 
 
@@ -3399,97 +3598,178 @@ static void G_SetBuildableMarkedLinkState( qboolean link )
 
 /*
 ================
-G_CanBuild
+G_TracePlacement
 
-Checks to see if a buildable can be built
+Work out where the ghost of a buildable sits and trace the space around it
 ================
 */
-itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int distance, vec3_t origin )
+static void G_TracePlacement( gentity_t *ent, buildable_t buildable, buildPlacement_t *p )
 {
-  vec3_t            angles;
-  vec3_t            entity_origin, normal;
-  vec3_t            mins, maxs, nbmins, nbmaxs;
-  vec3_t	    nbVect;
+  vec3_t            mins, maxs;
   trace_t           tr1, tr2, tr3;
-  int               i;
-  itemBuildError_t  reason = IBE_NONE;
-  gentity_t         *tempent;
-  float             minNormal;
-  qboolean          invert;
-  int               contents;
   playerState_t     *ps = &ent->client->ps;
-  gentity_t	    *tmp;
-  itemBuildError_t  tempReason;
 
   // Stop all buildables from interacting with traces
   G_SetBuildableLinkState( qfalse );
 
   BG_FindBBoxForBuildable( buildable, mins, maxs );
 
-  BG_PositionBuildableRelativeToPlayer( ps, mins, maxs, trap_Trace, entity_origin, angles, &tr1 );
+  BG_PositionBuildableRelativeToPlayer( ps, mins, maxs, trap_Trace, p->origin, p->angles, &tr1 );
+
+  trap_Trace( &tr2, p->origin, mins, maxs, p->origin, ent->s.number, MASK_PLAYERSOLID );
+  trap_Trace( &tr3, ps->origin, NULL, NULL, p->origin, ent->s.number, MASK_PLAYERSOLID );
+
+  VectorCopy( tr1.plane.normal, p->normal );
+  p->surfaceFlags = tr1.surfaceFlags;
+  p->onWorld = ( tr1.entityNum == ENTITYNUM_WORLD );
+  p->contents = trap_PointContents( p->origin, -1 );
+  p->noRoom = ( tr2.fraction < 1.0f || tr3.fraction < 1.0f );
+
+  p->hovelBlocked = qfalse;
+  if( buildable == BA_A_HOVEL && ps->stats[ STAT_PTEAM ] == PTE_ALIENS )
+    p->hovelBlocked = APropHovel_Blocked( p->origin, p->angles, p->normal, ent );
+
+  // Relink buildables
+  G_SetBuildableLinkState( qtrue );
+}
+
+/*
+================
+G_SamePlacement
+================
+*/
+static qboolean G_SamePlacement( buildPlacement_t *a, buildPlacement_t *b )
+{
+  return VectorCompare( a->origin, b->origin ) &&
+         VectorCompare( a->angles, b->angles ) &&
+         VectorCompare( a->normal, b->normal ) &&
+         a->surfaceFlags == b->surfaceFlags && a->contents == b->contents &&
+         a->onWorld == b->onWorld && a->hovelBlocked == b->hovelBlocked &&
+         a->noRoom == b->noRoom;
+}
+
+/*
+================
+G_PlacementArea
+
+The volume G_TracePlacement can touch: the builder, the drop trace that
+BG_PositionBuildableRelativeToPlayer makes (up to 32 units above and 128
+below the ghost) and the room a hovel needs to be left by its occupant
+================
+*/
+static void G_PlacementArea( gentity_t *ent, buildable_t buildable,
+                             buildPlacement_t *p, vec3_t areaMins, vec3_t areaMaxs )
+{
+  vec3_t  mins, maxs, cmins, cmaxs;
+  int     i;
+
+  BG_FindBBoxForBuildable( buildable, mins, maxs );
+  BG_FindBBoxForClass( ent->client->ps.stats[ STAT_PCLASS ], cmins, cmaxs, NULL, NULL, NULL );
+
+  for( i = 0; i < 3; i++ )
+  {
+    areaMins[ i ] = MIN( ent->client->ps.origin[ i ], p->origin[ i ] ) +
+                    mins[ i ] + 2.0f * cmins[ i ] - 160.0f;
+    areaMaxs[ i ] = MAX( ent->client->ps.origin[ i ], p->origin[ i ] ) +
+                    maxs[ i ] + 2.0f * cmaxs[ i ] + 160.0f;
+  }
+}
+
+/*
+================
+G_PlacementAreaIsStatic
+
+Check that nothing except the world and buildables (which the placement
+traces ignore) is able to change what the traces in an area see
+================
+*/
+static qboolean G_PlacementAreaIsStatic( gentity_t *ent, vec3_t mins, vec3_t maxs )
+{
+  int       entityList[ MAX_GENTITIES ];
+  int       i, num;
+  gentity_t *other;
+
+  num = trap_EntitiesInBox( mins, maxs, entityList, MAX_GENTITIES );
+  for( i = 0; i < num; i++ )
+  {
+    other = &g_entities[ entityList[ i ] ];
 
-  trap_Trace( &tr2, entity_origin, mins, maxs, entity_origin, ent->s.number, MASK_PLAYERSOLID );
-  trap_Trace( &tr3, ps->origin, NULL, NULL, entity_origin, ent->s.number, MASK_PLAYERSOLID );
+    if( other == ent || other->s.eType == ET_BUILDABLE )
+      continue;
 
-  VectorCopy( entity_origin, origin );
+    if( other->r.contents & ( MASK_PLAYERSOLID | CONTENTS_NOBUILD |
+                              CONTENTS_NOALIENBUILD | CONTENTS_NOHUMANBUILD ) )
+      return qfalse;
+  }
+
+  return qtrue;
+}
+
+/*
+================
+G_ValidatePlacement
+
+Check the rules for building at a traced placement. Everything looked at
+here is covered by level.buildableGeneration and the build point totals
+================
+*/
+static itemBuildError_t G_ValidatePlacement( gentity_t *ent, buildable_t buildable,
+                                             buildPlacement_t *p )
+{
+  vec3_t            nbmins, nbmaxs, nbVect;
+  int               i;
+  itemBuildError_t  reason = IBE_NONE;
+  gentity_t         *tempent;
+  float             minNormal;
+  qboolean          invert;
+  itemBuildError_t  tempReason;
 
-  VectorCopy( tr1.plane.normal, normal );
   minNormal = BG_FindMinNormalForBuildable( buildable );
   invert = BG_FindInvertNormalForBuildable( buildable );
 
   //can we build at this angle?
-  if( !( normal[ 2 ] >= minNormal || ( invert && normal[ 2 ] <= -minNormal ) ) )
+  if( !( p->normal[ 2 ] >= minNormal || ( invert && p->normal[ 2 ] <= -minNormal ) ) )
     reason = IBE_NORMAL;
 
-  if( tr1.entityNum != ENTITYNUM_WORLD )
+  if( !p->onWorld )
     reason = IBE_NORMAL;
 
-  contents = trap_PointContents( entity_origin, -1 );
-  
   //check if we are near a nobuild marker, if so, can't build here...
   for( i = 0; i < MAX_GENTITIES; i++ )
   {
-	tmp = &g_entities[ i ];
-	
-	if( !tmp->noBuild.isNB )
-	continue;
-	
-	nbVect[0] = tmp->noBuild.Area;
-	nbVect[1] = tmp->noBuild.Area;
-	nbVect[2] = tmp->noBuild.Height;
-	  
-    	VectorSubtract( origin, nbVect, nbmins );
-  	VectorAdd( origin, nbVect, nbmaxs );
-	
-	if( trap_EntityContact( nbmins, nbmaxs, tmp ) )
-	reason = IBE_PERMISSION;
-	
+    tempent = &g_entities[ i ];
+
+    if( !tempent->noBuild.isNB )
+      continue;
+
+    nbVect[ 0 ] = tempent->noBuild.Area;
+    nbVect[ 1 ] = tempent->noBuild.Area;
+    nbVect[ 2 ] = tempent->noBuild.Height;
+
+    VectorSubtract( p->origin, nbVect, nbmins );
+    VectorAdd( p->origin, nbVect, nbmaxs );
+
+    if( trap_EntityContact( nbmins, nbmaxs, tempent ) )
+      reason = IBE_PERMISSION;
   }
+
   if( ent->client->ps.stats[ STAT_PTEAM ] == PTE_ALIENS )
   {
     //alien criteria
 
-    if( buildable == BA_A_HOVEL )
-    {
-      vec3_t    builderMins, builderMaxs;
-
-      //this assumes the adv builder is the biggest thing that'll use the hovel
-      BG_FindBBoxForClass( PCL_ALIEN_BUILDER0_UPG, builderMins, builderMaxs, NULL, NULL, NULL );
-
-      if( APropHovel_Blocked( origin, angles, normal, ent ) )
-        reason = IBE_HOVELEXIT;
-    }
+    if( buildable == BA_A_HOVEL && p->hovelBlocked )
+      reason = IBE_HOVELEXIT;
 
     //check there is creep near by for building on
     if( BG_FindCreepTestForBuildable( buildable ) )
     {
-      if( !G_IsCreepHere( entity_origin ) )
+      if( !G_IsCreepHere( p->origin ) )
         reason = IBE_NOCREEP;
     }
 
     //check permission to build here
-    if( tr1.surfaceFlags & SURF_NOALIENBUILD || tr1.surfaceFlags & SURF_NOBUILD ||
-        contents & CONTENTS_NOALIENBUILD || contents & CONTENTS_NOBUILD )
+    if( p->surfaceFlags & SURF_NOALIENBUILD || p->surfaceFlags & SURF_NOBUILD ||
+        p->contents & CONTENTS_NOALIENBUILD || p->contents & CONTENTS_NOBUILD )
       reason = IBE_PERMISSION;
 
     //look for an Overmind
@@ -3539,7 +3819,7 @@ itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int distance
   else if( ent->client->ps.stats[ STAT_PTEAM ] == PTE_HUMANS )
   {
     //human criteria
-    if( !G_IsPowered( entity_origin ) )
+    if( !G_IsPowered( p->origin ) )
     {
       //tell player to build a repeater to provide power
       if( buildable != BA_H_REACTOR && buildable != BA_H_REPEATER )
@@ -3573,7 +3853,7 @@ itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int distance
             continue;
 
           if( tempent->s.modelindex == BA_H_REPEATER &&
-              Distance( tempent->s.origin, entity_origin ) < REPEATER_BASESIZE )
+              Distance( tempent->s.origin, p->origin ) < REPEATER_BASESIZE )
           {
             reason = IBE_RPTWARN2;
             break;
@@ -3583,13 +3863,13 @@ itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int distance
         if( reason == IBE_NONE )
           reason = IBE_RPTWARN;
       }
-      else if( G_IsPowered( entity_origin ) )
+      else if( G_IsPowered( p->origin ) )
         reason = IBE_RPTWARN2;
     }
 
     //check permission to build here
-    if( tr1.surfaceFlags & SURF_NOHUMANBUILD || tr1.surfaceFlags & SURF_NOBUILD ||
-        contents & CONTENTS_NOHUMANBUILD || contents & CONTENTS_NOBUILD )
+    if( p->surfaceFlags & SURF_NOHUMANBUILD || p->surfaceFlags & SURF_NOBUILD ||
+        p->contents & CONTENTS_NOHUMANBUILD || p->contents & CONTENTS_NOBUILD )
       reason = IBE_PERMISSION;
 
     //can we only build one of these?
@@ -3609,23 +3889,128 @@ itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int distance
     }
   }
 
-  if( ( tempReason = G_SufficientBPAvailable( buildable, origin ) ) != IBE_NONE )
+  if( ( tempReason = G_SufficientBPAvailable( buildable, p->origin ) ) != IBE_NONE )
     reason = tempReason;
 
-  // Relink buildables
-  G_SetBuildableLinkState( qtrue );
+  return reason;
+}
+
+/*
+================
+G_CanBuild
+
+Checks to see if a buildable can be built
+
+The placement and the verdict are cached per builder. The traces are
+reused while the builder hasn't moved and nothing dynamic is near the
+ghost, and the verdict while the traces give the same placement and no
+buildable, nobuild marker or build point total has changed since
+================
+*/
+itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int distance, vec3_t origin )
+{
+  placementCache_t  *pc = &ent->client->placement;
+  playerState_t     *ps = &ent->client->ps;
+  buildPlacement_t  placement;
+  itemBuildError_t  reason;
+  int               team = ps->stats[ STAT_PTEAM ];
+  int               state = ps->stats[ STAT_STATE ] & ( SS_WALLCLIMBING | SS_WALLCLIMBINGCEILING );
+  int               buildPoints = 0, spawns = 0;
+  int               i;
+
+  level.placementChecks++;
+
+  if( pc->traced && pc->buildable == buildable && pc->team == team &&
+      pc->pclass == ps->stats[ STAT_PCLASS ] && pc->state == state &&
+      VectorCompare( pc->playerOrigin, ps->origin ) &&
+      VectorCompare( pc->viewAngles, ps->viewangles ) &&
+      VectorCompare( pc->grapplePoint, ps->grapplePoint ) &&
+      G_PlacementAreaIsStatic( ent, pc->areaMins, pc->areaMaxs ) )
+    level.placementTraceHits++;
+  else
+  {
+    G_TracePlacement( ent, buildable, &placement );
+
+    if( pc->buildable != buildable || pc->team != team ||
+        !G_SamePlacement( &placement, &pc->placement ) )
+      pc->validated = qfalse;
+
+    pc->buildable = buildable;
+    pc->team = team;
+    pc->pclass = ps->stats[ STAT_PCLASS ];
+    pc->state = state;
+    VectorCopy( ps->origin, pc->playerOrigin );
+    VectorCopy( ps->viewangles, pc->viewAngles );
+    VectorCopy( ps->grapplePoint, pc->grapplePoint );
+    pc->placement = placement;
+
+    G_PlacementArea( ent, buildable, &pc->placement, pc->areaMins, pc->areaMaxs );
+    pc->traced = G_PlacementAreaIsStatic( ent, pc->areaMins, pc->areaMaxs );
+  }
+
+  VectorCopy( pc->placement.origin, origin );
+
+  switch( BG_FindTeamForBuildable( buildable ) )
+  {
+    case BIT_ALIENS:
+      buildPoints = level.alienBuildPoints;
+      spawns      = level.numAlienSpawns;
+      break;
+
+    case BIT_HUMANS:
+      buildPoints = level.humanBuildPoints;
+      spawns      = level.numHumanSpawns;
+      break;
+
+    default:
+      break;
+  }
+
+  if( pc->validated && pc->generation == level.buildableGeneration &&
+      pc->buildPoints == buildPoints && pc->spawns == spawns &&
+      pc->markDeconstruct == g_markDeconstruct.integer &&
+      pc->markDeconstructMode == g_markDeconstructMode.integer &&
+      pc->cheats == g_cheats.integer )
+  {
+    level.placementHits++;
+    reason = pc->reason;
+
+    for( i = 0; i < pc->numRemovals; i++ )
+      level.markedBuildables[ i ] = g_entities + pc->removals[ i ];
+    level.numBuildablesForRemoval = pc->numRemovals;
+  }
+  else
+  {
+    reason = G_ValidatePlacement( ent, buildable, &pc->placement );
+
+    pc->validated = ( level.numBuildablesForRemoval <= MAX_PLACEMENT_REMOVALS );
+    pc->generation = level.buildableGeneration;
+    pc->buildPoints = buildPoints;
+    pc->spawns = spawns;
+    pc->markDeconstruct = g_markDeconstruct.integer;
+    pc->markDeconstructMode = g_markDeconstructMode.integer;
+    pc->cheats = g_cheats.integer;
+    pc->reason = reason;
+
+    if( pc->validated )
+    {
+      pc->numRemovals = level.numBuildablesForRemoval;
+      for( i = 0; i < pc->numRemovals; i++ )
+        pc->removals[ i ] = level.markedBuildables[ i ] - g_entities;
+    }
+  }
 
   //check there is enough room to spawn from (presuming this is a spawn)
   if( reason == IBE_NONE )
   {
     G_SetBuildableMarkedLinkState( qfalse );
-    if( G_CheckSpawnPoint( ENTITYNUM_NONE, origin, normal, buildable, NULL ) != NULL )
+    if( G_CheckSpawnPoint( ENTITYNUM_NONE, origin, pc->placement.normal, buildable, NULL ) != NULL )
       reason = IBE_NORMAL;
     G_SetBuildableMarkedLinkState( qtrue );
   }
 
   //this item does not fit here
-  if( reason == IBE_NONE && ( tr2.fraction < 1.0 || tr3.fraction < 1.0 ) )
+  if( reason == IBE_NONE && pc->placement.noRoom )
     return IBE_NOROOM;
 
   if( reason != IBE_NONE )
@@ -3634,6 +4019,30 @@ itemBuildError_t G_CanBuild( gentity_t *ent, buildable_t buildable, int distance
   return reason;
 }
 
+/*
+================
+G_PlacementStats
+
+Report how often G_CanBuild could reuse its cached results
+================
+*/
+void G_PlacementStats( qboolean reset )
+{
+  int checks = MAX( level.placementChecks, 1 );
+
+  G_Printf( "placement checks: %d, traces reused: %d (%d%%), results reused: %d (%d%%)\n",
+            level.placementChecks,
+            level.placementTraceHits, level.placementTraceHits * 100 / checks,
+            level.placementHits, level.placementHits * 100 / checks );
+
+  if( reset )
+  {
+    level.placementChecks = 0;
+    level.placementTraceHits = 0;
+    level.placementHits = 0;
+  }
+}
+
 /*
 ==============
 G_BuildingExists
@@ -3734,7 +4143,7 @@ static gentity_t *G_Build( gentity_t *builder, buildable_t buildable, vec3_t ori
   built->splashRadius = BG_FindSplashRadiusForBuildable( buildable );
   built->splashMethodOfDeath = BG_FindMODForBuildable( buildable );
 
-  built->nextthink = BG_FindNextThinkForBuildable( buildable );
+  G_SetNextThink( built, BG_FindNextThinkForBuildable( buildable ) );
   built->takedamage = qtrue;
   built->spawned = qfalse;
   built->buildTime = built->s.time = level.time;
@@ -3918,7 +4327,8 @@ static gentity_t *G_Build( gentity_t *builder, buildable_t buildable, vec3_t ori
     G_SetBuildableAnim( built, BANIM_CONSTRUCT1, qtrue );
 
   trap_LinkEntity( built );
-  
+
+  G_AccountBuildable( built );
   
   if( builder->client ) 
   {
@@ -3982,6 +4392,7 @@ static void G_SpawnMarker( vec3_t origin )
 	nb->noBuild.Area = level.nbArea;
 	nb->noBuild.Height = level.nbHeight;
 	trap_LinkEntity( nb );
+	level.buildableGeneration++;
 	
 	// Log markers made...
 	for( i = 0; i < MAX_GENTITIES; i++ )
@@ -4161,6 +4572,7 @@ static void G_FinishSpawningBuildable( gentity_t *ent )
   built->spawned = qtrue; //map entities are already spawned
   built->health = BG_FindHealthForBuildable( buildable );
   built->s.generic1 |= B_SPAWNED_TOGGLEBIT;
+  G_AccountBuildable( built );
 
   // drop towards normal surface
   VectorScale( built->s.origin2, -4096.0f, dest );
@@ -4203,7 +4615,7 @@ void G_SpawnBuildable( gentity_t *ent, buildable_t buildable )
 
   // some movers spawn on the second frame, so delay item
   // spawns until the third frame so they can ride trains
-  ent->nextthink = level.time + FRAMETIME * 2;
+  G_SetNextThink( ent, level.time + FRAMETIME * 2 );
   ent->think = G_FinishSpawningBuildable;
 }
 
@@ -4259,6 +4671,295 @@ void G_SpawnBuildable( gentity_t *ent, buildable_t buildable )
    }
  }
  
+// binary layouts start with LAYOUT_IDENT and LAYOUT_VERSION, followed by
+// little endian layoutRecord_ts up to the end of the file. Anything else is
+// read as the old text format, one "%d %f %f ..." line per buildable
+#define LAYOUT_IDENT      ( ( 'T' << 24 ) + ( 'Y' << 16 ) + ( 'A' << 8 ) + 'L' )
+#define LAYOUT_VERSION    1
+#define LAYOUT_CHUNK      64    // records read or written at once
+#define LAYOUT_TEXT_CHUNK 4096
+
+typedef struct layoutRecord_s
+{
+  int     buildable;
+  vec3_t  origin;
+  vec3_t  angles;
+  vec3_t  origin2;
+  vec3_t  angles2;
+} layoutRecord_t;
+
+typedef void ( *layoutRecordFunc_t )( layoutRecord_t *record, void *data );
+
+typedef struct layoutWriter_s
+{
+  fileHandle_t    f;
+  qboolean        text;
+  int             count;
+  int             numRecords;
+  layoutRecord_t  records[ LAYOUT_CHUNK ];
+} layoutWriter_t;
+
+/*
+============
+G_LayoutSwapRecord
+
+Convert a record between native and file byte order
+============
+*/
+static void G_LayoutSwapRecord( layoutRecord_t *record )
+{
+  int i;
+
+  record->buildable = LittleLong( record->buildable );
+  for( i = 0; i < 3; i++ )
+  {
+    record->origin[ i ] = LittleFloat( record->origin[ i ] );
+    record->angles[ i ] = LittleFloat( record->angles[ i ] );
+    record->origin2[ i ] = LittleFloat( record->origin2[ i ] );
+    record->angles2[ i ] = LittleFloat( record->angles2[ i ] );
+  }
+}
+
+/*
+============
+G_LayoutReadBinary
+============
+*/
+static int G_LayoutReadBinary( fileHandle_t f, int len, const char *fileName,
+  layoutRecordFunc_t func, void *data )
+{
+  layoutRecord_t records[ LAYOUT_CHUNK ];
+  int            version;
+  int            count = 0, num, i;
+
+  if( len < sizeof( version ) )
+  {
+    G_Printf( S_COLOR_RED "ERROR: %s is truncated\n", fileName );
+    return -1;
+  }
+
+  trap_FS_Read( &version, sizeof( version ), f );
+  len -= sizeof( version );
+  version = LittleLong( version );
+  if( version != LAYOUT_VERSION )
+  {
+    G_Printf( S_COLOR_RED "ERROR: %s is layout version %d, expected %d\n",
+      fileName, version, LAYOUT_VERSION );
+    return -1;
+  }
+
+  if( len % sizeof( layoutRecord_t ) )
+    G_Printf( S_COLOR_YELLOW "WARNING: %s has a partial record at the end\n",
+      fileName );
+
+  for( len /= sizeof( layoutRecord_t ); len > 0; len -= num )
+  {
+    num = len < LAYOUT_CHUNK ? len : LAYOUT_CHUNK;
+    trap_FS_Read( records, num * sizeof( layoutRecord_t ), f );
+
+    for( i = 0; i < num; i++, count++ )
+    {
+      G_LayoutSwapRecord( &records[ i ] );
+      func( &records[ i ], data );
+    }
+  }
+
+  return count;
+}
+
+/*
+============
+G_LayoutReadText
+
+Parse the text format a chunk at a time, starting with the head bytes that
+were read to check for a binary layout
+============
+*/
+static int G_LayoutReadText( fileHandle_t f, int len, const char *head,
+  int headLen, const char *fileName, layoutRecordFunc_t func, void *data )
+{
+  char           buffer[ LAYOUT_TEXT_CHUNK ];
+  char           line[ MAX_STRING_CHARS ];
+  layoutRecord_t record;
+  int            count = 0, lineLen = 0, num, i;
+
+  memset( &record, 0, sizeof( record ) );
+  memcpy( buffer, head, headLen );
+  num = headLen;
+  len -= headLen;
+
+  while( 1 )
+  {
+    for( i = 0; i < num; i++ )
+    {
+      if( lineLen >= sizeof( line ) - 1 )
+      {
+        line[ lineLen ] = '\0';
+        G_Printf( S_COLOR_RED "ERROR: line overflow in %s before \"%s\"\n",
+          fileName, line );
+        return count;
+      }
+
+      line[ lineLen++ ] = buffer[ i ];
+      if( buffer[ i ] != '\n' )
+        continue;
+
+      line[ lineLen ] = '\0';
+      lineLen = 0;
+
+      sscanf( line, "%d %f %f %f %f %f %f %f %f %f %f %f %f\n",
+        &record.buildable,
+        &record.origin[ 0 ], &record.origin[ 1 ], &record.origin[ 2 ],
+        &record.angles[ 0 ], &record.angles[ 1 ], &record.angles[ 2 ],
+        &record.origin2[ 0 ], &record.origin2[ 1 ], &record.origin2[ 2 ],
+        &record.angles2[ 0 ], &record.angles2[ 1 ], &record.angles2[ 2 ] );
+
+      func( &record, data );
+      count++;
+    }
+
+    if( len <= 0 )
+      break;
+
+    num = len < sizeof( buffer ) ? len : sizeof( buffer );
+    trap_FS_Read( buffer, num, f );
+    len -= num;
+  }
+
+  return count;
+}
+
+/*
+============
+G_LayoutRead
+
+Pass each record in a layout file of either format to func. Returns the
+number of records, or -1 if the file couldn't be read. version is set to 0
+for a text layout
+============
+*/
+static int G_LayoutRead( const char *fileName, layoutRecordFunc_t func,
+  void *data, int *version )
+{
+  fileHandle_t f;
+  int          len, headLen, ident = 0, count;
+
+  len = trap_FS_FOpenFile( fileName, &f, FS_READ );
+  if( len < 0 || !f )
+    return -1;
+
+  headLen = len < sizeof( ident ) ? len : sizeof( ident );
+  trap_FS_Read( &ident, headLen, f );
+
+  if( headLen == sizeof( ident ) && LittleLong( ident ) == LAYOUT_IDENT )
+  {
+    *version = LAYOUT_VERSION;
+    count = G_LayoutReadBinary( f, len - headLen, fileName, func, data );
+  }
+  else
+  {
+    *version = 0;
+    count = G_LayoutReadText( f, len, (char *)&ident, headLen, fileName,
+      func, data );
+  }
+
+  trap_FS_FCloseFile( f );
+  return count;
+}
+
+/*
+============
+G_LayoutOpenWriter
+============
+*/
+static qboolean G_LayoutOpenWriter( layoutWriter_t *w, const char *fileName,
+  qboolean text )
+{
+  int ident = LittleLong( LAYOUT_IDENT );
+  int version = LittleLong( LAYOUT_VERSION );
+
+  w->text = text;
+  w->count = w->numRecords = 0;
+
+  if( trap_FS_FOpenFile( fileName, &w->f, FS_WRITE ) < 0 || !w->f )
+    return qfalse;
+
+  if( !text )
+  {
+    trap_FS_Write( &ident, sizeof( ident ), w->f );
+    trap_FS_Write( &version, sizeof( version ), w->f );
+  }
+  return qtrue;
+}
+
+/*
+============
+G_LayoutFlush
+
+Write out the buffered records with a single trap_FS_Write
+============
+*/
+static void G_LayoutFlush( layoutWriter_t *w )
+{
+  static char    text[ LAYOUT_CHUNK * 256 ];
+  layoutRecord_t *r;
+  int            len = 0, i;
+
+  if( !w->numRecords )
+    return;
+
+  if( !w->text )
+  {
+    for( i = 0; i < w->numRecords; i++ )
+      G_LayoutSwapRecord( &w->records[ i ] );
+    trap_FS_Write( w->records, w->numRecords * sizeof( layoutRecord_t ), w->f );
+    w->numRecords = 0;
+    return;
+  }
+
+  for( i = 0; i < w->numRecords; i++ )
+  {
+    r = &w->records[ i ];
+    Com_sprintf( text + len, sizeof( text ) - len,
+      "%i %f %f %f %f %f %f %f %f %f %f %f %f\n",
+      r->buildable,
+      r->origin[ 0 ], r->origin[ 1 ], r->origin[ 2 ],
+      r->angles[ 0 ], r->angles[ 1 ], r->angles[ 2 ],
+      r->origin2[ 0 ], r->origin2[ 1 ], r->origin2[ 2 ],
+      r->angles2[ 0 ], r->angles2[ 1 ], r->angles2[ 2 ] );
+    len += strlen( text + len );
+  }
+  trap_FS_Write( text, len, w->f );
+  w->numRecords = 0;
+}
+
+/*
+============
+G_LayoutWriteRecord
+============
+*/
+static void G_LayoutWriteRecord( layoutRecord_t *record, void *data )
+{
+  layoutWriter_t *w = data;
+
+  w->records[ w->numRecords++ ] = *record;
+  w->count++;
+
+  if( w->numRecords == LAYOUT_CHUNK )
+    G_LayoutFlush( w );
+}
+
+/*
+============
+G_LayoutCloseWriter
+============
+*/
+static void G_LayoutCloseWriter( layoutWriter_t *w )
+{
+  G_LayoutFlush( w );
+  trap_FS_FCloseFile( w->f );
+}
+
 /*
 ============
 G_LayoutSave
@@ -4269,11 +4970,10 @@ void G_LayoutSave( char *name )
 {
   char map[ MAX_QPATH ];
   char fileName[ MAX_OSPATH ];
-  fileHandle_t f;
-  int len;
   int i;
   gentity_t *ent;
-  char *s;
+  layoutRecord_t record;
+  static layoutWriter_t w;
 
   trap_Cvar_VariableStringBuffer( "mapname", map, sizeof( map ) );
   if( !map[ 0 ] )
@@ -4283,8 +4983,7 @@ void G_LayoutSave( char *name )
   }
   Com_sprintf( fileName, sizeof( fileName ), "layouts/%s/%s.dat", map, name );
 
-  len = trap_FS_FOpenFile( fileName, &f, FS_WRITE );
-  if( len < 0 )
+  if( !G_LayoutOpenWriter( &w, fileName, qfalse ) )
   {
     G_Printf( "layoutsave: could not open %s\n", fileName );
     return;
@@ -4298,23 +4997,151 @@ void G_LayoutSave( char *name )
     if( ent->s.eType != ET_BUILDABLE )
       continue;
 
-    s = va( "%i %f %f %f %f %f %f %f %f %f %f %f %f\n",
-      ent->s.modelindex,
-      ent->s.pos.trBase[ 0 ],
-      ent->s.pos.trBase[ 1 ],
-      ent->s.pos.trBase[ 2 ],
-      ent->s.angles[ 0 ],
-      ent->s.angles[ 1 ],
-      ent->s.angles[ 2 ],
-      ent->s.origin2[ 0 ],
-      ent->s.origin2[ 1 ],
-      ent->s.origin2[ 2 ],
-      ent->s.angles2[ 0 ],
-      ent->s.angles2[ 1 ],
-      ent->s.angles2[ 2 ] );
-    trap_FS_Write( s, strlen( s ), f );
+    record.buildable = ent->s.modelindex;
+    VectorCopy( ent->s.pos.trBase, record.origin );
+    VectorCopy( ent->s.angles, record.angles );
+    VectorCopy( ent->s.origin2, record.origin2 );
+    VectorCopy( ent->s.angles2, record.angles2 );
+    G_LayoutWriteRecord( &record, &w );
   }
-  trap_FS_FCloseFile( f );
+  G_LayoutCloseWriter( &w );
+}
+
+/*
+============
+G_LayoutCountRecord
+============
+*/
+static void G_LayoutCountRecord( layoutRecord_t *record, void *data )
+{
+  int *counts = data;
+
+  if( record->buildable > BA_NONE && record->buildable < BA_NUM_BUILDABLES )
+    counts[ record->buildable ]++;
+  else
+    counts[ BA_NONE ]++;
+}
+
+/*
+============
+G_LayoutInfo
+
+Print what a layout file contains and how long it takes to read
+============
+*/
+void G_LayoutInfo( const char *map, const char *name )
+{
+  char fileName[ MAX_OSPATH ];
+  int  counts[ BA_NUM_BUILDABLES ];
+  int  count, version, start, i;
+
+  Com_sprintf( fileName, sizeof( fileName ), "layouts/%s/%s.dat", map, name );
+  memset( counts, 0, sizeof( counts ) );
+
+  start = trap_Milliseconds( );
+  count = G_LayoutRead( fileName, G_LayoutCountRecord, counts, &version );
+  if( count < 0 )
+  {
+    G_Printf( "layout: could not read %s\n", fileName );
+    return;
+  }
+
+  G_Printf( "%s: ", fileName );
+  if( version )
+    G_Printf( "binary version %d", version );
+  else
+    G_Printf( "text" );
+  G_Printf( ", %d buildables, read in %d msec\n", count,
+    trap_Milliseconds( ) - start );
+
+  for( i = BA_NONE + 1; i < BA_NUM_BUILDABLES; i++ )
+  {
+    if( counts[ i ] )
+      G_Printf( "  %-12s %d\n", BG_FindNameForBuildable( i ), counts[ i ] );
+  }
+  if( counts[ BA_NONE ] )
+    G_Printf( "  %-12s %d\n", "(invalid)", counts[ BA_NONE ] );
+}
+
+typedef struct
+{
+  layoutRecord_t  records[ MAX_GENTITIES ];
+  int             numRecords;
+  qboolean        overflowed;
+} layoutBuffer_t;
+
+/*
+============
+G_LayoutBufferRecord
+============
+*/
+static void G_LayoutBufferRecord( layoutRecord_t *record, void *data )
+{
+  layoutBuffer_t *buffer = data;
+
+  if( buffer->numRecords >= MAX_GENTITIES )
+  {
+    buffer->overflowed = qtrue;
+    return;
+  }
+
+  buffer->records[ buffer->numRecords++ ] = *record;
+}
+
+/*
+============
+G_LayoutConvert
+
+Rewrite layout from as layout to in the text or binary format
+============
+*/
+void G_LayoutConvert( const char *map, const char *from, const char *to,
+  qboolean text )
+{
+  char fromFile[ MAX_OSPATH ];
+  char toFile[ MAX_OSPATH ];
+  int  count, version, i;
+  static layoutWriter_t w;
+  static layoutBuffer_t buffer;
+
+  Com_sprintf( fromFile, sizeof( fromFile ), "layouts/%s/%s.dat", map, from );
+  Com_sprintf( toFile, sizeof( toFile ), "layouts/%s/%s.dat", map, to );
+
+  if( !Q_stricmp( fromFile, toFile ) )
+  {
+    G_Printf( "layout: can't convert %s onto itself\n", fromFile );
+    return;
+  }
+
+  // read it all first so a bad source doesn't truncate the destination
+  buffer.numRecords = 0;
+  buffer.overflowed = qfalse;
+  if( G_LayoutRead( fromFile, G_LayoutBufferRecord, &buffer, &version ) < 0 )
+  {
+    G_Printf( "layout: could not read %s\n", fromFile );
+    return;
+  }
+
+  if( buffer.overflowed )
+  {
+    G_Printf( "layout: %s has more than %d buildables\n", fromFile, MAX_GENTITIES );
+    return;
+  }
+
+  if( !G_LayoutOpenWriter( &w, toFile, text ) )
+  {
+    G_Printf( "layout: could not open %s\n", toFile );
+    return;
+  }
+
+  for( i = 0; i < buffer.numRecords; i++ )
+    G_LayoutWriteRecord( &buffer.records[ i ], &w );
+
+  G_LayoutCloseWriter( &w );
+  count = buffer.numRecords;
+
+  G_Printf( "layout: wrote %d buildables from %s to %s as %s\n",
+    count, fromFile, toFile, text ? "text" : "binary" );
 }
 
 int G_LayoutList( const char *map, char *list, int len )
@@ -4489,6 +5316,7 @@ gentity_t *G_InstantBuild( buildable_t buildable, vec3_t origin, vec3_t angles,
   built->spawned = qtrue; //map entities are already spawned
   built->health = BG_FindHealthForBuildable( buildable );
   built->s.generic1 |= B_SPAWNED_TOGGLEBIT;
+  G_AccountBuildable( built );
 
   // drop towards normal surface
   VectorScale( built->s.origin2, -4096.0f, dest );
@@ -4549,8 +5377,9 @@ void G_SpawnRevertedBuildable( buildHistory_t *bh, qboolean mark )
   {
     built->r.contents = 0;
     built->think = G_CommitRevertedBuildable;
-    built->nextthink = level.time;
+    G_SetNextThink( built, level.time );
     built->deconstruct = mark;
+    level.buildableGeneration++;
   }
   for( i = 0; i < j; i++ )
     toRecontent[ i ]->r.contents = CONTENTS_BODY;
@@ -4644,12 +5473,12 @@ void G_CommitRevertedBuildable( gentity_t *ent )
         ent->think = HRepeater_Think;
         break;
     }
-    ent->nextthink = level.time + BG_FindNextThinkForBuildable( ent->s.modelindex );
+    G_SetNextThink( ent, level.time + BG_FindNextThinkForBuildable( ent->s.modelindex ) );
     // oh if only everything was that simple
     return;
   }
 #define REVERT_THINK_INTERVAL 50
-  ent->nextthink = level.time + REVERT_THINK_INTERVAL;
+  G_SetNextThink( ent, level.time + REVERT_THINK_INTERVAL );
 }
 
 /*
@@ -4687,6 +5516,21 @@ qboolean G_RevertCanFit( buildHistory_t *bh )
   return qtrue;
 }
 
+/*
+============
+G_LayoutLoadRecord
+============
+*/
+static void G_LayoutLoadRecord( layoutRecord_t *record, void *data )
+{
+  if( record->buildable > BA_NONE && record->buildable < BA_NUM_BUILDABLES )
+    G_LayoutBuildItem( record->buildable, record->origin, record->angles,
+      record->origin2, record->angles2 );
+  else
+    G_Printf( S_COLOR_YELLOW "WARNING: bad buildable number (%d) in "
+      " layout.  skipping\n", record->buildable );
+}
+
 /*
 ============
 G_LayoutLoad
@@ -4697,61 +5541,27 @@ as if a builder was creating them
 */
 void G_LayoutLoad( void )
 {
-  fileHandle_t f;
-  int len;
-  char *layout;
   char map[ MAX_QPATH ];
-  int buildable = BA_NONE;
-  vec3_t origin = { 0.0f, 0.0f, 0.0f };
-  vec3_t angles = { 0.0f, 0.0f, 0.0f };
-  vec3_t origin2 = { 0.0f, 0.0f, 0.0f };
-  vec3_t angles2 = { 0.0f, 0.0f, 0.0f };
-  char line[ MAX_STRING_CHARS ];
-  int i = 0;
+  char fileName[ MAX_OSPATH ];
+  int  count, version, start;
 
   if( !level.layout[ 0 ] || !Q_stricmp( level.layout, "*BUILTIN*" ) )
     return;
  
   trap_Cvar_VariableStringBuffer( "mapname", map, sizeof( map ) );
-  len = trap_FS_FOpenFile( va( "layouts/%s/%s.dat", map, level.layout ),
-    &f, FS_READ );
-  if( len < 0 )
+  Com_sprintf( fileName, sizeof( fileName ), "layouts/%s/%s.dat", map,
+    level.layout );
+
+  start = trap_Milliseconds( );
+  count = G_LayoutRead( fileName, G_LayoutLoadRecord, NULL, &version );
+  if( count < 0 )
   {
     G_Printf( "ERROR: layout %s could not be opened\n", level.layout );
     return;
   }
-  layout = G_Alloc( len + 1 );
-  trap_FS_Read( layout, len, f );
-  *( layout + len ) = '\0';
-  trap_FS_FCloseFile( f );
-  while( *layout )
-  {
-    if( i >= sizeof( line ) - 1 )
-    {
-      G_Printf( S_COLOR_RED "ERROR: line overflow in %s before \"%s\"\n",
-       va( "layouts/%s/%s.dat", map, level.layout ), line );
-      return; 
-    }
-    line[ i++ ] = *layout;
-    line[ i ] = '\0';
-    if( *layout == '\n' )
-    {
-      i = 0; 
-      sscanf( line, "%d %f %f %f %f %f %f %f %f %f %f %f %f\n",
-        &buildable,
-        &origin[ 0 ], &origin[ 1 ], &origin[ 2 ],
-        &angles[ 0 ], &angles[ 1 ], &angles[ 2 ],
-        &origin2[ 0 ], &origin2[ 1 ], &origin2[ 2 ],
-        &angles2[ 0 ], &angles2[ 1 ], &angles2[ 2 ] );
-
-      if( buildable > BA_NONE && buildable < BA_NUM_BUILDABLES )
-        G_LayoutBuildItem( buildable, origin, angles, origin2, angles2 );
-      else
-        G_Printf( S_COLOR_YELLOW "WARNING: bad buildable number (%d) in "
-          " layout.  skipping\n", buildable );
-    }
-    layout++;
-  }
+
+  G_Printf( "layout: loaded %d buildables from %s (%s) in %d msec\n", count,
+    fileName, version ? "binary" : "text", trap_Milliseconds( ) - start );
 }
 
 void G_BaseSelfDestruct( pTeam_t team )
@@ -4888,6 +5698,7 @@ void G_NobuildLoad( void )
 	nb->noBuild.Area = area;
 	nb->noBuild.Height = height;
 	trap_LinkEntity( nb );
+	level.buildableGeneration++;
 	
 	// Log markers made...
 	for( i = 0; i < MAX_GENTITIES; i++ )
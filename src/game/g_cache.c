@@ -0,0 +1,297 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// g_cache.c -- binary snapshots of parsed configuration files
+
+#include "g_local.h"
+
+// a cache file is a header followed by whatever the owner chooses to write:
+//
+//   int  ident, version, numSources
+//   int  lengths[ numSources ]   -1 for a source that doesn't exist
+//   int  hash                    of the source names and contents
+//
+// the VM can't see file timestamps, so the lengths are checked first and the
+// contents are only hashed when every length still matches
+
+#define CONFIG_CACHE_IDENT    ( ( 'C' << 24 ) + ( 'G' << 16 ) + ( 'F' << 8 ) + 'T' )
+#define CONFIG_CACHE_DIR      "cache"
+
+#define FNV_PRIME             0x01000193u
+
+/*
+===============
+G_HashConfigData
+
+FNV-1a over a block of bytes
+===============
+*/
+unsigned int G_HashConfigData( unsigned int hash, const char *data, int length )
+{
+  int i;
+
+  for( i = 0; i < length; i++ )
+  {
+    hash ^= (byte)data[ i ];
+    hash *= FNV_PRIME;
+  }
+
+  return hash;
+}
+
+/*
+===============
+G_HashConfigSource
+
+Fold a source file's name and contents into hash and return its length.
+If expectLength is given and doesn't match, the contents aren't read
+===============
+*/
+static int G_HashConfigSource( const char *fileName, const int *expectLength,
+                               unsigned int *hash )
+{
+  fileHandle_t  f;
+  char          buffer[ 1024 ];
+  int           length, remaining, chunk;
+
+  *hash = G_HashConfigData( *hash, fileName, strlen( fileName ) + 1 );
+
+  length = trap_FS_FOpenFile( fileName, &f, FS_READ );
+  if( !f )
+    return -1;
+
+  if( expectLength && *expectLength != length )
+  {
+    trap_FS_FCloseFile( f );
+    return length;
+  }
+
+  for( remaining = length; remaining > 0; remaining -= chunk )
+  {
+    chunk = remaining < (int)sizeof( buffer ) ? remaining : (int)sizeof( buffer );
+    trap_FS_Read( buffer, chunk, f );
+    *hash = G_HashConfigData( *hash, buffer, chunk );
+  }
+
+  trap_FS_FCloseFile( f );
+
+  return length;
+}
+
+/*
+===============
+G_AddConfigSource
+===============
+*/
+void G_AddConfigSource( configSources_t *sources, const char *fileName )
+{
+  if( sources->numSources >= MAX_CONFIG_SOURCES )
+  {
+    G_Printf( S_COLOR_YELLOW "WARNING: too many sources for config cache, "
+              "%s won't be checked\n", fileName );
+    return;
+  }
+
+  Q_strncpyz( sources->names[ sources->numSources ], fileName, MAX_QPATH );
+  sources->lengths[ sources->numSources ] = -1;
+  sources->numSources++;
+}
+
+/*
+===============
+G_ReadConfigCache
+
+Open the cache file name if it was written from the current contents of
+sources. Returns the length of the data following the header with f left
+open at the start of it, or -1 if the cache is missing or stale
+===============
+*/
+int G_ReadConfigCache( const char *name, configSources_t *sources, fileHandle_t *f )
+{
+  int           header[ 3 ];
+  int           length, headerLength, cached, i;
+  unsigned int  hash = CONFIG_HASH_INIT;
+  unsigned int  cachedHash;
+
+  length = trap_FS_FOpenFile( va( "%s/%s", CONFIG_CACHE_DIR, name ), f, FS_READ );
+  if( !*f )
+    return -1;
+
+  headerLength = ( 3 + sources->numSources + 1 ) * sizeof( int );
+  if( length < headerLength )
+  {
+    trap_FS_FCloseFile( *f );
+    return -1;
+  }
+
+  trap_FS_Read( header, sizeof( header ), *f );
+  if( header[ 0 ] != CONFIG_CACHE_IDENT || header[ 1 ] != CONFIG_CACHE_VERSION ||
+      header[ 2 ] != sources->numSources )
+  {
+    trap_FS_FCloseFile( *f );
+    return -1;
+  }
+
+  for( i = 0; i < sources->numSources; i++ )
+  {
+    trap_FS_Read( &cached, sizeof( cached ), *f );
+
+    sources->lengths[ i ] = G_HashConfigSource( sources->names[ i ], &cached, &hash );
+    if( sources->lengths[ i ] != cached )
+    {
+      trap_FS_FCloseFile( *f );
+      return -1;
+    }
+  }
+
+  trap_FS_Read( &cachedHash, sizeof( cachedHash ), *f );
+  if( cachedHash != hash )
+  {
+    trap_FS_FCloseFile( *f );
+    return -1;
+  }
+
+  return length - headerLength;
+}
+
+/*
+===============
+G_ReadConfigCacheData
+
+Read size bytes of cache data, as long as that many remain
+===============
+*/
+qboolean G_ReadConfigCacheData( fileHandle_t f, void *data, int size, int *remaining )
+{
+  if( size < 0 || size > *remaining )
+    return qfalse;
+
+  trap_FS_Read( data, size, f );
+  *remaining -= size;
+
+  return qtrue;
+}
+
+/*
+===============
+G_WriteConfigCache
+
+Start a new cache file for sources, returning a handle the caller writes
+its data to and closes, or 0 if the cache can't be written
+===============
+*/
+fileHandle_t G_WriteConfigCache( const char *name, configSources_t *sources )
+{
+  fileHandle_t  f;
+  int           header[ 3 ];
+  unsigned int  hash = CONFIG_HASH_INIT;
+  int           i;
+
+  for( i = 0; i < sources->numSources; i++ )
+    sources->lengths[ i ] = G_HashConfigSource( sources->names[ i ], NULL, &hash );
+
+  trap_FS_FOpenFile( va( "%s/%s", CONFIG_CACHE_DIR, name ), &f, FS_WRITE );
+  if( !f )
+    return 0;
+
+  header[ 0 ] = CONFIG_CACHE_IDENT;
+  header[ 1 ] = CONFIG_CACHE_VERSION;
+  header[ 2 ] = sources->numSources;
+
+  trap_FS_Write( header, sizeof( header ), f );
+  trap_FS_Write( sources->lengths, sources->numSources * sizeof( int ), f );
+  trap_FS_Write( &hash, sizeof( hash ), f );
+
+  return f;
+}
+
+/*
+===============
+G_InitOverrides
+
+Load the class and buildable overrides, from the cache if the override
+files haven't changed since it was written
+===============
+*/
+void G_InitOverrides( void )
+{
+  configSources_t sources;
+  fileHandle_t    f;
+  int             i, length;
+
+  sources.numSources = 0;
+  for( i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++ )
+    G_AddConfigSource( &sources, va( "overrides/classes/%s.cfg", BG_FindNameForClassNum( i ) ) );
+
+  length = G_ReadConfigCache( "classes.bin", &sources, &f );
+  if( length == ( PCL_NUM_CLASSES - 1 ) * (int)sizeof( classAttributeOverrides_t ) )
+  {
+    for( i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++ )
+      trap_FS_Read( BG_FindOverrideForClass( i ), sizeof( classAttributeOverrides_t ), f );
+
+    trap_FS_FCloseFile( f );
+  }
+  else
+  {
+    if( length >= 0 )
+      trap_FS_FCloseFile( f );
+
+    BG_InitClassOverrides( );
+
+    if( ( f = G_WriteConfigCache( "classes.bin", &sources ) ) )
+    {
+      for( i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++ )
+        trap_FS_Write( BG_FindOverrideForClass( i ), sizeof( classAttributeOverrides_t ), f );
+
+      trap_FS_FCloseFile( f );
+    }
+  }
+
+  sources.numSources = 0;
+  for( i = BA_NONE + 1; i < BA_NUM_BUILDABLES; i++ )
+    G_AddConfigSource( &sources, va( "overrides/buildables/%s.cfg", BG_FindNameForBuildable( i ) ) );
+
+  length = G_ReadConfigCache( "buildables.bin", &sources, &f );
+  if( length == ( BA_NUM_BUILDABLES - 1 ) * (int)sizeof( buildableAttributeOverrides_t ) )
+  {
+    for( i = BA_NONE + 1; i < BA_NUM_BUILDABLES; i++ )
+      trap_FS_Read( BG_FindOverrideForBuildable( i ), sizeof( buildableAttributeOverrides_t ), f );
+
+    trap_FS_FCloseFile( f );
+  }
+  else
+  {
+    if( length >= 0 )
+      trap_FS_FCloseFile( f );
+
+    BG_InitBuildableOverrides( );
+
+    if( ( f = G_WriteConfigCache( "buildables.bin", &sources ) ) )
+    {
+      for( i = BA_NONE + 1; i < BA_NUM_BUILDABLES; i++ )
+        trap_FS_Write( BG_FindOverrideForBuildable( i ), sizeof( buildableAttributeOverrides_t ), f );
+
+      trap_FS_FCloseFile( f );
+    }
+  }
+}
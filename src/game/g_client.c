@@ -717,7 +717,7 @@ void BodySink( gentity_t *ent )
     return;
   }
 
-  ent->nextthink = level.time + 100;
+  G_SetNextThink( ent, level.time + 100 );
   ent->s.pos.trBase[ 2 ] -= 1;
 }
 
@@ -735,7 +735,7 @@ void BodyFree( gentity_t *ent )
 
   //if not claimed in the next minute destroy
   ent->think = BodySink;
-  ent->nextthink = level.time + 60000;
+  G_SetNextThink( ent, level.time + 60000 );
 }
 
 
@@ -788,7 +788,7 @@ void SpawnCorpse( gentity_t *ent )
   body->s.misc = MAX_CLIENTS;
 
   body->think = BodySink;
-  body->nextthink = level.time + 20000;
+  G_SetNextThink( body, level.time + 20000 );
 
   body->s.legsAnim = ent->s.legsAnim;
 
@@ -1564,6 +1564,7 @@ const char *ClientConnect( int clientNum, qboolean firstTime )
   client = ent->client;
 
   memset( client, 0, sizeof(*client) );
+  G_UnlaggedClear( ent );
 
   // add guid to session so we don't have to keep parsing userinfo everywhere
   if( !guid[0] )
@@ -1581,11 +1582,9 @@ const char *ClientConnect( int clientNum, qboolean firstTime )
   client->pers.connected = CON_CONNECTING;
 
   // read or initialize the session data
-  if( firstTime || level.newSession )
+  if( firstTime || level.newSession || !G_ReadSessionData( client ) )
     G_InitSessionData( client, userinfo );
 
-  G_ReadSessionData( client );
-
   if( firstTime )
     client->pers.firstConnect = qtrue;
   else
@@ -1676,6 +1675,9 @@ void ClientBegin( int clientNum )
   client->pers.connected = CON_CONNECTED;
   client->pers.enterTime = level.time;
   client->pers.teamState.state = TEAM_BEGIN;
+
+  // clients arriving during a vote may still vote on it
+  G_AllowVote( clientNum, PTE_NONE );
   client->pers.classSelection = PCL_NONE;
 
   // save eflags around this, because changing teams will
@@ -2091,21 +2093,7 @@ void ClientDisconnect( int clientNum )
     return;
 
   // discard this player's vote
-  if( level.voteTime && level.votedHow[ clientNum ] )
-  {
-     if( level.votedHow[ clientNum ] > 0 )
-     {
-       level.voteYes--;
-       trap_SetConfigstring( CS_VOTE_YES, va( "%i", level.voteYes ) );
-     }
-     else
-     {
-       level.voteNo--;
-       trap_SetConfigstring( CS_VOTE_NO, va( "%i", level.voteNo ) );
-     }
-
-     level.votedHow[ clientNum ] = 0;
-  }
+  G_WithdrawVote( clientNum, PTE_NONE );
 
   // look through the bhist and readjust it if the referenced ent has left
   for( ptr = level.buildHistory; ptr; ptr = ptr->next )
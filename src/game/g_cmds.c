@@ -648,23 +648,8 @@ void G_LeaveTeam( gentity_t *self )
     }
   }
 
-  if( level.teamVoteTime[ team ] && level.teamVotedHow[ team ][ clientNum ] )
-  {
-     int cs_offset = (team == PTE_ALIENS ? 1 : 0);
-
-     if( level.teamVotedHow[ team ][ clientNum ] > 0 )
-     {
-       level.teamVoteYes[ team ]--;
-       trap_SetConfigstring( CS_TEAMVOTE_YES + cs_offset, va( "%i", level.teamVoteYes[ team ] ) );
-     }
-     else
-     {
-       level.teamVoteNo[ team ]--;
-       trap_SetConfigstring( CS_TEAMVOTE_NO + cs_offset, va( "%i", level.teamVoteNo[ team ] ) );
-     }
-
-     level.teamVotedHow[ team ][ clientNum ] = 0;
-  }
+  if( team == PTE_ALIENS || team == PTE_HUMANS )
+    G_WithdrawVote( clientNum, team );
 }
 
 /*
@@ -683,6 +668,9 @@ void G_ChangeTeam( gentity_t *ent, pTeam_t newTeam )
   G_LeaveTeam( ent );
   ent->client->pers.teamSelection = newTeam;
 
+  if( newTeam != PTE_NONE )
+    G_AllowVote( ent - g_entities, newTeam );
+
   ent->client->pers.lastFreekillTime = level.time;
 
   // G_LeaveTeam() calls G_StopFollowing() which sets spec mode to free. 
@@ -1539,608 +1527,1230 @@ static qboolean map_is_votable( const char *map )
   return qfalse;
 }
 
+#define VOTEF_TARGET  0x0001  // takes a player name
+#define VOTEF_REASON  0x0002  // needs a reason when g_requireVoteReasons is set
+#define VOTEF_POLL    0x0004  // the caller doesn't automatically vote yes
+#define VOTEF_ALERT   0x0008  // team vote is shown to admins on other teams
+
+// everything a vote handler needs to check and build a vote
+typedef struct
+{
+  gentity_t   *ent;               // the caller
+  pTeam_t     team;               // PTE_NONE for a global vote
+  int         numVoters;          // on team, for team votes
+  char        *arg1;              // vote name
+  char        *arg2;              // first argument
+  char        *arg2plus;          // everything after the vote name
+  int         clientNum;          // target of a VOTEF_TARGET vote
+  const char  *name;              // target's clean name
+  const char  *reason;
+  const char  *message;           // admin alert for a vote on an immune admin
+
+  char        *voteString;        // command run if the vote passes
+  int         voteStringSize;
+  char        *displayString;     // shown to voters
+  int         displayStringSize;
+} voteCall_t;
+
+// check the arguments of a vote and build its strings, returning qfalse to
+// refuse it after telling the caller why
+typedef qboolean (*voteFunc_t)( voteCall_t *call );
+
+typedef struct
+{
+  const char  *name;
+  voteFunc_t  func;
+  int         flags;
+} voteInfo_t;
+
 /*
 ==================
-Cmd_CallVote_f
+G_VoteTargetImmune
 ==================
 */
-void Cmd_CallVote_f( gentity_t *ent )
+static qboolean G_VoteTargetImmune( voteCall_t *call )
 {
-  int   i;
-  int   skipargs = 0;
-  char  arg1[ MAX_STRING_TOKENS ];
-  char  arg2[ MAX_STRING_TOKENS ];
-  int   clientNum = -1;
-  char  name[ MAX_NETNAME ];
-  char *arg1plus;
-  char *arg2plus;
-  char  message[ MAX_STRING_CHARS ];
-  char  targetname[ MAX_NAME_LENGTH] = "";
-  char  reason[ MAX_STRING_CHARS ] = "";
-  char *ptr = NULL;
-  char  cmd[ 12 ];
-
-  G_SayArgv( 0, cmd, sizeof( cmd ) );
+  return G_admin_permission( &g_entities[ call->clientNum ], ADMF_IMMUNITY ) &&
+         g_entities[ call->clientNum ].client->pers.adminLevel >=
+         call->ent->client->pers.adminLevel;
+}
 
-  if( !Q_stricmp( cmd, "say" ) || !Q_stricmp( cmd, "say_team" ) )
-    skipargs = 1;
+/*
+==================
+G_VoteMapTimeLimited
 
-  arg1plus = G_SayConcatArgs( 1 );
-  arg2plus = G_SayConcatArgs( 2 );
-  
-  // Invisible players cannot call votes
-  if( ent->client->sess.invisible == qtrue )
+Map votes can't be called once g_mapvoteMaxTime has passed
+==================
+*/
+static qboolean G_VoteMapTimeLimited( voteCall_t *call, const char *what )
+{
+  if( g_mapvoteMaxTime.integer
+    && (( level.time - level.startTime ) >= g_mapvoteMaxTime.integer * 1000 )
+    && !G_admin_permission( call->ent, ADMF_NO_VOTE_LIMIT )
+    && (level.numPlayingClients > 0 && level.numConnectedClients>1) )
   {
-    trap_SendServerCommand( ent-g_entities, "print \"You cannot call votes while invisible\n\"" );
-    return;
+     trap_SendServerCommand( call->ent-g_entities, va(
+       "print \"You cannot call for a %s after %d seconds\n\"",
+       what, g_mapvoteMaxTime.integer ) );
+     G_admin_adminlog_log( call->ent, "vote", NULL, 0, qfalse );
+     return qtrue;
   }
 
-  if( !g_allowVote.integer )
+  return qfalse;
+}
+
+/*
+==================
+G_VoteKick
+==================
+*/
+static qboolean G_VoteKick( voteCall_t *call )
+{
+  char n1[ MAX_NAME_LENGTH ];
+
+  if( G_VoteTargetImmune( call ) )
   {
-    trap_SendServerCommand( ent-g_entities, "print \"Voting not allowed here\n\"" );
-    return;
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callvote: admin is immune from vote kick\n\"" );
+    G_AdminsPrintf("%s\n",call->message);
+    G_admin_adminlog_log( call->ent, "vote", NULL, 0, qfalse );
+    return qfalse;
   }
 
-  // Flood limit.  If they're talking too fast, determine that and return.
-  if( g_floodMinTime.integer )
-    if ( G_Flood_Limited( ent ) )
-    {
-      trap_SendServerCommand( ent-g_entities, "print \"Your /callvote attempt is flood-limited; wait before chatting again\n\"" );
-      return;
-    }
+  // use ip in case this player disconnects before the vote ends
+  Com_sprintf( call->voteString, call->voteStringSize,
+    "!ban %s \"%s\" vote kick", level.clients[ call->clientNum ].pers.ip,
+    g_adminTempBan.string );
+  if ( call->reason[0]!='\0' )
+    Q_strcat( call->voteString, call->voteStringSize, va( ": \"%s^7\"", call->reason ) );
+  G_SanitiseString( call->ent->client->pers.netname, n1, sizeof( n1 ) );
+  Q_strcat( call->voteString, call->voteStringSize, va( ", \"%s\"", n1 ) );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "Kick player \'%s\'", call->name );
 
-  //see if they can vote
-  if( G_admin_permission( ent, ADMF_NO_VOTE ) )
+  level.votePassThreshold = g_kickVotesPercent.integer;
+  return qtrue;
+}
+
+/*
+==================
+G_VoteSpec
+==================
+*/
+static qboolean G_VoteSpec( voteCall_t *call )
+{
+  if( G_VoteTargetImmune( call ) )
   {
-    trap_SendServerCommand( ent-g_entities, "print \"You have no voting rights\n\"" );
-    return;
+    trap_SendServerCommand( call->ent-g_entities, "print \"callvote: admin is immune from vote spec\n\"" );
+    return qfalse;
   }
 
-  if( g_voteMinTime.integer
-    && ent->client->pers.firstConnect 
-    && level.time - ent->client->pers.enterTime < g_voteMinTime.integer * 1000
-    && !G_admin_permission( ent, ADMF_NO_VOTE_LIMIT ) 
-    && (level.numPlayingClients > 0 && level.numConnectedClients>1) )
+  Com_sprintf( call->voteString, call->voteStringSize, "!putteam %i s %s", call->clientNum, g_adminTempSpec.string );
+  Com_sprintf( call->displayString, call->displayStringSize, "Spec player \'%s\'", call->name );
+  return qtrue;
+}
+
+/*
+==================
+G_VoteMute
+==================
+*/
+static qboolean G_VoteMute( voteCall_t *call )
+{
+  if( G_IsMuted( &level.clients[ call->clientNum ] ) )
   {
-    trap_SendServerCommand( ent-g_entities, va(
-      "print \"You must wait %d seconds after connecting before calling a vote\n\"",
-      g_voteMinTime.integer ) );
-    return;
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callvote: player is already muted\n\"" );
+    return qfalse;
   }
 
-  if( level.voteTime )
+  if( G_VoteTargetImmune( call ) )
   {
-    trap_SendServerCommand( ent-g_entities, "print \"A vote is already in progress\n\"" );
-    return;
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callvote: admin is immune from vote mute\n\"" );
+    G_AdminsPrintf("%s\n",call->message);
+    G_admin_adminlog_log( call->ent, "vote", NULL, 0, qfalse );
+    return qfalse;
   }
 
-  if( g_voteLimit.integer > 0
-    && ent->client->pers.voteCount >= g_voteLimit.integer
-    && !G_admin_permission( ent, ADMF_NO_VOTE_LIMIT ) )
+  Com_sprintf( call->voteString, call->voteStringSize,
+    "!mute %i %s", call->clientNum, g_adminTempMute.string );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "Mute player \'%s\'", call->name );
+  return qtrue;
+}
+
+/*
+==================
+G_VoteUnmute
+==================
+*/
+static qboolean G_VoteUnmute( voteCall_t *call )
+{
+  if( !G_IsMuted( &level.clients[ call->clientNum ] ) )
   {
-    trap_SendServerCommand( ent-g_entities, va(
-      "print \"You have already called the maximum number of votes (%d)\n\"",
-      g_voteLimit.integer ) );
-    return;
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callvote: player is not currently muted\n\"" );
+    return qfalse;
   }
-  
-  if( G_IsMuted( ent->client ) )
+
+  Com_sprintf( call->voteString, call->voteStringSize,
+    "!unmute %i", call->clientNum );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "Un-Mute player \'%s\'", call->name );
+  return qtrue;
+}
+
+/*
+==================
+G_VoteMapRestart
+==================
+*/
+static qboolean G_VoteMapRestart( voteCall_t *call )
+{
+  if( G_VoteMapTimeLimited( call, "restart" ) )
+    return qfalse;
+
+  Com_sprintf( call->voteString, call->voteStringSize, "%s", call->arg1 );
+  Com_sprintf( call->displayString, call->displayStringSize, "Restart current map" );
+  level.votePassThreshold = g_mapVotesPercent.integer;
+  return qtrue;
+}
+
+/*
+==================
+G_VoteMap
+==================
+*/
+static qboolean G_VoteMap( voteCall_t *call )
+{
+  if( G_VoteMapTimeLimited( call, "mapchange" ) )
+    return qfalse;
+
+  if( !G_MapExists( call->arg2 ) )
   {
-    trap_SendServerCommand( ent - g_entities,
-      "print \"You are muted and cannot call votes\n\"" );
-    return;
+    trap_SendServerCommand( call->ent - g_entities, va( "print \"callvote: "
+      "'maps/%s.bsp' could not be found on the server\n\"", call->arg2 ) );
+    return qfalse;
   }
 
-  if( !G_admin_permission( ent, ADMF_NOSCRIMRESTRICTION ) && g_scrimMode.integer != 0 &&
-      ent->client->pers.teamSelection == PTE_NONE )
+  if( !G_admin_permission( call->ent, ADMF_NO_VOTE_LIMIT ) && !map_is_votable( call->arg2 ) )
   {
-    trap_SendServerCommand( ent - g_entities,
-      "print \"You can't call votes when scrim mode is enabled\n\"" );
-	return;
+    trap_SendServerCommand( call->ent - g_entities, va( "print \"callvote: "
+      "Only admins may call a vote for map: %s\n\"", call->arg2 ) );
+    return qfalse;
   }
 
-  // make sure it is a valid command to vote on
-  G_SayArgv( 1 + skipargs, arg1, sizeof( arg1 ) );
-  G_SayArgv( 2 + skipargs, arg2, sizeof( arg2 ) );
+  Com_sprintf( call->voteString, call->voteStringSize, "%s %s", call->arg1, call->arg2 );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "Change to map '%s'", call->arg2 );
+  level.votePassThreshold = g_mapVotesPercent.integer;
+  return qtrue;
+}
 
-  if( strchr( arg1plus, ';' ) )
+/*
+==================
+G_VoteNextMap
+==================
+*/
+static qboolean G_VoteNextMap( voteCall_t *call )
+{
+  if( G_MapExists( g_nextMap.string ) )
   {
-    trap_SendServerCommand( ent-g_entities, "print \"Invalid vote string\n\"" );
-    return;
+    trap_SendServerCommand( call->ent - g_entities, va( "print \"callvote: "
+      "the next map is already set to ^7'%s^7'\n\"", g_nextMap.string ) );
+    return qfalse;
   }
 
-  // if there is still a vote to be executed
-  if( level.voteExecuteTime )
+  if( !call->arg2[ 0 ] )
   {
-    if( !Q_stricmp( level.voteString, "map_restart" ) )
-    {
-      G_admin_maplog_result( "r" );
-    }
-    else if( !Q_stricmpn( level.voteString, "map", 3 ) )
-    {
-      G_admin_maplog_result( "m" );
-    }
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callvote: you must specify a map\n\"" );
+    return qfalse;
+  }
 
-    level.voteExecuteTime = 0;
-    trap_SendConsoleCommand( EXEC_APPEND, va( "%s\n", level.voteString ) );
+  if( !G_MapExists( call->arg2 ) )
+  {
+    trap_SendServerCommand( call->ent - g_entities, va( "print \"callvote: "
+      "'maps/%s^7.bsp' could not be found on the server\n\"", call->arg2 ) );
+    return qfalse;
   }
-  
-  level.votePassThreshold=50;
-  
-  ptr = strstr(arg1plus, " -");
-  if( ptr )
+
+  if( !G_admin_permission( call->ent, ADMF_NO_VOTE_LIMIT ) && !map_is_votable( call->arg2 ) )
   {
-    *ptr = '\0';
-    ptr+=2; 
+    trap_SendServerCommand( call->ent - g_entities, va( "print \"callvote: "
+      "Only admins may call a vote for map: %s\n\"", call->arg2 ) );
+    return qfalse;
+  }
 
-    if( *ptr == 'r' || *ptr=='R' )
-    {
-      ptr++;
-      while( *ptr == ' ' )
-        ptr++;
-      strcpy(reason, ptr);
-    }
-    else
-    {
-      trap_SendServerCommand( ent-g_entities, "print \"callvote: Warning: invalid argument specified \n\"" );
-    }
+  Com_sprintf( call->voteString, call->voteStringSize,
+    "set g_nextMap %s", call->arg2 );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "Set the next map to ^7'%s^7'", call->arg2 );
+  level.votePassThreshold = g_mapVotesPercent.integer;
+  return qtrue;
+}
+
+/*
+==================
+G_VoteDraw
+==================
+*/
+static qboolean G_VoteDraw( voteCall_t *call )
+{
+  Com_sprintf( call->voteString, call->voteStringSize, "evacuation" );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "End match in a draw" );
+  level.votePassThreshold = g_mapVotesPercent.integer;
+  return qtrue;
+}
+
+/*
+==================
+G_VotePoll
+==================
+*/
+static qboolean G_VotePoll( voteCall_t *call )
+{
+  if( call->team == PTE_NONE && g_disablePollVotes.integer )
+  {
+    trap_SendServerCommand( call->ent-g_entities, "print \"callvote: Poll votes are currently disabled.\n\"" );
+    return qfalse;
   }
 
-  // detect clientNum for partial name match votes
-  if( !Q_stricmp( arg1, "kick" ) ||
-    !Q_stricmp( arg1, "spec" ) ||
-    !Q_stricmp( arg1, "mute" ) ||
-    !Q_stricmp( arg1, "unmute" ) )
+  if( call->arg2plus[ 0 ] == '\0' )
   {
-    int clientNums[ MAX_CLIENTS ] = { -1 };
-    int numMatches=0;
-    char err[ MAX_STRING_CHARS ] = "";
-    
-    Q_strncpyz(targetname, arg2plus, sizeof(targetname));
-    ptr = strstr(targetname, " -");
-    if( ptr )
-      *ptr = '\0';
-    
-    if( g_requireVoteReasons.integer && !G_admin_permission( ent, ADMF_UNACCOUNTABLE ) && !Q_stricmp( arg1, "kick" ) && reason[ 0 ]=='\0' )
-    {
-       trap_SendServerCommand( ent-g_entities, "print \"callvote: You must specify a reason. Use /callvote kick [player] -r [reason] \n\"" );
-       return;
-    }
-    
-    if( !targetname[ 0 ] )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callvote: no target\n\"" );
-      return;
-    }
+    trap_SendServerCommand( call->ent-g_entities, va( "print \"%s: You forgot to specify what people should vote on.\n\"",
+      call->team == PTE_NONE ? "callvote" : "callteamvote" ) );
+    return qfalse;
+  }
 
-    numMatches = G_ClientNumbersFromString( targetname, clientNums );
-    if( numMatches == 1 )
-    {
-      // there was only one partial name match
-      clientNum = clientNums[ 0 ]; 
-    }
-    else
-    {
-      // look for an exact name match (sets clientNum to -1 if it fails) 
-      clientNum = G_ClientNumberFromString( ent, targetname );
-    }
-    
-    if( clientNum==-1  && numMatches > 1 ) 
-    {
-      G_MatchOnePlayer( clientNums, err, sizeof( err ) );
-      ADMP( va( "^3callvote: ^7%s\n", err ) );
-      return;
-    }
-    
-    if( clientNum != -1 &&
-        level.clients[ clientNum ].pers.connected != CON_CONNECTED )
-    {
-      clientNum = -1;
-    }
+  call->voteString[ 0 ] = '\0';
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "[Poll] \'%s\'", call->arg2plus );
+  return qtrue;
+}
 
-    if( clientNum != -1 )
+/*
+==================
+G_VoteSuddenDeath
+==================
+*/
+static qboolean G_VoteSuddenDeath( voteCall_t *call )
+{
+  if(!g_suddenDeathVotePercent.integer)
+  {
+    trap_SendServerCommand( call->ent-g_entities, "print \"Sudden Death votes have been disabled\n\"" );
+    return qfalse;
+  }
+  else if( g_suddenDeath.integer )
+  {
+    trap_SendServerCommand( call->ent - g_entities, va( "print \"callvote: Sudden Death has already begun\n\"") );
+    return qfalse;
+  }
+  else if( G_TimeTilSuddenDeath() <= g_suddenDeathVoteDelay.integer * 1000 )
+  {
+    trap_SendServerCommand( call->ent - g_entities, va( "print \"callvote: Sudden Death is already immenent\n\"") );
+    return qfalse;
+  }
+
+  level.votePassThreshold = g_suddenDeathVotePercent.integer;
+  Com_sprintf( call->voteString, call->voteStringSize, "suddendeath" );
+  Com_sprintf( call->displayString, call->displayStringSize, "Begin sudden death" );
+
+  if( g_suddenDeathVoteDelay.integer )
+    Q_strcat( call->displayString, call->displayStringSize, va( " in %d seconds", g_suddenDeathVoteDelay.integer ) );
+
+  return qtrue;
+}
+
+/*
+==================
+G_VoteDelaySuddenDeath
+==================
+*/
+static qboolean G_VoteDelaySuddenDeath( voteCall_t *call )
+{
+  if(!g_suddenDeathExtensionTime.integer || !g_suddenDeathExtensionPercent.integer)
+  {
+    trap_SendServerCommand( call->ent-g_entities, "print \"Sudden Death extension votes have been disabled\n\"" );
+    return qfalse;
+  }
+  else if( g_suddenDeath.integer )
+  {
+    trap_SendServerCommand( call->ent - g_entities, va( "print \"callvote: Sudden Death has already begun\n\"") );
+    return qfalse;
+  }
+  else if( G_TimeTilSuddenDeath() >= g_suddenDeathExtensionTime.integer * 60000 )
+  {
+    trap_SendServerCommand( call->ent - g_entities, va( "print \"callvote: Wait until Sudden Death is close...\n\"") );
+    return qfalse;
+  }
+
+  level.votePassThreshold = g_suddenDeathExtensionPercent.integer;
+  Com_sprintf( call->voteString, call->voteStringSize, "delay_sudden_death" );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "Delay sudden death by %i minutes", g_suddenDeathExtensionTime.integer );
+  return qtrue;
+}
+
+/*
+==================
+G_VoteExtend
+==================
+*/
+static qboolean G_VoteExtend( voteCall_t *call )
+{
+  if( !g_extendVotesPercent.integer )
+  {
+    trap_SendServerCommand( call->ent-g_entities, "print \"Extend votes have been disabled\n\"" );
+    return qfalse;
+  }
+  if( g_extendVotesCount.integer
+      && level.extend_vote_count >= g_extendVotesCount.integer )
+  {
+    trap_SendServerCommand( call->ent-g_entities, va( "print \"callvote: Maximum number of %d extend votes has been reached\n\"", g_extendVotesCount.integer ) );
+    return qfalse;
+  }
+  if( !g_timelimit.integer ) {
+    trap_SendServerCommand( call->ent-g_entities, "print \"This match has no timelimit so extend votes wont work\n\"" );
+    return qfalse;
+  }
+  if( level.time - level.startTime <
+      ( g_timelimit.integer - g_extendVotesTime.integer ) * 60000 )
+  {
+    trap_SendServerCommand( call->ent-g_entities, va( "print \"callvote: Extend votes only allowed with less than %d minutes remaining\n\"", g_extendVotesTime.integer ) );
+    return qfalse;
+  }
+  level.extend_vote_count++;
+  level.votePassThreshold = g_extendVotesPercent.integer;
+
+  if( ( g_extendVotesCount.integer - level.extend_vote_count ) > 1 )
+  {
+    AP( va( "print \"^7Only ^3%i^7 more extension votes may be called.\n\"", g_extendVotesCount.integer - level.extend_vote_count ) );
+  }
+  else if( g_extendVotesCount.integer - level.extend_vote_count == 1 )
+  {
+    AP( va( "print \"^7Only ^3%i^7 more extension vote may be called.\n\"", g_extendVotesCount.integer - level.extend_vote_count ) );
+  }
+  else
+  {
+    AP( va( "print \"^3This is your last extension vote, make it count!\n\"" ) );
+  }
+
+  Com_sprintf( call->voteString, call->voteStringSize,
+               "timelimit %i", g_timelimit.integer + g_extendVotesTime.integer );
+  Com_sprintf( call->displayString, call->displayStringSize,
+               "Extend the timelimit by %d minutes", g_extendVotesTime.integer );
+  return qtrue;
+}
+
+/*
+==================
+G_VoteCustom
+
+Anything not in the vote table is looked for in the g_customVote cvars
+==================
+*/
+static qboolean G_VoteCustom( voteCall_t *call )
+{
+  int i;
+  char customVoteKeys[ MAX_STRING_CHARS ];
+
+  customVoteKeys[ 0 ] = '\0';
+  if( g_customVotePercent.integer )
+  {
+    char text[ MAX_STRING_CHARS ];
+    char *votekey, *votemsg, *votecmd, *voteperc;
+    int votePValue;
+
+    text[ 0 ] = '\0';
+    for( i = 0; i < CUSTOM_VOTE_COUNT; i++ )
     {
-      Q_strncpyz( name, level.clients[ clientNum ].pers.netname,
-        sizeof( name ) );
-      Q_CleanStr( name );
-      if ( G_admin_permission ( &g_entities[ clientNum ], ADMF_IMMUNITY ) && g_entities[ clientNum ].client->pers.adminLevel >= ent->client->pers.adminLevel )
+      switch( i )
       {
-    char reasonprint[ MAX_STRING_CHARS ] = "";
+        case 0:
+          Q_strncpyz( text, g_customVote1.string, sizeof( text ) );
+          break;
+        case 1:
+          Q_strncpyz( text, g_customVote2.string, sizeof( text ) );
+          break;
+        case 2:
+          Q_strncpyz( text, g_customVote3.string, sizeof( text ) );
+          break;
+        case 3:
+          Q_strncpyz( text, g_customVote4.string, sizeof( text ) );
+          break;
+        case 4:
+          Q_strncpyz( text, g_customVote5.string, sizeof( text ) );
+          break;
+        case 5:
+          Q_strncpyz( text, g_customVote6.string, sizeof( text ) );
+          break;
+        case 6:
+          Q_strncpyz( text, g_customVote7.string, sizeof( text ) );
+          break;
+        case 7:
+          Q_strncpyz( text, g_customVote8.string, sizeof( text ) );
+          break;
+      }
+      if ( text[ 0 ] == '\0' )
+        continue;
 
-    if( reason[ 0 ] != '\0' )
-      Com_sprintf(reasonprint, sizeof(reasonprint), "With reason: %s", reason);
+      // custom vote cvar format:  "callvote_name,Vote message string,vote success command[,percent]"
+      votekey = text;
+      votemsg = strchr( votekey, ',' );
+      if( !votemsg || *votemsg != ',' )
+        continue;
+      *votemsg = '\0';
+      votemsg++;
+      Q_strcat( customVoteKeys, sizeof( customVoteKeys ),
+                va( "%s%s", ( customVoteKeys[ 0 ] == '\0' ) ? "" : ", ", votekey ) );
+      votecmd = strchr( votemsg, ',' );
+      if( !votecmd || *votecmd != ',' )
+        continue;
+      *votecmd = '\0';
+      votecmd++;
 
-        Com_sprintf( message, sizeof( message ), "%s^7 attempted /callvote %s %s on immune admin %s^7 %s^7",
-          ent->client->pers.netname, arg1, targetname, g_entities[ clientNum ].client->pers.netname, reasonprint );
+      voteperc = strchr( votecmd, ',' );
+      if( !voteperc || *voteperc != ',' )
+        votePValue = g_customVotePercent.integer;
+      else
+      {
+        *voteperc = '\0';
+        voteperc++;
+        votePValue = atoi( voteperc );
+        if( !votePValue )
+          votePValue = g_customVotePercent.integer;
       }
-    }
-    else
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callvote: invalid player\n\"" );
-      return;
+
+      if( Q_stricmp( call->arg1, votekey ) != 0 )
+        continue;
+      if( votemsg[ 0 ] == '\0' || votecmd[ 0 ] == '\0' )
+        continue;
+
+      level.votePassThreshold = votePValue;
+      Com_sprintf( call->voteString, call->voteStringSize, "%s", votecmd );
+      Com_sprintf( call->displayString, call->displayStringSize, "%s", votemsg );
+      return qtrue;
     }
   }
- 
-  if( !Q_stricmp( arg1, "kick" ) )
+
+  trap_SendServerCommand( call->ent-g_entities, "print \"Invalid vote string\n\"" );
+  trap_SendServerCommand( call->ent-g_entities, "print \"Valid vote commands are: "
+    "map, map_restart, draw, extend, nextmap, kick, spec, mute, unmute, poll, sudden_death, and delay_sudden_death (or delaysd)\n" );
+  if( customVoteKeys[ 0 ] != '\0' )
+    trap_SendServerCommand( call->ent-g_entities,
+      va( "print \"Additional custom vote commands: %s\n\"", customVoteKeys ) );
+  return qfalse;
+}
+
+/*
+==================
+G_TeamVoteKick
+==================
+*/
+static qboolean G_TeamVoteKick( voteCall_t *call )
+{
+  char n1[ MAX_NAME_LENGTH ];
+
+  if( G_VoteTargetImmune( call ) )
   {
-    char n1[ MAX_NAME_LENGTH ];
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callteamvote: admin is immune from vote kick\n\"" );
+    G_AdminsPrintf("%s\n",call->message);
+    G_admin_adminlog_log( call->ent, "teamvote", NULL, 0, qfalse );
+    return qfalse;
+  }
 
-    if( G_admin_permission( &g_entities[ clientNum ], ADMF_IMMUNITY ) && g_entities[ clientNum ].client->pers.adminLevel >= ent->client->pers.adminLevel )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callvote: admin is immune from vote kick\n\"" );
-      G_AdminsPrintf("%s\n",message);
-      G_admin_adminlog_log( ent, "vote", NULL, 0, qfalse );
-      return;
-    }
+  // use ip in case this player disconnects before the vote ends
+  Com_sprintf( call->voteString, call->voteStringSize,
+    "!ban %s \"%s\" team vote kick", level.clients[ call->clientNum ].pers.ip,
+    g_adminTempBan.string );
+  if( call->reason[0] )
+    Q_strcat( call->voteString, call->voteStringSize, va( ": \"%s\"", call->reason ) );
+  G_SanitiseString( call->ent->client->pers.netname, n1, sizeof( n1 ) );
+  Q_strcat( call->voteString, call->voteStringSize, va( ", \"%s\"", n1 ) );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "Kick player '%s'", call->name );
+
+  level.votePassThreshold = g_kickVotesPercent.integer;
+  return qtrue;
+}
 
-    // use ip in case this player disconnects before the vote ends
-    Com_sprintf( level.voteString, sizeof( level.voteString ),
-      "!ban %s \"%s\" vote kick", level.clients[ clientNum ].pers.ip,
-      g_adminTempBan.string );
-    if ( reason[0]!='\0' )
-      Q_strcat( level.voteString, sizeof( level.voteString ), va( ": \"%s^7\"", reason ) );
-    G_SanitiseString( ent->client->pers.netname, n1, sizeof( n1 ) );
-    Q_strcat( level.voteString, sizeof( level.voteString ), va( ", \"%s\"", n1 ) );
-    Com_sprintf( level.voteDisplayString, sizeof( level.voteDisplayString ),
-      "Kick player \'%s\'", name );
+/*
+==================
+G_TeamVoteDenyBuild
+==================
+*/
+static qboolean G_TeamVoteDenyBuild( voteCall_t *call )
+{
+  if( level.clients[ call->clientNum ].pers.denyBuild )
+  {
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callteamvote: player already lost building rights\n\"" );
+    return qfalse;
+  }
 
-    level.votePassThreshold = g_kickVotesPercent.integer;
+  if( G_VoteTargetImmune( call ) )
+  {
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callteamvote: admin is immune from denybuild\n\"" );
+    G_AdminsPrintf("%s\n",call->message);
+    G_admin_adminlog_log( call->ent, "teamvote", NULL, 0, qfalse );
+    return qfalse;
   }
-  else if( !Q_stricmp( arg1, "spec" ) )
+
+  Com_sprintf( call->voteString, call->voteStringSize, "!denybuild %i", call->clientNum );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "Take away building rights from '%s'", call->name );
+  return qtrue;
+}
+
+/*
+==================
+G_TeamVoteAllowBuild
+==================
+*/
+static qboolean G_TeamVoteAllowBuild( voteCall_t *call )
+{
+  if( !level.clients[ call->clientNum ].pers.denyBuild )
   {
-    if( G_admin_permission( &g_entities[ clientNum ], ADMF_IMMUNITY ) && g_entities[ clientNum ].client->pers.adminLevel >= ent->client->pers.adminLevel )
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callteamvote: player already has building rights\n\"" );
+    return qfalse;
+  }
+
+  Com_sprintf( call->voteString, call->voteStringSize, "!allowbuild %i", call->clientNum );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "Allow '%s' to build", call->name );
+  return qtrue;
+}
+
+/*
+==================
+G_TeamVoteDesignate
+==================
+*/
+static qboolean G_TeamVoteDesignate( voteCall_t *call )
+{
+  if( !g_designateVotes.integer )
+  {
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callteamvote: Designate votes have been disabled.\n\"" );
+    return qfalse;
+  }
+
+  if( level.clients[ call->clientNum ].pers.designatedBuilder )
+  {
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callteamvote: player is already a designated builder\n\"" );
+    return qfalse;
+  }
+
+  Com_sprintf( call->voteString, call->voteStringSize, "!designate %i", call->clientNum );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "Make '%s' a designated builder", call->name );
+  return qtrue;
+}
+
+/*
+==================
+G_TeamVoteUndesignate
+==================
+*/
+static qboolean G_TeamVoteUndesignate( voteCall_t *call )
+{
+  if( !g_designateVotes.integer )
+  {
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callteamvote: Designate votes have been disabled.\n\"" );
+    return qfalse;
+  }
+
+  if( !level.clients[ call->clientNum ].pers.designatedBuilder )
+  {
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callteamvote: player is not currently a designated builder\n\"" );
+    return qfalse;
+  }
+
+  Com_sprintf( call->voteString, call->voteStringSize, "!undesignate %i", call->clientNum );
+  Com_sprintf( call->displayString, call->displayStringSize,
+    "Remove designated builder status from '%s'", call->name );
+  return qtrue;
+}
+
+/*
+==================
+G_TeamVoteAdmitDefeat
+==================
+*/
+static qboolean G_TeamVoteAdmitDefeat( voteCall_t *call )
+{
+  if( call->numVoters <=1 )
+  {
+    trap_SendServerCommand( call->ent-g_entities,
+      "print \"callteamvote: You cannot admitdefeat by yourself. Use /callvote draw.\n\"" );
+    return qfalse;
+  }
+
+  Com_sprintf( call->voteString, call->voteStringSize, "admitdefeat %i", call->team );
+  Com_sprintf( call->displayString, call->displayStringSize, "Admit Defeat" );
+  return qtrue;
+}
+
+/*
+==================
+G_TeamVoteInvalid
+==================
+*/
+static qboolean G_TeamVoteInvalid( voteCall_t *call )
+{
+  trap_SendServerCommand( call->ent-g_entities, "print \"Invalid vote string\n\"" );
+  trap_SendServerCommand( call->ent-g_entities,
+     "print \"Valid team vote commands are: "
+     "kick, denybuild, allowbuild, poll, designate, undesignate, and admitdefeat\n\"" );
+  return qfalse;
+}
+
+static const voteInfo_t voteInfos[ ] =
+{
+  { "kick",               G_VoteKick,             VOTEF_TARGET | VOTEF_REASON },
+  { "spec",               G_VoteSpec,             VOTEF_TARGET },
+  { "mute",               G_VoteMute,             VOTEF_TARGET },
+  { "unmute",             G_VoteUnmute,           VOTEF_TARGET },
+  { "map_restart",        G_VoteMapRestart,       0 },
+  { "map",                G_VoteMap,              0 },
+  { "nextmap",            G_VoteNextMap,          0 },
+  { "draw",               G_VoteDraw,             0 },
+  { "poll",               G_VotePoll,             VOTEF_POLL },
+  { "sudden_death",       G_VoteSuddenDeath,      0 },
+  { "suddendeath",        G_VoteSuddenDeath,      0 },
+  { "delay_sudden_death", G_VoteDelaySuddenDeath, 0 },
+  { "delaysd",            G_VoteDelaySuddenDeath, 0 },
+  { "extend",             G_VoteExtend,           0 },
+  { NULL }
+};
+
+static const voteInfo_t teamVoteInfos[ ] =
+{
+  { "kick",               G_TeamVoteKick,         VOTEF_TARGET | VOTEF_REASON | VOTEF_ALERT },
+  { "denybuild",          G_TeamVoteDenyBuild,    VOTEF_TARGET | VOTEF_ALERT },
+  { "allowbuild",         G_TeamVoteAllowBuild,   VOTEF_TARGET },
+  { "designate",          G_TeamVoteDesignate,    VOTEF_TARGET },
+  { "undesignate",        G_TeamVoteUndesignate,  VOTEF_TARGET },
+  { "admitdefeat",        G_TeamVoteAdmitDefeat,  0 },
+  { "poll",               G_VotePoll,             VOTEF_POLL },
+  { NULL }
+};
+
+// what a name missing from the tables falls back to: the custom votes for
+// global votes, a list of the valid commands for team votes
+static const voteInfo_t customVoteInfo = { "", G_VoteCustom, 0 };
+static const voteInfo_t invalidTeamVoteInfo = { "", G_TeamVoteInvalid, 0 };
+
+#define VOTE_HASH_SIZE 32
+
+typedef struct
+{
+  const voteInfo_t  *slots[ VOTE_HASH_SIZE ];
+  qboolean          built;
+} voteHash_t;
+
+static voteHash_t voteHash, teamVoteHash;
+
+/*
+==================
+G_VoteHashValue
+==================
+*/
+static unsigned int G_VoteHashValue( const char *name )
+{
+  unsigned int hash = 0x811c9dc5u;
+
+  for( ; *name; name++ )
+  {
+    hash ^= (byte)tolower( *name );
+    hash *= 0x01000193u;
+  }
+
+  return hash;
+}
+
+/*
+==================
+G_FindVote
+
+Look up a vote type by name, building the hash table on first use
+==================
+*/
+static const voteInfo_t *G_FindVote( const voteInfo_t *infos, voteHash_t *hash,
+                                     const char *name, const voteInfo_t *fallback )
+{
+  const voteInfo_t  *vi;
+  unsigned int      i;
+  int               n;
+
+  if( !hash->built )
+  {
+    for( vi = infos; vi->name; vi++ )
     {
-          trap_SendServerCommand( ent-g_entities, "print \"callvote: admin is immune from vote spec\n\"" );
-          return;
+      i = G_VoteHashValue( vi->name );
+
+      for( n = 0; n < VOTE_HASH_SIZE; n++, i++ )
+      {
+        if( !hash->slots[ i & ( VOTE_HASH_SIZE - 1 ) ] )
+        {
+          hash->slots[ i & ( VOTE_HASH_SIZE - 1 ) ] = vi;
+          break;
+        }
+      }
+
+      if( n == VOTE_HASH_SIZE )
+        G_Error( "G_FindVote: VOTE_HASH_SIZE is too small" );
     }
-    Com_sprintf( level.voteString, sizeof( level.voteString ), "!putteam %i s %s", clientNum, g_adminTempSpec.string );
-    Com_sprintf( level.voteDisplayString, sizeof( level.voteDisplayString ), "Spec player \'%s\'", name );
 
+    hash->built = qtrue;
+  }
+
+  i = G_VoteHashValue( name );
+
+  for( n = 0; n < VOTE_HASH_SIZE; n++, i++ )
+  {
+    vi = hash->slots[ i & ( VOTE_HASH_SIZE - 1 ) ];
+
+    if( !vi )
+      break;
+
+    if( !Q_stricmp( vi->name, name ) )
+      return vi;
   }
-  else if( !Q_stricmp( arg1, "mute" ) )
+
+  return fallback;
+}
+
+/*
+==================
+G_SendVoteCounts
+
+Update the yes/no configstrings of the global vote (PTE_NONE) or a team
+vote, leaving alone any count that hasn't changed since it was last sent
+==================
+*/
+void G_SendVoteCounts( pTeam_t team )
+{
+  int cs_offset = ( team == PTE_ALIENS ) ? 1 : 0;
+
+  if( team == PTE_NONE )
   {
-    if( G_IsMuted( &level.clients[ clientNum ] ) )
+    if( level.voteYesSent != level.voteYes )
     {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callvote: player is already muted\n\"" );
-      return;
+      level.voteYesSent = level.voteYes;
+      trap_SetConfigstring( CS_VOTE_YES, va( "%i", level.voteYes ) );
     }
 
-    if( G_admin_permission( &g_entities[ clientNum ], ADMF_IMMUNITY ) && g_entities[ clientNum ].client->pers.adminLevel >= ent->client->pers.adminLevel )
+    if( level.voteNoSent != level.voteNo )
     {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callvote: admin is immune from vote mute\n\"" );
-      G_AdminsPrintf("%s\n",message);
-      G_admin_adminlog_log( ent, "vote", NULL, 0, qfalse );
-      return;
+      level.voteNoSent = level.voteNo;
+      trap_SetConfigstring( CS_VOTE_NO, va( "%i", level.voteNo ) );
     }
-    Com_sprintf( level.voteString, sizeof( level.voteString ),
-      "!mute %i %s", clientNum, g_adminTempMute.string );
-    Com_sprintf( level.voteDisplayString, sizeof( level.voteDisplayString ),
-      "Mute player \'%s\'", name );
   }
-  else if( !Q_stricmp( arg1, "unmute" ) )
+  else
   {
-    if( !G_IsMuted( &level.clients[ clientNum ] ) )
+    if( level.teamVoteYesSent[ cs_offset ] != level.teamVoteYes[ cs_offset ] )
     {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callvote: player is not currently muted\n\"" );
-      return;
+      level.teamVoteYesSent[ cs_offset ] = level.teamVoteYes[ cs_offset ];
+      trap_SetConfigstring( CS_TEAMVOTE_YES + cs_offset,
+        va( "%i", level.teamVoteYes[ cs_offset ] ) );
     }
-    Com_sprintf( level.voteString, sizeof( level.voteString ),
-      "!unmute %i", clientNum );
-    Com_sprintf( level.voteDisplayString, sizeof( level.voteDisplayString ),
-      "Un-Mute player \'%s\'", name );
-  }
-  else if( !Q_stricmp( arg1, "map_restart" ) )
-  {
-    if( g_mapvoteMaxTime.integer 
-      && (( level.time - level.startTime ) >= g_mapvoteMaxTime.integer * 1000 )
-      && !G_admin_permission( ent, ADMF_NO_VOTE_LIMIT ) 
-      && (level.numPlayingClients > 0 && level.numConnectedClients>1) )
+
+    if( level.teamVoteNoSent[ cs_offset ] != level.teamVoteNo[ cs_offset ] )
     {
-       trap_SendServerCommand( ent-g_entities, va(
-         "print \"You cannot call for a restart after %d seconds\n\"",
-         g_mapvoteMaxTime.integer ) );
-       G_admin_adminlog_log( ent, "vote", NULL, 0, qfalse );
-       return;
+      level.teamVoteNoSent[ cs_offset ] = level.teamVoteNo[ cs_offset ];
+      trap_SetConfigstring( CS_TEAMVOTE_NO + cs_offset,
+        va( "%i", level.teamVoteNo[ cs_offset ] ) );
     }
-    Com_sprintf( level.voteString, sizeof( level.voteString ), "%s", arg1 );
-    Com_sprintf( level.voteDisplayString,
-        sizeof( level.voteDisplayString ), "Restart current map" );
-    level.votePassThreshold = g_mapVotesPercent.integer;
   }
-  else if( !Q_stricmp( arg1, "map" ) )
+}
+
+/*
+==================
+G_StartVoteTally
+
+Reset the counts of a new vote and decide who may vote on it: every
+connected client for a global vote, the members of team for a team vote
+==================
+*/
+static void G_StartVoteTally( pTeam_t team )
+{
+  clientList_t  *eligible;
+  int           cs_offset = ( team == PTE_ALIENS ) ? 1 : 0;
+  int           i;
+
+  if( team == PTE_NONE )
+  {
+    eligible = &level.voteEligible;
+    level.voteYes = level.voteNo = 0;
+    level.voteYesSent = level.voteNoSent = -1;
+    memset( level.votedHow, 0, sizeof( level.votedHow ) );
+  }
+  else
   {
-    if( g_mapvoteMaxTime.integer 
-      && (( level.time - level.startTime ) >= g_mapvoteMaxTime.integer * 1000 )
-      && !G_admin_permission( ent, ADMF_NO_VOTE_LIMIT ) 
-      && (level.numPlayingClients > 0 && level.numConnectedClients>1) )
-    {
-       trap_SendServerCommand( ent-g_entities, va(
-         "print \"You cannot call for a mapchange after %d seconds\n\"",
-         g_mapvoteMaxTime.integer ) );
-       G_admin_adminlog_log( ent, "vote", NULL, 0, qfalse );
-       return;
-    }
-  
-    if( !G_MapExists( arg2 ) )
-    {
-      trap_SendServerCommand( ent - g_entities, va( "print \"callvote: "
-        "'maps/%s.bsp' could not be found on the server\n\"", arg2 ) );
+    eligible = &level.teamVoteEligible[ cs_offset ];
+    level.teamVoteYes[ cs_offset ] = level.teamVoteNo[ cs_offset ] = 0;
+    level.teamVoteYesSent[ cs_offset ] = level.teamVoteNoSent[ cs_offset ] = -1;
+    memset( level.teamVotedHow[ cs_offset ], 0, sizeof( level.teamVotedHow[ 0 ] ) );
+  }
+
+  memset( eligible, 0, sizeof( *eligible ) );
+
+  for( i = 0; i < level.maxclients; i++ )
+  {
+    if( level.clients[ i ].pers.connected != CON_CONNECTED )
+      continue;
+
+    if( team != PTE_NONE && level.clients[ i ].pers.teamSelection != team )
+      continue;
+
+    BG_ClientListAdd( eligible, i );
+  }
+}
+
+/*
+==================
+G_CastVote
+==================
+*/
+static void G_CastVote( int clientNum, pTeam_t team, qboolean yes )
+{
+  int cs_offset = ( team == PTE_ALIENS ) ? 1 : 0;
+
+  if( team == PTE_NONE )
+  {
+    level.votedHow[ clientNum ] = yes ? 1 : -1;
+    if( yes )
+      level.voteYes++;
+    else
+      level.voteNo++;
+  }
+  else
+  {
+    level.teamVotedHow[ cs_offset ][ clientNum ] = yes ? 1 : -1;
+    if( yes )
+      level.teamVoteYes[ cs_offset ]++;
+    else
+      level.teamVoteNo[ cs_offset ]++;
+  }
+
+  G_SendVoteCounts( team );
+}
+
+/*
+==================
+G_AllowVote
+
+Let a client who connected or joined team after a vote was called vote on it
+==================
+*/
+void G_AllowVote( int clientNum, pTeam_t team )
+{
+  int cs_offset = ( team == PTE_ALIENS ) ? 1 : 0;
+
+  if( team == PTE_NONE )
+  {
+    if( level.voteTime )
+      BG_ClientListAdd( &level.voteEligible, clientNum );
+  }
+  else if( level.teamVoteTime[ cs_offset ] )
+    BG_ClientListAdd( &level.teamVoteEligible[ cs_offset ], clientNum );
+}
+
+/*
+==================
+G_WithdrawVote
+
+Discard the vote of a client leaving the game (PTE_NONE) or team
+==================
+*/
+void G_WithdrawVote( int clientNum, pTeam_t team )
+{
+  int cs_offset = ( team == PTE_ALIENS ) ? 1 : 0;
+
+  if( team == PTE_NONE )
+  {
+    BG_ClientListRemove( &level.voteEligible, clientNum );
+
+    if( !level.voteTime || !level.votedHow[ clientNum ] )
       return;
-    }
 
-    if( !G_admin_permission( ent, ADMF_NO_VOTE_LIMIT ) && !map_is_votable( arg2 ) )
+    if( level.votedHow[ clientNum ] > 0 )
+      level.voteYes--;
+    else
+      level.voteNo--;
+
+    level.votedHow[ clientNum ] = 0;
+  }
+  else
+  {
+    BG_ClientListRemove( &level.teamVoteEligible[ cs_offset ], clientNum );
+
+    if( !level.teamVoteTime[ cs_offset ] || !level.teamVotedHow[ cs_offset ][ clientNum ] )
+      return;
+
+    if( level.teamVotedHow[ cs_offset ][ clientNum ] > 0 )
+      level.teamVoteYes[ cs_offset ]--;
+    else
+      level.teamVoteNo[ cs_offset ]--;
+
+    level.teamVotedHow[ cs_offset ][ clientNum ] = 0;
+  }
+
+  G_SendVoteCounts( team );
+}
+
+/*
+==================
+Cmd_CallVote_f
+==================
+*/
+void Cmd_CallVote_f( gentity_t *ent )
+{
+  int   skipargs = 0;
+  char  arg1[ MAX_STRING_TOKENS ];
+  char  arg2[ MAX_STRING_TOKENS ];
+  int   clientNum = -1;
+  char  name[ MAX_NETNAME ];
+  char *arg1plus;
+  char *arg2plus;
+  char  message[ MAX_STRING_CHARS ];
+  char  targetname[ MAX_NAME_LENGTH] = "";
+  char  reason[ MAX_STRING_CHARS ] = "";
+  char *ptr = NULL;
+  char  cmd[ 12 ];
+  const voteInfo_t *vote;
+  voteCall_t call;
+
+  G_SayArgv( 0, cmd, sizeof( cmd ) );
+
+  if( !Q_stricmp( cmd, "say" ) || !Q_stricmp( cmd, "say_team" ) )
+    skipargs = 1;
+
+  arg1plus = G_SayConcatArgs( 1 );
+  arg2plus = G_SayConcatArgs( 2 );
+  
+  // Invisible players cannot call votes
+  if( ent->client->sess.invisible == qtrue )
+  {
+    trap_SendServerCommand( ent-g_entities, "print \"You cannot call votes while invisible\n\"" );
+    return;
+  }
+
+  if( !g_allowVote.integer )
+  {
+    trap_SendServerCommand( ent-g_entities, "print \"Voting not allowed here\n\"" );
+    return;
+  }
+
+  // Flood limit.  If they're talking too fast, determine that and return.
+  if( g_floodMinTime.integer )
+    if ( G_Flood_Limited( ent ) )
     {
-      trap_SendServerCommand( ent - g_entities, va( "print \"callvote: "
-        "Only admins may call a vote for map: %s\n\"", arg2 ) );
+      trap_SendServerCommand( ent-g_entities, "print \"Your /callvote attempt is flood-limited; wait before chatting again\n\"" );
       return;
     }
 
-    Com_sprintf( level.voteString, sizeof( level.voteString ), "%s %s", arg1, arg2 );
-    Com_sprintf( level.voteDisplayString,
-        sizeof( level.voteDisplayString ), "Change to map '%s'", arg2 );
-    level.votePassThreshold = g_mapVotesPercent.integer;
+  //see if they can vote
+  if( G_admin_permission( ent, ADMF_NO_VOTE ) )
+  {
+    trap_SendServerCommand( ent-g_entities, "print \"You have no voting rights\n\"" );
+    return;
+  }
+
+  if( g_voteMinTime.integer
+    && ent->client->pers.firstConnect 
+    && level.time - ent->client->pers.enterTime < g_voteMinTime.integer * 1000
+    && !G_admin_permission( ent, ADMF_NO_VOTE_LIMIT ) 
+    && (level.numPlayingClients > 0 && level.numConnectedClients>1) )
+  {
+    trap_SendServerCommand( ent-g_entities, va(
+      "print \"You must wait %d seconds after connecting before calling a vote\n\"",
+      g_voteMinTime.integer ) );
+    return;
+  }
+
+  if( level.voteTime )
+  {
+    trap_SendServerCommand( ent-g_entities, "print \"A vote is already in progress\n\"" );
+    return;
+  }
+
+  if( g_voteLimit.integer > 0
+    && ent->client->pers.voteCount >= g_voteLimit.integer
+    && !G_admin_permission( ent, ADMF_NO_VOTE_LIMIT ) )
+  {
+    trap_SendServerCommand( ent-g_entities, va(
+      "print \"You have already called the maximum number of votes (%d)\n\"",
+      g_voteLimit.integer ) );
+    return;
+  }
+  
+  if( G_IsMuted( ent->client ) )
+  {
+    trap_SendServerCommand( ent - g_entities,
+      "print \"You are muted and cannot call votes\n\"" );
+    return;
   }
-  else if( !Q_stricmp( arg1, "nextmap" ) )
-  {
-    if( G_MapExists( g_nextMap.string ) )
-    {
-      trap_SendServerCommand( ent - g_entities, va( "print \"callvote: "
-        "the next map is already set to ^7'%s^7'\n\"", g_nextMap.string ) );
-      return;
-    }
-
-    if( !arg2[ 0 ] )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callvote: you must specify a map\n\"" );
-      return;
-    }
 
-    if( !G_MapExists( arg2 ) )
-    {
-      trap_SendServerCommand( ent - g_entities, va( "print \"callvote: "
-        "'maps/%s^7.bsp' could not be found on the server\n\"", arg2 ) );
-      return;
-    }
+  if( !G_admin_permission( ent, ADMF_NOSCRIMRESTRICTION ) && g_scrimMode.integer != 0 &&
+      ent->client->pers.teamSelection == PTE_NONE )
+  {
+    trap_SendServerCommand( ent - g_entities,
+      "print \"You can't call votes when scrim mode is enabled\n\"" );
+	return;
+  }
 
-    if( !G_admin_permission( ent, ADMF_NO_VOTE_LIMIT ) && !map_is_votable( arg2 ) )
-    {
-      trap_SendServerCommand( ent - g_entities, va( "print \"callvote: "
-        "Only admins may call a vote for map: %s\n\"", arg2 ) );
-      return;
-    }
+  // make sure it is a valid command to vote on
+  G_SayArgv( 1 + skipargs, arg1, sizeof( arg1 ) );
+  G_SayArgv( 2 + skipargs, arg2, sizeof( arg2 ) );
+  vote = G_FindVote( voteInfos, &voteHash, arg1, &customVoteInfo );
 
-    Com_sprintf( level.voteString, sizeof( level.voteString ),
-      "set g_nextMap %s", arg2 );
-    Com_sprintf( level.voteDisplayString,
-        sizeof( level.voteDisplayString ), "Set the next map to ^7'%s^7'", arg2 );
-    level.votePassThreshold = g_mapVotesPercent.integer;
-  }
-  else if( !Q_stricmp( arg1, "draw" ) )
+  if( strchr( arg1plus, ';' ) )
   {
-    Com_sprintf( level.voteString, sizeof( level.voteString ), "evacuation" );
-    Com_sprintf( level.voteDisplayString, sizeof( level.voteDisplayString ),
-        "End match in a draw" );
-    level.votePassThreshold = g_mapVotesPercent.integer;
+    trap_SendServerCommand( ent-g_entities, "print \"Invalid vote string\n\"" );
+    return;
   }
-   else if( !Q_stricmp( arg1, "poll" ) )
-    {
-      if( g_disablePollVotes.integer )
-      {
-        trap_SendServerCommand( ent-g_entities, "print \"callvote: Poll votes are currently disabled.\n\"" );
-        return;
-      }
-      if( arg2plus[ 0 ] == '\0' )
-      {
-        trap_SendServerCommand( ent-g_entities, "print \"callvote: You forgot to specify what people should vote on.\n\"" );
-        return;
-      }
-      level.voteString[ 0 ] = '\0';
-      Com_sprintf( level.voteDisplayString,
-          sizeof( level.voteDisplayString ), "[Poll] \'%s\'", arg2plus );
-   }
-  else if( !Q_stricmp( arg1, "sudden_death" ) ||
-    !Q_stricmp( arg1, "suddendeath" ) )
+
+  // if there is still a vote to be executed
+  if( level.voteExecuteTime )
   {
-    if(!g_suddenDeathVotePercent.integer)
-    {
-      trap_SendServerCommand( ent-g_entities, "print \"Sudden Death votes have been disabled\n\"" );
-      return;
-    } 
-    else if( g_suddenDeath.integer ) 
+    if( !Q_stricmp( level.voteString, "map_restart" ) )
     {
-      trap_SendServerCommand( ent - g_entities, va( "print \"callvote: Sudden Death has already begun\n\"") );
-      return;
+      G_admin_maplog_result( "r" );
     }
-    else if( G_TimeTilSuddenDeath() <= g_suddenDeathVoteDelay.integer * 1000 )
+    else if( !Q_stricmpn( level.voteString, "map", 3 ) )
     {
-      trap_SendServerCommand( ent - g_entities, va( "print \"callvote: Sudden Death is already immenent\n\"") );
-      return;
+      G_admin_maplog_result( "m" );
     }
-    else 
-    {
-      level.votePassThreshold = g_suddenDeathVotePercent.integer;
-      Com_sprintf( level.voteString, sizeof( level.voteString ), "suddendeath" );
-      Com_sprintf( level.voteDisplayString,
-          sizeof( level.voteDisplayString ), "Begin sudden death" );
 
-      if( g_suddenDeathVoteDelay.integer )
-        Q_strcat( level.voteDisplayString, sizeof( level.voteDisplayString ), va( " in %d seconds", g_suddenDeathVoteDelay.integer ) );
-
-    }
+    level.voteExecuteTime = 0;
+    trap_SendConsoleCommand( EXEC_APPEND, va( "%s\n", level.voteString ) );
+    G_RequestCvarUpdate( );
   }
-  else if( !Q_stricmp( arg1, "delay_sudden_death" ) || !Q_stricmp( arg1, "delaysd" ) )
+  
+  level.votePassThreshold=50;
+  
+  ptr = strstr(arg1plus, " -");
+  if( ptr )
   {
-    if(!g_suddenDeathExtensionTime.integer || !g_suddenDeathExtensionPercent.integer)
-    {
-      trap_SendServerCommand( ent-g_entities, "print \"Sudden Death extension votes have been disabled\n\"" );
-      return;
-    } 
-    else if( g_suddenDeath.integer ) 
-    {
-      trap_SendServerCommand( ent - g_entities, va( "print \"callvote: Sudden Death has already begun\n\"") );
-      return;
-    }
-    else if( G_TimeTilSuddenDeath() >= g_suddenDeathExtensionTime.integer * 60000 )
+    *ptr = '\0';
+    ptr+=2; 
+
+    if( *ptr == 'r' || *ptr=='R' )
     {
-      trap_SendServerCommand( ent - g_entities, va( "print \"callvote: Wait until Sudden Death is close...\n\"") );
-      return;
+      ptr++;
+      while( *ptr == ' ' )
+        ptr++;
+      strcpy(reason, ptr);
     }
-    else 
+    else
     {
-      level.votePassThreshold = g_suddenDeathExtensionPercent.integer;
-      Com_sprintf( level.voteString, sizeof( level.voteString ), "delay_sudden_death" );
-      Com_sprintf( level.voteDisplayString,
-          sizeof( level.voteDisplayString ), "Delay sudden death by %i minutes", g_suddenDeathExtensionTime.integer );
+      trap_SendServerCommand( ent-g_entities, "print \"callvote: Warning: invalid argument specified \n\"" );
     }
   }
-  else if( !Q_stricmp( arg1, "extend" ) )
+
+  // detect clientNum for partial name match votes
+  if( vote->flags & VOTEF_TARGET )
   {
-    if( !g_extendVotesPercent.integer )
+    int clientNums[ MAX_CLIENTS ] = { -1 };
+    int numMatches=0;
+    char err[ MAX_STRING_CHARS ] = "";
+    
+    Q_strncpyz(targetname, arg2plus, sizeof(targetname));
+    ptr = strstr(targetname, " -");
+    if( ptr )
+      *ptr = '\0';
+    
+    if( g_requireVoteReasons.integer && !G_admin_permission( ent, ADMF_UNACCOUNTABLE ) && ( vote->flags & VOTEF_REASON ) && reason[ 0 ]=='\0' )
     {
-      trap_SendServerCommand( ent-g_entities, "print \"Extend votes have been disabled\n\"" );
-      return;
+       trap_SendServerCommand( ent-g_entities, "print \"callvote: You must specify a reason. Use /callvote kick [player] -r [reason] \n\"" );
+       return;
     }
-    if( g_extendVotesCount.integer
-        && level.extend_vote_count >= g_extendVotesCount.integer )
+    
+    if( !targetname[ 0 ] )
     {
-      trap_SendServerCommand( ent-g_entities, va( "print \"callvote: Maximum number of %d extend votes has been reached\n\"", g_extendVotesCount.integer ) );
-      return;
-    }
-    if( !g_timelimit.integer ) {
-      trap_SendServerCommand( ent-g_entities, "print \"This match has no timelimit so extend votes wont work\n\"" );
+      trap_SendServerCommand( ent-g_entities,
+        "print \"callvote: no target\n\"" );
       return;
     }
-    if( level.time - level.startTime <
-        ( g_timelimit.integer - g_extendVotesTime.integer ) * 60000 )
+
+    numMatches = G_ClientNumbersFromString( targetname, clientNums );
+    if( numMatches == 1 )
     {
-      trap_SendServerCommand( ent-g_entities, va( "print \"callvote: Extend votes only allowed with less than %d minutes remaining\n\"", g_extendVotesTime.integer ) );
-      return;
+      // there was only one partial name match
+      clientNum = clientNums[ 0 ]; 
     }
-    level.extend_vote_count++;
-    level.votePassThreshold = g_extendVotesPercent.integer; 
-
-    if( ( g_extendVotesCount.integer - level.extend_vote_count ) > 1 )
+    else
     {
-      AP( va( "print \"^7Only ^3%i^7 more extension votes may be called.\n\"", g_extendVotesCount.integer - level.extend_vote_count ) );
+      // look for an exact name match (sets clientNum to -1 if it fails) 
+      clientNum = G_ClientNumberFromString( ent, targetname );
     }
-    else if( g_extendVotesCount.integer - level.extend_vote_count == 1 )
+    
+    if( clientNum==-1  && numMatches > 1 ) 
     {
-      AP( va( "print \"^7Only ^3%i^7 more extension vote may be called.\n\"", g_extendVotesCount.integer - level.extend_vote_count ) );
+      G_MatchOnePlayer( clientNums, err, sizeof( err ) );
+      ADMP( va( "^3callvote: ^7%s\n", err ) );
+      return;
     }
-    else
+    
+    if( clientNum != -1 &&
+        level.clients[ clientNum ].pers.connected != CON_CONNECTED )
     {
-      AP( va( "print \"^3This is your last extension vote, make it count!\n\"" ) );
+      clientNum = -1;
     }
 
-    Com_sprintf( level.voteString, sizeof( level.voteString ),
-                 "timelimit %i", g_timelimit.integer + g_extendVotesTime.integer );
-    Com_sprintf( level.voteDisplayString, sizeof( level.voteDisplayString ),
-                 "Extend the timelimit by %d minutes", g_extendVotesTime.integer );
-  }
-  else
-  {
-    qboolean match = qfalse;
-    char customVoteKeys[ MAX_STRING_CHARS ];
-
-    customVoteKeys[ 0 ] = '\0';
-    if( g_customVotePercent.integer )
+    if( clientNum != -1 )
     {
-      char text[ MAX_STRING_CHARS ];
-      char *votekey, *votemsg, *votecmd, *voteperc;
-      int votePValue;
-
-      text[ 0 ] = '\0';
-      for( i = 0; i < CUSTOM_VOTE_COUNT; i++ )
+      Q_strncpyz( name, level.clients[ clientNum ].pers.netname,
+        sizeof( name ) );
+      Q_CleanStr( name );
+      if ( G_admin_permission ( &g_entities[ clientNum ], ADMF_IMMUNITY ) && g_entities[ clientNum ].client->pers.adminLevel >= ent->client->pers.adminLevel )
       {
-        switch( i )
-        {
-          case 0:
-            Q_strncpyz( text, g_customVote1.string, sizeof( text ) );
-            break;
-          case 1:
-            Q_strncpyz( text, g_customVote2.string, sizeof( text ) );
-            break;
-          case 2:
-            Q_strncpyz( text, g_customVote3.string, sizeof( text ) );
-            break;
-          case 3:
-            Q_strncpyz( text, g_customVote4.string, sizeof( text ) );
-            break;
-          case 4:
-            Q_strncpyz( text, g_customVote5.string, sizeof( text ) );
-            break;
-          case 5:
-            Q_strncpyz( text, g_customVote6.string, sizeof( text ) );
-            break;
-          case 6:
-            Q_strncpyz( text, g_customVote7.string, sizeof( text ) );
-            break;
-          case 7:
-            Q_strncpyz( text, g_customVote8.string, sizeof( text ) );
-            break;
-        }
-        if ( text[ 0 ] == '\0' )
-          continue;
-
-        // custom vote cvar format:  "callvote_name,Vote message string,vote success command[,percent]"
-        votekey = text;
-        votemsg = strchr( votekey, ',' );
-        if( !votemsg || *votemsg != ',' )
-          continue;
-        *votemsg = '\0';
-        votemsg++;
-        Q_strcat( customVoteKeys, sizeof( customVoteKeys ),
-                  va( "%s%s", ( customVoteKeys[ 0 ] == '\0' ) ? "" : ", ", votekey ) );
-        votecmd = strchr( votemsg, ',' );
-        if( !votecmd || *votecmd != ',' )
-          continue;
-        *votecmd = '\0';
-        votecmd++;
-
-        voteperc = strchr( votecmd, ',' );
-        if( !voteperc || *voteperc != ',' )
-          votePValue = g_customVotePercent.integer;
-        else
-        {
-          *voteperc = '\0';
-          voteperc++;
-          votePValue = atoi( voteperc );
-          if( !votePValue )
-            votePValue = g_customVotePercent.integer;
-        }
+    char reasonprint[ MAX_STRING_CHARS ] = "";
 
-        if( Q_stricmp( arg1, votekey ) != 0 )
-          continue;
-        if( votemsg[ 0 ] == '\0' || votecmd[ 0 ] == '\0' )
-          continue;
+    if( reason[ 0 ] != '\0' )
+      Com_sprintf(reasonprint, sizeof(reasonprint), "With reason: %s", reason);
 
-        level.votePassThreshold = votePValue;
-        Com_sprintf( level.voteString, sizeof( level.voteString ), "%s", votecmd );
-        Com_sprintf( level.voteDisplayString, sizeof( level.voteDisplayString ), "%s", votemsg );
-        match = qtrue;
-        break;
+        Com_sprintf( message, sizeof( message ), "%s^7 attempted /callvote %s %s on immune admin %s^7 %s^7",
+          ent->client->pers.netname, arg1, targetname, g_entities[ clientNum ].client->pers.netname, reasonprint );
       }
-   }
-
-    if( !match )
+    }
+    else
     {
-      trap_SendServerCommand( ent-g_entities, "print \"Invalid vote string\n\"" );
-      trap_SendServerCommand( ent-g_entities, "print \"Valid vote commands are: "
-        "map, map_restart, draw, extend, nextmap, kick, spec, mute, unmute, poll, sudden_death, and delay_sudden_death (or delaysd)\n" );
-      if( customVoteKeys[ 0 ] != '\0' )
-        trap_SendServerCommand( ent-g_entities,
-          va( "print \"Additional custom vote commands: %s\n\"", customVoteKeys ) );
+      trap_SendServerCommand( ent-g_entities,
+        "print \"callvote: invalid player\n\"" );
       return;
     }
   }
-  
+ 
+  call.ent = ent;
+  call.team = PTE_NONE;
+  call.numVoters = 0;
+  call.arg1 = arg1;
+  call.arg2 = arg2;
+  call.arg2plus = arg2plus;
+  call.clientNum = clientNum;
+  call.name = name;
+  call.reason = reason;
+  call.message = message;
+  call.voteString = level.voteString;
+  call.voteStringSize = sizeof( level.voteString );
+  call.displayString = level.voteDisplayString;
+  call.displayStringSize = sizeof( level.voteDisplayString );
+
+  if( !vote->func( &call ) )
+    return;
+
   if( level.votePassThreshold!=50 )
   {
     Q_strcat( level.voteDisplayString, sizeof( level.voteDisplayString ), va( "^7 (Needs > ^A%d^7 percent)", level.votePassThreshold ) );
@@ -2165,24 +2775,15 @@ void Cmd_CallVote_f( gentity_t *ent )
 
   // start the voting, the caller autoamtically votes yes
   level.voteTime = level.time;
-  level.voteNo = 0;
-
-  memset( level.votedHow, 0, sizeof( level.votedHow ) );
-
-  if( !Q_stricmp( arg1, "poll" ) )
-  {
-    level.voteYes = 0;
-  }
-  else
-  {
-    level.votedHow[ ent - g_entities ] = 1;
-    level.voteYes = 1;
-  }
+  G_StartVoteTally( PTE_NONE );
 
   trap_SetConfigstring( CS_VOTE_TIME, va( "%i", level.voteTime ) );
   trap_SetConfigstring( CS_VOTE_STRING, level.voteDisplayString );
-  trap_SetConfigstring( CS_VOTE_YES, va( "%i", level.voteYes ) );
-  trap_SetConfigstring( CS_VOTE_NO, va( "%i", level.voteNo ) );
+
+  if( vote->flags & VOTEF_POLL )
+    G_SendVoteCounts( PTE_NONE );
+  else
+    G_CastVote( ent - g_entities, PTE_NONE, qtrue );
 }
 
 
@@ -2218,7 +2819,7 @@ void Cmd_Vote_f( gentity_t *ent )
         cs_offset = 1;
     
       if( level.teamVoteTime[ cs_offset ] &&
-          !level.teamVotedHow[ cs_offset ][ g_entities - ent ] )
+          !level.teamVotedHow[ cs_offset ][ ent - g_entities ] )
       {
         Cmd_TeamVote_f(ent); 
         return;
@@ -2234,20 +2835,22 @@ void Cmd_Vote_f( gentity_t *ent )
     return;
   }
 
+  if( !BG_ClientListTest( &level.voteEligible, ent - g_entities ) )
+  {
+    trap_SendServerCommand( ent-g_entities, "print \"You can't vote on this vote\n\"" );
+    return;
+  }
+
   trap_Argv( 1, msg, sizeof( msg ) );
 
   if( msg[ 0 ] == 'y' || msg[ 1 ] == 'Y' || msg[ 1 ] == '1' )
   {
-    level.voteYes++;
-	level.votedHow[ ent - g_entities ] = 1;
-    trap_SetConfigstring( CS_VOTE_YES, va( "%i", level.voteYes ) );
+    G_CastVote( ent - g_entities, PTE_NONE, qtrue );
     trap_SendServerCommand( ent-g_entities, "print \"^3/vote: ^7vote cast: ^ZYes\n\"" );
   }
   else
   {
-    level.voteNo++;
-	level.votedHow[ ent - g_entities ] = -1;
-    trap_SetConfigstring( CS_VOTE_NO, va( "%i", level.voteNo ) );
+    G_CastVote( ent - g_entities, PTE_NONE, qfalse );
     trap_SendServerCommand( ent-g_entities, "print \"^3/vote: ^7vote cast: ^ANo\n\"" );
   }
 
@@ -2276,6 +2879,8 @@ void Cmd_CallTeamVote_f( gentity_t *ent )
   char *ptr = NULL;
   int   numVoters = 0;
   char  cmd[ 12 ];
+  const voteInfo_t *vote;
+  voteCall_t call;
 
   G_SayArgv( 0, cmd, sizeof( cmd ) );
 
@@ -2287,6 +2892,14 @@ void Cmd_CallTeamVote_f( gentity_t *ent )
   
   team = ent->client->pers.teamSelection;
 
+  // the say path doesn't go through the CMD_TEAM check, and a team vote
+  // with no team would run the global vote's tally
+  if( team == PTE_NONE )
+  {
+    trap_SendServerCommand( ent-g_entities, "print \"Join a team first\n\"" );
+    return;
+  }
+
   if( team == PTE_ALIENS )
     cs_offset = 1;
 
@@ -2346,6 +2959,8 @@ void Cmd_CallTeamVote_f( gentity_t *ent )
   // make sure it is a valid command to vote on
   G_SayArgv( 1 + skipargs, arg1, sizeof( arg1 ) );
   G_SayArgv( 2 + skipargs, arg2, sizeof( arg2 ) );
+  vote = G_FindVote( teamVoteInfos, &teamVoteHash, arg1,
+                     &invalidTeamVoteInfo );
 
   if( strchr( arg1plus, ';' ) )
   {
@@ -2373,11 +2988,7 @@ void Cmd_CallTeamVote_f( gentity_t *ent )
   }
   
   // detect clientNum for partial name match votes
-  if( !Q_stricmp( arg1, "kick" ) ||
-    !Q_stricmp( arg1, "denybuild" ) ||
-    !Q_stricmp( arg1, "allowbuild" ) || 
-    !Q_stricmp( arg1, "designate" ) || 
-    !Q_stricmp( arg1, "undesignate" ) )
+  if( vote->flags & VOTEF_TARGET )
   {
     int clientNums[ MAX_CLIENTS ] = { -1 };
     int numMatches=0;
@@ -2388,7 +2999,7 @@ void Cmd_CallTeamVote_f( gentity_t *ent )
     if( ptr )
       *ptr = '\0';
     
-    if( g_requireVoteReasons.integer && !G_admin_permission( ent, ADMF_UNACCOUNTABLE ) && !Q_stricmp( arg1, "kick" ) && reason[ 0 ]=='\0' )
+    if( g_requireVoteReasons.integer && !G_admin_permission( ent, ADMF_UNACCOUNTABLE ) && ( vote->flags & VOTEF_REASON ) && reason[ 0 ]=='\0' )
     {
        trap_SendServerCommand( ent-g_entities, "print \"callvote: You must specify a reason. Use /callteamvote kick [player] -r [reason] \n\"" );
        return;
@@ -2458,153 +3069,24 @@ void Cmd_CallTeamVote_f( gentity_t *ent )
     }
   }
 
-  if( !Q_stricmp( arg1, "kick" ) )
-  {
-    char n1[ MAX_NAME_LENGTH ];
-
-    if( G_admin_permission( &g_entities[ clientNum ], ADMF_IMMUNITY ) && g_entities[ clientNum ].client->pers.adminLevel >= ent->client->pers.adminLevel )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callteamvote: admin is immune from vote kick\n\"" );
-      G_AdminsPrintf("%s\n",message);
-      G_admin_adminlog_log( ent, "teamvote", NULL, 0, qfalse );
-      return;
-    }
-
-
-    // use ip in case this player disconnects before the vote ends
-    Com_sprintf( level.teamVoteString[ cs_offset ],
-      sizeof( level.teamVoteString[ cs_offset ] ),
-      "!ban %s \"%s\" team vote kick", level.clients[ clientNum ].pers.ip,
-      g_adminTempBan.string );
-    if( reason[0] )
-      Q_strcat( level.teamVoteString[ cs_offset ], sizeof( level.teamVoteString[ cs_offset ] ),
-        va( ": \"%s\"", reason ) );
-    G_SanitiseString( ent->client->pers.netname, n1, sizeof( n1 ) );
-    Q_strcat( level.teamVoteString[ cs_offset ], sizeof( level.teamVoteString[ cs_offset ] ),
-      va( ", \"%s\"", n1 ) );
-    Com_sprintf( level.teamVoteDisplayString[ cs_offset ],
-        sizeof( level.teamVoteDisplayString[ cs_offset ] ),
-        "Kick player '%s'", name );
-
-    level.votePassThreshold = g_kickVotesPercent.integer;
-  }
-  else if( !Q_stricmp( arg1, "denybuild" ) )
-  {
-    if( level.clients[ clientNum ].pers.denyBuild )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callteamvote: player already lost building rights\n\"" );
-      return;
-    }
-
-    if( G_admin_permission( &g_entities[ clientNum ], ADMF_IMMUNITY ) && g_entities[ clientNum ].client->pers.adminLevel >= ent->client->pers.adminLevel )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callteamvote: admin is immune from denybuild\n\"" );
-      G_AdminsPrintf("%s\n",message);
-      G_admin_adminlog_log( ent, "teamvote", NULL, 0, qfalse );
-      return;
-    }
-
-    Com_sprintf( level.teamVoteString[ cs_offset ],
-      sizeof( level.teamVoteString[ cs_offset ] ), "!denybuild %i", clientNum );
-    Com_sprintf( level.teamVoteDisplayString[ cs_offset ],
-        sizeof( level.teamVoteDisplayString[ cs_offset ] ),
-        "Take away building rights from '%s'", name );
-  }
-  else if( !Q_stricmp( arg1, "allowbuild" ) )
-  {
-    if( !level.clients[ clientNum ].pers.denyBuild )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callteamvote: player already has building rights\n\"" );
-      return;
-    }
-
-    Com_sprintf( level.teamVoteString[ cs_offset ],
-      sizeof( level.teamVoteString[ cs_offset ] ), "!allowbuild %i", clientNum );
-    Com_sprintf( level.teamVoteDisplayString[ cs_offset ],
-        sizeof( level.teamVoteDisplayString[ cs_offset ] ),
-        "Allow '%s' to build", name );
-  }
-  else if( !Q_stricmp( arg1, "designate" ) )
-  {
-    if( !g_designateVotes.integer )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callteamvote: Designate votes have been disabled.\n\"" );
-      return;
-    }
-
-    if( level.clients[ clientNum ].pers.designatedBuilder )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callteamvote: player is already a designated builder\n\"" );
-      return;
-    }
-    Com_sprintf( level.teamVoteString[ cs_offset ],
-      sizeof( level.teamVoteString[ cs_offset ] ), "!designate %i", clientNum );
-    Com_sprintf( level.teamVoteDisplayString[ cs_offset ],
-        sizeof( level.teamVoteDisplayString[ cs_offset ] ),
-        "Make '%s' a designated builder", name );
-  }
-  else if( !Q_stricmp( arg1, "undesignate" ) )
-  {
-
-    if( !g_designateVotes.integer )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callteamvote: Designate votes have been disabled.\n\"" );
-      return;
-    }
-
-    if( !level.clients[ clientNum ].pers.designatedBuilder )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callteamvote: player is not currently a designated builder\n\"" );
-      return;
-    }
-    Com_sprintf( level.teamVoteString[ cs_offset ],
-      sizeof( level.teamVoteString[ cs_offset ] ), "!undesignate %i", clientNum );
-    Com_sprintf( level.teamVoteDisplayString[ cs_offset ],
-        sizeof( level.teamVoteDisplayString[ cs_offset ] ),
-        "Remove designated builder status from '%s'", name );
-  }
-  else if( !Q_stricmp( arg1, "admitdefeat" ) )
-  {
-    if( numVoters <=1 )
-    {
-      trap_SendServerCommand( ent-g_entities,
-        "print \"callteamvote: You cannot admitdefeat by yourself. Use /callvote draw.\n\"" );
-      return;
-    }
+  call.ent = ent;
+  call.team = team;
+  call.numVoters = numVoters;
+  call.arg1 = arg1;
+  call.arg2 = arg2;
+  call.arg2plus = arg2plus;
+  call.clientNum = clientNum;
+  call.name = name;
+  call.reason = reason;
+  call.message = message;
+  call.voteString = level.teamVoteString[ cs_offset ];
+  call.voteStringSize = sizeof( level.teamVoteString[ cs_offset ] );
+  call.displayString = level.teamVoteDisplayString[ cs_offset ];
+  call.displayStringSize = sizeof( level.teamVoteDisplayString[ cs_offset ] );
 
-    Com_sprintf( level.teamVoteString[ cs_offset ],
-      sizeof( level.teamVoteString[ cs_offset ] ), "admitdefeat %i", team );
-    Com_sprintf( level.teamVoteDisplayString[ cs_offset ],
-        sizeof( level.teamVoteDisplayString[ cs_offset ] ),
-        "Admit Defeat" );
-  }
-   else if( !Q_stricmp( arg1, "poll" ) )
-   {
-     if( arg2plus[ 0 ] == '\0' )
-     {
-       trap_SendServerCommand( ent-g_entities, "print \"callteamvote: You forgot to specify what people should vote on.\n\"" );
-       return;
-     }
-     level.teamVoteString[ cs_offset ][ 0 ] = '\0';
-     Com_sprintf( level.teamVoteDisplayString[ cs_offset ],
-         sizeof( level.voteDisplayString ), "[Poll] \'%s\'", arg2plus );
-   }
-  else
-  {
-    trap_SendServerCommand( ent-g_entities, "print \"Invalid vote string\n\"" );
-    trap_SendServerCommand( ent-g_entities,
-       "print \"Valid team vote commands are: "
-       "kick, denybuild, allowbuild, poll, designate, undesignate, and admitdefeat\n\"" );
+  if( !vote->func( &call ) )
     return;
-  }
+
   ent->client->pers.voteCount++;
 
   G_admin_adminlog_log( ent, "teamvote", arg1, 0, qtrue );
@@ -2626,7 +3108,7 @@ void Cmd_CallTeamVote_f( gentity_t *ent )
             "called a ^5team ^7vote:\n%s^7 \n\"", ent->client->pers.netname, level.teamVoteDisplayString[ cs_offset ] ) );
     }
     else if( G_admin_permission( &g_entities[ i ], ADMF_ADMINCHAT ) && 
-             ( ( !Q_stricmp( arg1, "kick" ) || !Q_stricmp( arg1, "denybuild" ) ) || 
+             ( ( vote->flags & VOTEF_ALERT ) || 
              level.clients[ i ].pers.teamSelection == PTE_NONE ) )
     {
       trap_SendServerCommand( i, va("print \"^7[^fADMIN ALERT^7] %s " S_COLOR_WHITE
@@ -2643,24 +3125,15 @@ void Cmd_CallTeamVote_f( gentity_t *ent )
 
   // start the voting, the caller autoamtically votes yes
   level.teamVoteTime[ cs_offset ] = level.time;
-  level.teamVoteNo[ cs_offset ] = 0;
-
-  memset( level.teamVotedHow[ cs_offset ], 0, sizeof( level.teamVotedHow[ 0 ] ));
-
-  if( !Q_stricmp( arg1, "poll" ) )
-  {
-    level.teamVoteYes[ cs_offset ] = 0;
-  }
-  else
-  {
-    level.teamVotedHow[ cs_offset ][ ent - g_entities ] = 1;
-    level.teamVoteYes[ cs_offset ] = 1;
-  }
+  G_StartVoteTally( team );
 
   trap_SetConfigstring( CS_TEAMVOTE_TIME + cs_offset, va( "%i", level.teamVoteTime[ cs_offset ] ) );
   trap_SetConfigstring( CS_TEAMVOTE_STRING + cs_offset, level.teamVoteDisplayString[ cs_offset ] );
-  trap_SetConfigstring( CS_TEAMVOTE_YES + cs_offset, va( "%i", level.teamVoteYes[ cs_offset ] ) );
-  trap_SetConfigstring( CS_TEAMVOTE_NO + cs_offset, va( "%i", level.teamVoteNo[ cs_offset ] ) );
+
+  if( vote->flags & VOTEF_POLL )
+    G_SendVoteCounts( team );
+  else
+    G_CastVote( ent - g_entities, team, qtrue );
 }
 
 
@@ -2689,20 +3162,22 @@ void Cmd_TeamVote_f( gentity_t *ent )
     return;
   }
 
+  if( !BG_ClientListTest( &level.teamVoteEligible[ cs_offset ], ent - g_entities ) )
+  {
+    trap_SendServerCommand( ent-g_entities, "print \"You can't vote on this team vote\n\"" );
+    return;
+  }
+
   trap_Argv( 1, msg, sizeof( msg ) );
 
   if( msg[ 0 ] == 'y' || msg[ 1 ] == 'Y' || msg[ 1 ] == '1' )
   {
-    level.teamVotedHow[ cs_offset ][ ent - g_entities ] = 1;
-    level.teamVoteYes[ cs_offset ]++;
-    trap_SetConfigstring( CS_TEAMVOTE_YES + cs_offset, va( "%i", level.teamVoteYes[ cs_offset ] ) );
+    G_CastVote( ent - g_entities, ent->client->pers.teamSelection, qtrue );
     trap_SendServerCommand( ent-g_entities, "print \"^3/teamvote: ^7vote cast: ^ZYes\n\"" );
   }
   else
   {
-    level.teamVotedHow[ cs_offset ][ ent - g_entities ] = -1;
-    level.teamVoteNo[ cs_offset ]++;
-    trap_SetConfigstring( CS_TEAMVOTE_NO + cs_offset, va( "%i", level.teamVoteNo[ cs_offset ] ) );
+    G_CastVote( ent - g_entities, ent->client->pers.teamSelection, qfalse );
     trap_SendServerCommand( ent-g_entities, "print \"^3/teamvote: ^7vote cast: ^ANo\n\"" );
   }
 
@@ -3171,6 +3646,7 @@ void Cmd_Destroy_f( gentity_t *ent )
       if( g_markDeconstruct.integer == 1 && traceEnt->deconstruct )
       {
         traceEnt->deconstruct = qfalse;
+        level.buildableGeneration++;
         return;
       }
       if( ( traceEnt->s.eFlags & EF_DBUILDER ) &&
@@ -3239,6 +3715,7 @@ void Cmd_Destroy_f( gentity_t *ent )
         if( g_markDeconstruct.integer == 1 )
         {
           traceEnt->deconstruct     = qtrue; // Mark buildable for deconstruction
+          level.buildableGeneration++;
           traceEnt->deconstructTime = level.time;
         }
         else
@@ -3361,6 +3838,7 @@ void Cmd_Mark_f( gentity_t *ent )
       if( traceEnt->deconstruct )
       {
         traceEnt->deconstruct = qfalse;
+        level.buildableGeneration++;
 
         trap_SendServerCommand( ent-g_entities,
           va( "print \"%s no longer marked for deconstruction\n\"",
@@ -3386,6 +3864,7 @@ void Cmd_Mark_f( gentity_t *ent )
       if( traceEnt->health > 0 )
       {
         traceEnt->deconstruct     = qtrue; // Mark buildable for deconstruction
+        level.buildableGeneration++;
         traceEnt->deconstructTime = level.time;
 
         trap_SendServerCommand( ent-g_entities,
@@ -4078,6 +4557,7 @@ void Cmd_Protect_f( gentity_t *ent )
 
       // adding protection turns off deconstruction mark
       traceEnt->deconstruct = qfalse;
+      level.buildableGeneration++;
     }
   }
 }
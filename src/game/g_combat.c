@@ -29,6 +29,11 @@ int             g_numDamageRegions[ PCL_NUM_CLASSES ];
 armourRegion_t  g_armourRegions[ UP_NUM_UPGRADES ][ MAX_ARMOUR_REGIONS ];
 int             g_numArmourRegions[ UP_NUM_UPGRADES ];
 
+// compiled regions, [ 1 ] applies while crouching
+static locDamageTable_t g_damageTables[ PCL_NUM_CLASSES ][ 2 ];
+static locDamageTable_t g_armourTables[ UP_NUM_UPGRADES ][ 2 ];
+static float            g_armourAverages[ UP_NUM_UPGRADES ];
+
 /*
 ============
 AddScore
@@ -760,6 +765,216 @@ finish_dying: // from MOD_SLAP
 
 ////////TA: locdamage
 
+/*
+===============
+G_RegionAppliesAtHeight
+===============
+*/
+static qboolean G_RegionAppliesAtHeight( const damageRegion_t *region, float hitRatio )
+{
+  return ( hitRatio >= region->minHeight && hitRatio <= region->maxHeight );
+}
+
+/*
+===============
+G_RegionAppliesAtAngle
+===============
+*/
+static qboolean G_RegionAppliesAtAngle( const damageRegion_t *region, int hitRotation )
+{
+  if( region->minAngle > region->maxAngle )
+  {
+    return ( hitRotation >= region->minAngle && hitRotation <= 360 ) ||
+           ( hitRotation >= 0 && hitRotation <= region->maxAngle );
+  }
+
+  return ( hitRotation >= region->minAngle && hitRotation <= region->maxAngle );
+}
+
+/*
+===============
+G_FindRegionMask
+
+Find mask among masks, adding it if it isn't there
+===============
+*/
+static int G_FindRegionMask( int *masks, int *numMasks, int mask )
+{
+  int i;
+
+  for( i = 0; i < *numMasks; i++ )
+  {
+    if( masks[ i ] == mask )
+      return i;
+  }
+
+  masks[ ( *numMasks )++ ] = mask;
+  return i;
+}
+
+/*
+===============
+G_CompileLocDamage
+
+Turn the regions that apply when crouching (or not) into a lookup table
+===============
+*/
+static void G_CompileLocDamage( const damageRegion_t *regions, int numRegions,
+                                qboolean crouch, locDamageTable_t *table )
+{
+  int   rowMasks[ LOCDAMAGE_HEIGHT_CELLS ], numRows = 0;
+  int   columnMasks[ 360 ], numColumns = 0;
+  int   i, j, k, mask;
+  float height;
+
+  memset( table, 0, sizeof( *table ) );
+
+  // sorted, unique region height bounds
+  for( i = 0; i < numRegions; i++ )
+  {
+    float bounds[ 2 ];
+
+    if( regions[ i ].crouch != crouch )
+      continue;
+
+    bounds[ 0 ] = regions[ i ].minHeight;
+    bounds[ 1 ] = regions[ i ].maxHeight;
+
+    for( j = 0; j < 2; j++ )
+    {
+      for( k = 0; k < table->numHeights && table->heights[ k ] < bounds[ j ]; k++ );
+
+      if( k < table->numHeights && table->heights[ k ] == bounds[ j ] )
+        continue;
+
+      memmove( &table->heights[ k + 1 ], &table->heights[ k ],
+               ( table->numHeights - k ) * sizeof( float ) );
+      table->heights[ k ] = bounds[ j ];
+      table->numHeights++;
+    }
+  }
+
+  if( !table->numHeights )
+    return;
+
+  // one representative height per cell decides which regions cover it
+  for( i = 0; i < table->numHeights * 2 + 1; i++ )
+  {
+    if( i & 1 )
+      height = table->heights[ i / 2 ];
+    else if( i == 0 )
+      height = table->heights[ 0 ] - 1.0f;
+    else if( i == table->numHeights * 2 )
+      height = table->heights[ table->numHeights - 1 ] + 1.0f;
+    else
+      height = ( table->heights[ i / 2 - 1 ] + table->heights[ i / 2 ] ) * 0.5f;
+
+    for( mask = j = 0; j < numRegions; j++ )
+    {
+      if( regions[ j ].crouch == crouch &&
+          G_RegionAppliesAtHeight( &regions[ j ], height ) )
+        mask |= 1 << j;
+    }
+
+    table->heightRow[ i ] = G_FindRegionMask( rowMasks, &numRows, mask );
+  }
+
+  for( i = 0; i < 360; i++ )
+  {
+    for( mask = j = 0; j < numRegions; j++ )
+    {
+      if( regions[ j ].crouch == crouch &&
+          G_RegionAppliesAtAngle( &regions[ j ], i ) )
+        mask |= 1 << j;
+    }
+
+    table->angleColumn[ i ] = G_FindRegionMask( columnMasks, &numColumns, mask );
+  }
+
+  table->numColumns = numColumns;
+  table->modifiers = G_Alloc( numRows * numColumns * sizeof( float ) );
+
+  for( i = 0; i < numRows; i++ )
+  {
+    for( j = 0; j < numColumns; j++ )
+    {
+      float modifier = 1.0f;
+
+      mask = rowMasks[ i ] & columnMasks[ j ];
+
+      for( k = 0; k < numRegions; k++ )
+      {
+        if( mask & ( 1 << k ) )
+          modifier *= regions[ k ].modifier;
+      }
+
+      table->modifiers[ i * numColumns + j ] = modifier;
+    }
+  }
+}
+
+/*
+===============
+G_LocDamageModifier
+
+Look up the modifier for a hit at hitRatio of the target's height and
+hitRotation degrees round from its facing
+===============
+*/
+static float G_LocDamageModifier( const locDamageTable_t *table, float hitRatio,
+                                  int hitRotation )
+{
+  int lo = 0, hi = table->numHeights, mid, cell;
+
+  if( !table->modifiers )
+    return 1.0f;
+
+  // lo becomes the number of bounds below hitRatio
+  while( lo < hi )
+  {
+    mid = ( lo + hi ) / 2;
+
+    if( table->heights[ mid ] < hitRatio )
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  cell = lo * 2;
+  if( lo < table->numHeights && table->heights[ lo ] == hitRatio )
+    cell++;
+
+  return table->modifiers[ table->heightRow[ cell ] * table->numColumns +
+                           table->angleColumn[ hitRotation ] ];
+}
+
+/*
+===============
+G_CompileArmour
+
+Compile an upgrade's armour regions, and average them for damage that
+isn't locational
+===============
+*/
+static void G_CompileArmour( int upgrade )
+{
+  float totalModifier = 0.0f;
+  int   i;
+
+  G_CompileLocDamage( g_armourRegions[ upgrade ], g_numArmourRegions[ upgrade ],
+                      qfalse, &g_armourTables[ upgrade ][ 0 ] );
+  G_CompileLocDamage( g_armourRegions[ upgrade ], g_numArmourRegions[ upgrade ],
+                      qtrue, &g_armourTables[ upgrade ][ 1 ] );
+
+  for( i = 0; i < g_numArmourRegions[ upgrade ]; i++ )
+    totalModifier += g_armourRegions[ upgrade ][ i ].modifier;
+
+  if( g_numArmourRegions[ upgrade ] )
+    g_armourAverages[ upgrade ] = totalModifier / g_numArmourRegions[ upgrade ];
+  else
+    g_armourAverages[ upgrade ] = 1.0f;
+}
+
 /*
 ===============
 G_ParseArmourScript
@@ -771,6 +986,7 @@ void G_ParseArmourScript( char *buf, int upgrade )
   int   count;
 
   count = 0;
+  g_numArmourRegions[ upgrade ] = 0;
 
   while( 1 )
   {
@@ -867,6 +1083,8 @@ void G_ParseArmourScript( char *buf, int upgrade )
     g_numArmourRegions[ upgrade ]++;
     count++;
   }
+
+  G_CompileArmour( upgrade );
 }
 
 
@@ -881,6 +1099,7 @@ void G_ParseDmgScript( char *buf, int class )
   int   count;
 
   count = 0;
+  g_numDamageRegions[ class ] = 0;
 
   while( 1 )
   {
@@ -977,6 +1196,11 @@ void G_ParseDmgScript( char *buf, int class )
     g_numDamageRegions[ class ]++;
     count++;
   }
+
+  G_CompileLocDamage( g_damageRegions[ class ], g_numDamageRegions[ class ],
+                      qfalse, &g_damageTables[ class ][ 0 ] );
+  G_CompileLocDamage( g_damageRegions[ class ], g_numDamageRegions[ class ],
+                      qtrue, &g_damageTables[ class ][ 1 ] );
 }
 
 
@@ -989,33 +1213,44 @@ static float G_CalcDamageModifier( vec3_t point, gentity_t *targ, gentity_t *att
 {
   vec3_t  targOrigin;
   vec3_t  bulletPath;
-  vec3_t  bulletAngle;
   vec3_t  pMINUSfloor, floor, normal;
 
-  float   clientHeight, hitRelative, hitRatio;
+  float   clientHeight, hitRelative, hitRatio, bulletYaw;
   int     bulletRotation, clientRotation, hitRotation;
   float   modifier = 1.0f;
-  int     i, j;
+  int     i, crouch;
 
   if( point == NULL )
     return 1.0f;
 
-  if( g_unlagged.integer && targ->client && targ->client->unlaggedCalc.used )
-    VectorCopy( targ->client->unlaggedCalc.origin, targOrigin );
+  if( dflags & DAMAGE_NO_LOCDAMAGE )
+  {
+    //use the average of each upgrade's armour regions
+    for( i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++ )
+    {
+      if( BG_InventoryContainsUpgrade( i, targ->client->ps.stats ) )
+        modifier *= g_armourAverages[ i ];
+    }
+
+    return modifier;
+  }
+
+  if( g_unlagged.integer && targ->client && level.unlaggedCalc.used[ targ - g_entities ] )
+    VectorCopy( level.unlaggedCalc.origin[ targ - g_entities ], targOrigin );
   else
     VectorCopy( targ->r.currentOrigin, targOrigin );
 
   clientHeight = targ->r.maxs[ 2 ] - targ->r.mins[ 2 ];
 
   if( targ->client->ps.stats[ STAT_STATE ] & SS_WALLCLIMBING )
+  {
     VectorCopy( targ->client->ps.grapplePoint, normal );
+    VectorMA( targOrigin, targ->r.mins[ 2 ], normal, floor );
+    VectorSubtract( point, floor, pMINUSfloor );
+    hitRelative = DotProduct( normal, pMINUSfloor ) / VectorLength( normal );
+  }
   else
-    VectorSet( normal, 0, 0, 1 );
-
-  VectorMA( targOrigin, targ->r.mins[ 2 ], normal, floor );
-  VectorSubtract( point, floor, pMINUSfloor );
-
-  hitRelative = DotProduct( normal, pMINUSfloor ) / VectorLength( normal );
+    hitRelative = point[ 2 ] - ( targOrigin[ 2 ] + targ->r.mins[ 2 ] );
 
   if( hitRelative < 0.0f )
     hitRelative = 0.0f;
@@ -1025,130 +1260,175 @@ static float G_CalcDamageModifier( vec3_t point, gentity_t *targ, gentity_t *att
 
   hitRatio = hitRelative / clientHeight;
 
+  // only the yaw of the bullet path is needed, as vectoangles would give it
   VectorSubtract( targOrigin, point, bulletPath );
-  vectoangles( bulletPath, bulletAngle );
+  if( bulletPath[ 0 ] )
+  {
+    bulletYaw = atan2( bulletPath[ 1 ], bulletPath[ 0 ] ) * 180 / M_PI;
+    if( bulletYaw < 0 )
+      bulletYaw += 360;
+  }
+  else if( bulletPath[ 1 ] > 0 )
+    bulletYaw = 90;
+  else if( bulletPath[ 1 ] < 0 )
+    bulletYaw = 270;
+  else
+    bulletYaw = 0;
 
   clientRotation = targ->client->ps.viewangles[ YAW ];
-  bulletRotation = bulletAngle[ YAW ];
+  bulletRotation = bulletYaw;
 
   hitRotation = abs( clientRotation - bulletRotation );
 
   hitRotation = hitRotation % 360; // Keep it in the 0-359 range
 
-  if( dflags & DAMAGE_NO_LOCDAMAGE )
-  {
-    for( i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++ )
-    {
-      float totalModifier = 0.0f;
-      float averageModifier = 1.0f;
+  crouch = ( targ->client->ps.pm_flags & PMF_DUCKED ) ? 1 : 0;
 
-      //average all of this upgrade's armour regions together
-      if( BG_InventoryContainsUpgrade( i, targ->client->ps.stats ) )
-      {
-        for( j = 0; j < g_numArmourRegions[ i ]; j++ )
-          totalModifier += g_armourRegions[ i ][ j ].modifier;
+  if( attacker && attacker->client )
+  {
+    attacker->client->pers.statscounters.hitslocational++;
+    level.alienStatsCounters.hitslocational++;
+  }
 
-        if( g_numArmourRegions[ i ] )
-          averageModifier = totalModifier / g_numArmourRegions[ i ];
-        else
-          averageModifier = 1.0f;
-      }
+  modifier = G_LocDamageModifier( &g_damageTables[ class ][ crouch ],
+                                  hitRatio, hitRotation );
 
-      modifier *= averageModifier;
-    }
+  if( attacker && attacker->client && modifier == 2 )
+  {
+    attacker->client->pers.statscounters.headshots++;
+    level.alienStatsCounters.headshots++;
   }
-  else
+
+  for( i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++ )
   {
-    if( attacker && attacker->client )
-    {
-      attacker->client->pers.statscounters.hitslocational++;
-      level.alienStatsCounters.hitslocational++;
-    }
-    for( i = 0; i < g_numDamageRegions[ class ]; i++ )
-    {
-      qboolean rotationBound;
+    if( BG_InventoryContainsUpgrade( i, targ->client->ps.stats ) )
+      modifier *= G_LocDamageModifier( &g_armourTables[ i ][ crouch ],
+                                       hitRatio, hitRotation );
+  }
 
-      if( g_damageRegions[ class ][ i ].minAngle >
-          g_damageRegions[ class ][ i ].maxAngle )
-      {
-        rotationBound = ( hitRotation >= g_damageRegions[ class ][ i ].minAngle &&
-                          hitRotation <= 360 ) || ( hitRotation >= 0 &&
-                          hitRotation <= g_damageRegions[ class ][ i ].maxAngle );
-      }
-      else
-      {
-        rotationBound = ( hitRotation >= g_damageRegions[ class ][ i ].minAngle &&
-                          hitRotation <= g_damageRegions[ class ][ i ].maxAngle );
-      }
+  return modifier;
+}
 
-      if( rotationBound &&
-          hitRatio >= g_damageRegions[ class ][ i ].minHeight &&
-          hitRatio <= g_damageRegions[ class ][ i ].maxHeight &&
-          ( g_damageRegions[ class ][ i ].crouch ==
-            ( targ->client->ps.pm_flags & PMF_DUCKED ) ) )
-        modifier *= g_damageRegions[ class ][ i ].modifier;
-    }    
-    
-    if( attacker && attacker->client && modifier == 2 )
-    {
-      attacker->client->pers.statscounters.headshots++;
-      level.alienStatsCounters.headshots++;
-    }
 
-    for( i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++ )
-    {
-      if( BG_InventoryContainsUpgrade( i, targ->client->ps.stats ) )
-      {
-        for( j = 0; j < g_numArmourRegions[ i ]; j++ )
-        {
-          qboolean rotationBound;
+/*
+============
+G_CompileDamageLocations
 
-          if( g_armourRegions[ i ][ j ].minAngle >
-              g_armourRegions[ i ][ j ].maxAngle )
-          {
-            rotationBound = ( hitRotation >= g_armourRegions[ i ][ j ].minAngle &&
-                              hitRotation <= 360 ) || ( hitRotation >= 0 &&
-                              hitRotation <= g_armourRegions[ i ][ j ].maxAngle );
-          }
-          else
-          {
-            rotationBound = ( hitRotation >= g_armourRegions[ i ][ j ].minAngle &&
-                              hitRotation <= g_armourRegions[ i ][ j ].maxAngle );
-          }
+Compile the regions read from the damage and armour scripts whose files
+could be loaded
+============
+*/
+static void G_CompileDamageLocations( const configSources_t *sources )
+{
+  int i, source = 0;
 
-          if( rotationBound &&
-              hitRatio >= g_armourRegions[ i ][ j ].minHeight &&
-              hitRatio <= g_armourRegions[ i ][ j ].maxHeight &&
-              ( g_armourRegions[ i ][ j ].crouch ==
-                ( targ->client->ps.pm_flags & PMF_DUCKED ) ) )
-            modifier *= g_armourRegions[ i ][ j ].modifier;
-        }
-      }
-    }
+  for( i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++, source++ )
+  {
+    if( sources->lengths[ source ] < 0 ||
+        sources->lengths[ source ] >= MAX_LOCDAMAGE_TEXT )
+      continue;
+
+    G_CompileLocDamage( g_damageRegions[ i ], g_numDamageRegions[ i ],
+                        qfalse, &g_damageTables[ i ][ 0 ] );
+    G_CompileLocDamage( g_damageRegions[ i ], g_numDamageRegions[ i ],
+                        qtrue, &g_damageTables[ i ][ 1 ] );
   }
 
-  return modifier;
+  for( i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++, source++ )
+  {
+    if( sources->lengths[ source ] < 0 ||
+        sources->lengths[ source ] >= MAX_LOCDAMAGE_TEXT )
+      continue;
+
+    G_CompileArmour( i );
+  }
+}
+
+/*
+============
+G_ReadDamageCache
+============
+*/
+static qboolean G_ReadDamageCache( configSources_t *sources )
+{
+  fileHandle_t  f;
+  int           length;
+
+  length = G_ReadConfigCache( "locdamage.bin", sources, &f );
+  if( length < 0 )
+    return qfalse;
+
+  if( !G_ReadConfigCacheData( f, g_damageRegions, sizeof( g_damageRegions ), &length ) ||
+      !G_ReadConfigCacheData( f, g_numDamageRegions, sizeof( g_numDamageRegions ), &length ) ||
+      !G_ReadConfigCacheData( f, g_armourRegions, sizeof( g_armourRegions ), &length ) ||
+      !G_ReadConfigCacheData( f, g_numArmourRegions, sizeof( g_numArmourRegions ), &length ) ||
+      length != 0 )
+  {
+    trap_FS_FCloseFile( f );
+    memset( g_damageRegions, 0, sizeof( g_damageRegions ) );
+    memset( g_numDamageRegions, 0, sizeof( g_numDamageRegions ) );
+    memset( g_armourRegions, 0, sizeof( g_armourRegions ) );
+    memset( g_numArmourRegions, 0, sizeof( g_numArmourRegions ) );
+    return qfalse;
+  }
+
+  trap_FS_FCloseFile( f );
+
+  G_CompileDamageLocations( sources );
+  return qtrue;
 }
 
+/*
+============
+G_WriteDamageCache
+============
+*/
+static void G_WriteDamageCache( configSources_t *sources )
+{
+  fileHandle_t  f;
+
+  if( !( f = G_WriteConfigCache( "locdamage.bin", sources ) ) )
+    return;
+
+  trap_FS_Write( g_damageRegions, sizeof( g_damageRegions ), f );
+  trap_FS_Write( g_numDamageRegions, sizeof( g_numDamageRegions ), f );
+  trap_FS_Write( g_armourRegions, sizeof( g_armourRegions ), f );
+  trap_FS_Write( g_numArmourRegions, sizeof( g_numArmourRegions ), f );
+  trap_FS_FCloseFile( f );
+}
 
 /*
 ============
 G_InitDamageLocations
+
+Load the damage and armour scripts, from the cache if none of them have
+changed since it was written
 ============
 */
 void G_InitDamageLocations( void )
 {
-  char          *modelName;
-  char          filename[ MAX_QPATH ];
-  int           i;
-  int           len;
-  fileHandle_t  fileHandle;
-  char          buffer[ MAX_LOCDAMAGE_TEXT ];
+  char            *filename;
+  int             i, source = 0;
+  int             len;
+  fileHandle_t    fileHandle;
+  char            buffer[ MAX_LOCDAMAGE_TEXT ];
+  configSources_t sources;
+
+  sources.numSources = 0;
 
   for( i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++ )
+    G_AddConfigSource( &sources, va( "models/players/%s/locdamage.cfg",
+                                     BG_FindModelNameForClass( i ) ) );
+
+  for( i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++ )
+    G_AddConfigSource( &sources, va( "armour/%s.armour", BG_FindNameForUpgrade( i ) ) );
+
+  if( G_ReadDamageCache( &sources ) )
+    return;
+
+  for( i = PCL_NONE + 1; i < PCL_NUM_CLASSES; i++, source++ )
   {
-    modelName = BG_FindModelNameForClass( i );
-    Com_sprintf( filename, sizeof( filename ), "models/players/%s/locdamage.cfg", modelName );
+    filename = sources.names[ source ];
 
     len = trap_FS_FOpenFile( filename, &fileHandle, FS_READ );
     if ( !fileHandle )
@@ -1171,10 +1451,9 @@ void G_InitDamageLocations( void )
     G_ParseDmgScript( buffer, i );
   }
 
-  for( i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++ )
+  for( i = UP_NONE + 1; i < UP_NUM_UPGRADES; i++, source++ )
   {
-    modelName = BG_FindNameForUpgrade( i );
-    Com_sprintf( filename, sizeof( filename ), "armour/%s.armour", modelName );
+    filename = sources.names[ source ];
 
     len = trap_FS_FOpenFile( filename, &fileHandle, FS_READ );
 
@@ -1195,6 +1474,8 @@ void G_InitDamageLocations( void )
 
     G_ParseArmourScript( buffer, i );
   }
+
+  G_WriteDamageCache( &sources );
 }
 
 ////////TA: locdamage
@@ -258,6 +258,9 @@ struct gentity_s
   int               lastDamageTime;
   
   int               bdnumb;     // buildlog entry ID
+
+  int               bpAccount;          // BPA_* flags currently added to the level totals
+  buildable_t       bpAccountBuildable; // buildable type those flags were added as
   
   // For nobuild!
   noBuild_t	    noBuild;
@@ -310,9 +313,9 @@ typedef struct
 #define FOLLOW_ACTIVE2  -2
 
 // client data that stays across multiple levels or tournament restarts
-// this is achieved by writing all the data to cvar strings at game shutdown
-// time and reading them back at connection time.  Anything added here
-// MUST be dealt with in G_InitSessionData() / G_ReadSessionData() / G_WriteSessionData()
+// this is achieved by writing all the data to a session file at game shutdown
+// time and reading it back at connection time.  Anything added here
+// MUST be dealt with in G_InitSessionData()
 typedef struct
 {
   team_t            sessionTeam;
@@ -470,10 +473,72 @@ typedef struct unlagged_s {
   qboolean    used;
 } unlagged_t;
 
+// position data for every client at one point in time, stored as arrays
+// indexed by client number so all clients can be rewound in one pass
+typedef struct unlaggedMarker_s {
+  vec3_t      origin[ MAX_CLIENTS ];
+  vec3_t      mins[ MAX_CLIENTS ];
+  vec3_t      maxs[ MAX_CLIENTS ];
+  qboolean    used[ MAX_CLIENTS ];
+} unlaggedMarker_t;
+
+// which pair of markers a client time falls between, cached until the
+// next G_UnlaggedStore() since every shot at that time resolves the same
+#define UNLAGGED_RESOLVE_CACHE 64
+typedef struct unlaggedResolve_s {
+  qboolean    valid;
+  int         time;
+  qboolean    rewind;     // qfalse if time is on the current frame
+  int         startIndex;
+  int         stopIndex;
+  float       lerp;
+} unlaggedResolve_t;
+
 typedef struct {
 	float rangeBoost;
 } adminRangeBoosts_t;
 
+// where a buildable ghost ends up and what the traces found there
+typedef struct buildPlacement_s {
+  vec3_t      origin;
+  vec3_t      angles;
+  vec3_t      normal;
+  int         surfaceFlags;
+  int         contents;
+  qboolean    onWorld;    // resting on the world rather than an entity
+  qboolean    hovelBlocked;
+  qboolean    noRoom;
+} buildPlacement_t;
+
+// the last G_CanBuild() for a builder, so an unchanged ghost is not traced
+// and validated again every time it is checked
+#define MAX_PLACEMENT_REMOVALS 16
+typedef struct placementCache_s {
+  // what the placement was traced from
+  qboolean          traced;     // qfalse if something dynamic was in the area
+  buildable_t       buildable;
+  int               team;
+  int               pclass;
+  int               state;
+  vec3_t            playerOrigin;
+  vec3_t            viewAngles;
+  vec3_t            grapplePoint;
+  vec3_t            areaMins, areaMaxs;
+  buildPlacement_t  placement;
+
+  // what the placement was validated against
+  qboolean          validated;
+  int               generation;
+  int               buildPoints;
+  int               spawns;
+  int               markDeconstruct;
+  int               markDeconstructMode;
+  int               cheats;
+  int               reason;     // itemBuildError_t
+  int               numRemovals;
+  int               removals[ MAX_PLACEMENT_REMOVALS ];
+} placementCache_t;
+
 // this structure is cleared on each ClientSpawn(),
 // except for 'client->pers' and 'client->sess'
 struct gclient_s
@@ -566,9 +631,7 @@ struct gclient_s
 #define RAM_FRAMES  1                       // number of frames to wait before retriggering
   int                 retriggerArmouryMenu; // frame number to retrigger the armoury menu
 
-  unlagged_t          unlaggedHist[ MAX_UNLAGGED_MARKERS ];
   unlagged_t          unlaggedBackup;
-  unlagged_t          unlaggedCalc;
   int                 unlaggedTime;
   
   int               tkcredits[ MAX_CLIENTS ];
@@ -576,6 +639,8 @@ struct gclient_s
   adminRangeBoosts_t newRange;
 
   qboolean            nearBase;
+
+  placementCache_t    placement;
 };
 
 
@@ -583,7 +648,9 @@ typedef struct spawnQueue_s
 {
   int clients[ MAX_CLIENTS ];
 
-  int front, back;
+  int front, back, length;
+
+  int slots[ MAX_CLIENTS ];   // index into clients[] of each client, -1 if not queued
 } spawnQueue_t;
 
 #define QUEUE_PLUS1(x)  (((x)+1)%MAX_CLIENTS)
@@ -614,18 +681,27 @@ typedef struct damageRegion_s
 } damageRegion_t;
 
 #define MAX_ARMOUR_TEXT    8192
-#define MAX_ARMOUR_REGIONS 16
+#define MAX_ARMOUR_REGIONS MAX_LOCDAMAGE_REGIONS
 
-// store locational armour regions
-typedef struct armourRegion_s
-{
-  float     minHeight, maxHeight;
-  int       minAngle, maxAngle;
+// store locational armour regions, same layout as damage regions
+typedef damageRegion_t armourRegion_t;
 
-  float     modifier;
+// a set of regions compiled into a table of modifiers indexed by hit
+// height and angle. Hit heights are located among the sorted region
+// bounds, where cell 2i+1 is exactly heights[ i ] and the even cells are
+// the open intervals around them. Cells and degrees with the same set of
+// regions share a row or column
+#define LOCDAMAGE_HEIGHT_CELLS  ( MAX_LOCDAMAGE_REGIONS * 4 + 1 )
 
-  qboolean  crouch;
-} armourRegion_t;
+typedef struct locDamageTable_s
+{
+  int       numHeights;
+  float     heights[ MAX_LOCDAMAGE_REGIONS * 2 ];
+  byte      heightRow[ LOCDAMAGE_HEIGHT_CELLS ];
+  byte      angleColumn[ 360 ];
+  int       numColumns;
+  float     *modifiers;   // [ row * numColumns + column ], NULL if no regions
+} locDamageTable_t;
 
 //status of the warning of certain events
 typedef enum
@@ -714,6 +790,8 @@ typedef struct
   int               voteNo;
   int               numVotingClients;             // set by CalculateRanks
   int               votedHow[MAX_CLIENTS];       // 0 is "hasn't voted", 1 is "voted yes", -1 is voted "no"
+  clientList_t      voteEligible;                 // clients who may vote
+  int               voteYesSent, voteNoSent;      // counts in the configstrings
 
   // team voting state
   char              teamVoteString[ 2 ][ MAX_STRING_CHARS ];
@@ -723,6 +801,8 @@ typedef struct
   int               teamVoteNo[ 2 ];
   int               numteamVotingClients[ 2 ];    // set by CalculateRanks
   int               teamVotedHow[ 2 ][ MAX_CLIENTS ];
+  clientList_t      teamVoteEligible[ 2 ];
+  int               teamVoteYesSent[ 2 ], teamVoteNoSent[ 2 ];
 
   // spawn variables
   qboolean          spawning;                     // the G_Spawn*() functions are valid
@@ -765,9 +845,24 @@ typedef struct
   int               humanBuildPoints;
   int               humanBuildPointsPowered;
 
+  // running totals maintained by G_AccountBuildable
+  int               buildPointsUsed[ BIT_NUM_TEAMS ];
+  int               replaceableBuildPointsUsed[ BIT_NUM_TEAMS ];
+  int               poweredBuildPointsUsed[ BIT_NUM_TEAMS ];
+  int               poweredReplaceableBuildPointsUsed[ BIT_NUM_TEAMS ];
+  int               numReactors;
+  int               numOverminds;
+  int               lastAlienSpawns;              // last values sent in CS_SPAWNS
+  int               lastHumanSpawns;
+
   gentity_t         *markedBuildables[ MAX_GENTITIES ];
   int               numBuildablesForRemoval;
 
+  int               buildableGeneration;          // bumped when anything G_CanBuild checks changes
+  int               placementChecks;
+  int               placementTraceHits;           // checks that reused the traced placement
+  int               placementHits;                // checks that reused the whole result
+
   int               alienKills;
   int               humanKills;
 
@@ -812,6 +907,9 @@ typedef struct
 
   int unlaggedIndex;
   int unlaggedTimes[ MAX_UNLAGGED_MARKERS ];
+  unlaggedMarker_t  unlaggedHist[ MAX_UNLAGGED_MARKERS ];
+  unlaggedMarker_t  unlaggedCalc;                 // result of the last G_UnlaggedCalc()
+  unlaggedResolve_t unlaggedResolve[ UNLAGGED_RESOLVE_CACHE ];
 
   char              layout[ MAX_QPATH ];
 
@@ -883,6 +981,9 @@ void      G_SanitiseString( char *in, char *out, int len );
 void      G_PrivateMessage( gentity_t *ent );
 char      *G_statsString( statsCounters_t *sc, pTeam_t *pt );
 void      Cmd_CallVote_f( gentity_t *ent );
+void      G_SendVoteCounts( pTeam_t team );
+void      G_AllowVote( int clientNum, pTeam_t team );
+void      G_WithdrawVote( int clientNum, pTeam_t team );
 void      Cmd_CallTeamVote_f( gentity_t *ent );
 void      Cmd_Share_f( gentity_t *ent );
 void      Cmd_Donate_f( gentity_t *ent );
@@ -939,9 +1040,19 @@ qboolean          G_IsPowered( vec3_t origin );
 qboolean          G_IsDCCBuilt( void );
 qboolean          G_IsOvermindBuilt( void );
 
+// flags describing what a buildable contributes to the level totals
+#define BPA_COUNTED       0x0001 // uses build points
+#define BPA_POWERED       0x0002 // uses powered build points
+#define BPA_ALIVE         0x0004 // health > 0
+#define BPA_ACTIVE        0x0008 // alive and finished spawning
+
+void              G_AccountBuildable( gentity_t *ent );
+void              G_UnaccountBuildable( gentity_t *ent );
+void              G_CheckBuildableAccounting( void );
 void              G_BuildableThink( gentity_t *ent, int msec );
 qboolean          G_BuildableRange( vec3_t origin, float r, buildable_t buildable );
 itemBuildError_t  G_CanBuild( gentity_t *ent, buildable_t buildable, int distance, vec3_t origin );
+void              G_PlacementStats( qboolean reset );
 qboolean G_BuildingExists( int bclass ) ;
 qboolean          G_BuildIfValid( gentity_t *ent, buildable_t buildable );
 void              G_SetBuildableAnim( gentity_t *ent, buildableAnimNumber_t anim, qboolean force );
@@ -953,6 +1064,9 @@ void              G_LayoutSave( char *name );
 int               G_LayoutList( const char *map, char *list, int len );
 void              G_LayoutSelect( void );
 void              G_LayoutLoad( void );
+void              G_LayoutInfo( const char *map, const char *name );
+void              G_LayoutConvert( const char *map, const char *from, const char *to,
+                                   qboolean text );
 void              G_BaseSelfDestruct( pTeam_t team );
 gentity_t         *G_InstantBuild( buildable_t buildable, vec3_t origin, vec3_t angles, vec3_t origin2, vec3_t angles2 );
 void              G_SpawnRevertedBuildable( buildHistory_t *bh, qboolean mark );
@@ -1145,6 +1259,7 @@ void FireWeapon3( gentity_t *ent );
 void ScoreboardMessage( gentity_t *client );
 void MoveClientToIntermission( gentity_t *client );
 void G_MapConfigs( const char *mapname );
+void G_RequestCvarUpdate( void );
 void CalculateRanks( void );
 void FindIntermissionPoint( void );
 void G_RunThink( gentity_t *ent );
@@ -1181,6 +1296,7 @@ void G_UnlaggedClear( gentity_t *ent );
 void G_UnlaggedCalc( int time, gentity_t *skipEnt );
 void G_UnlaggedOn( gentity_t *attacker, vec3_t muzzle, float range );
 void G_UnlaggedOff( void );
+void G_UnlaggedBenchmark( int shots );
 void ClientThink( int clientNum );
 void ClientEndFrame( gentity_t *ent );
 void G_RunClient( gentity_t *ent );
@@ -1198,6 +1314,7 @@ void      CheckTeamStatus( void );
 // g_mem.c
 //
 void *G_Alloc( int size );
+void *G_StringAlloc( int size );
 void G_InitMemory( void );
 void G_Free( void *ptr );
 void G_DefragmentMemory( void );
@@ -1206,9 +1323,11 @@ void Svcmd_GameMem_f( void );
 //
 // g_session.c
 //
-void G_ReadSessionData( gclient_t *client );
+qboolean G_ReadSessionData( gclient_t *client );
 void G_InitSessionData( gclient_t *client, char *userinfo );
 void G_WriteSessionData( void );
+void G_SaveSessionData( void );
+void G_LoadSessionData( void );
 
 //
 // g_maprotation.c
@@ -1255,6 +1374,11 @@ typedef struct mapRotationCondition_s
 
   int                     numClients;
   pTeam_t                 lastWin;
+
+  // filled in by G_CompileMapRotations
+  mapConditionType_t      destType;
+  int                     destIndex;    // map in this rotation or rotation number
+  qboolean                destExists;   // dest is an installed map
 } mapRotationCondition_t;
 
 typedef struct mapRotationEntry_s
@@ -1267,6 +1391,8 @@ typedef struct mapRotationEntry_s
 
   mapRotationCondition_t  conditions[ MAX_MAP_ROTATION_CONDS ];
   int                     numConditions;
+
+  qboolean                exists;       // installed map, *VOTE* or *RANDOM*
 } mapRotationEntry_t;
 
 typedef struct mapRotation_s
@@ -1292,6 +1418,7 @@ qboolean  G_MapRotationActive( void );
 void      G_InitMapRotations( void );
 qboolean  G_MapExists( char *name );
 int       G_GetCurrentMap( int rotation );
+void      G_ValidateMapRotations( const char *name );
 
 qboolean G_CheckMapRotationVote( void );
 qboolean G_IntermissionMapVoteWinner( void );
@@ -1299,11 +1426,45 @@ void G_IntermissionMapVoteMessage( gentity_t *ent );
 void G_IntermissionMapVoteMessageAll( void );
 void G_IntermissionMapVoteCommand( gentity_t *ent, qboolean next, qboolean choose );
 
+//
+// g_think.c
+//
+void      G_InitThinkScheduler( void );
+void      G_SetNextThink( gentity_t *ent, int time );
+void      G_WakeEntity( gentity_t *ent );
+void      G_ParkEntity( gentity_t *ent );
+void      G_WakeThinkers( void );
+int       G_NextAwakeEntity( int num );
+void      G_ThinkBenchmark( int count, int frames );
+
+//
+// g_cache.c
+//
+#define CONFIG_CACHE_VERSION  2
+#define MAX_CONFIG_SOURCES    32
+#define CONFIG_HASH_INIT      0x811c9dc5u
+
+// the files a cache was built from
+typedef struct configSources_s
+{
+  char  names[ MAX_CONFIG_SOURCES ][ MAX_QPATH ];
+  int   lengths[ MAX_CONFIG_SOURCES ];
+  int   numSources;
+} configSources_t;
+
+unsigned int  G_HashConfigData( unsigned int hash, const char *data, int length );
+void          G_AddConfigSource( configSources_t *sources, const char *fileName );
+int           G_ReadConfigCache( const char *name, configSources_t *sources, fileHandle_t *f );
+qboolean      G_ReadConfigCacheData( fileHandle_t f, void *data, int size, int *remaining );
+fileHandle_t  G_WriteConfigCache( const char *name, configSources_t *sources );
+void          G_InitOverrides( void );
+
 //
 // g_ptr.c
 //
 void                G_UpdatePTRConnection( gclient_t *client );
 connectionRecord_t  *G_GenerateNewConnection( gclient_t *client );
+connectionRecord_t  *G_RestorePTRConnection( gclient_t *client, int code );
 void                G_ResetPTRConnections( void );
 connectionRecord_t  *G_FindConnectionForCode( int code );
 
@@ -1348,6 +1509,7 @@ extern  vmCvar_t  g_inactivity;
 extern  vmCvar_t  g_debugMove;
 extern  vmCvar_t  g_debugAlloc;
 extern  vmCvar_t  g_debugDamage;
+extern  vmCvar_t  g_debugBuildPoints;
 extern  vmCvar_t  g_weaponRespawn;
 extern  vmCvar_t  g_weaponTeamRespawn;
 extern  vmCvar_t  g_synchronousClients;
@@ -37,6 +37,8 @@ typedef struct
   int     modificationCount;  // for tracking changes
   qboolean  trackChange;  // track this variable, and announce if changed
   qboolean teamShader;        // track and if changed, update shader state
+  qboolean  everyFrame;   // refreshed every frame rather than on the slow cycle
+  void      (*changed)( void ); // called when the value changes
 } cvarTable_t;
 
 gentity_t   g_entities[ MAX_GENTITIES ];
@@ -68,6 +70,7 @@ vmCvar_t  g_inactivity;
 vmCvar_t  g_debugMove;
 vmCvar_t  g_debugDamage;
 vmCvar_t  g_debugAlloc;
+vmCvar_t  g_debugBuildPoints;
 vmCvar_t  g_weaponRespawn;
 vmCvar_t  g_weaponTeamRespawn;
 vmCvar_t  g_motd;
@@ -259,16 +262,20 @@ vmCvar_t  g_sdDestructionBonus;
 
 vmCvar_t g_disablePollVotes;
 
+static void G_PasswordChanged( void );
+static void G_MarkDeconstructChanged( void );
+static void G_SuddenDeathTimeChanged( void );
+
 static cvarTable_t   gameCvarTable[ ] =
 {
   // don't override the cheat state set by the system
-  { &g_cheats, "sv_cheats", "", 0, 0, qfalse },
+  { &g_cheats, "sv_cheats", "", 0, 0, qfalse, qfalse, qtrue },
 
   // noset vars
   { NULL, "gamename", GAME_VERSION , CVAR_SERVERINFO | CVAR_ROM, 0, qfalse  },
   { NULL, "gamedate", __DATE__ , CVAR_ROM, 0, qfalse  },
-  { &g_restarted, "g_restarted", "0", CVAR_ROM, 0, qfalse  },
-  { &g_lockTeamsAtStart, "g_lockTeamsAtStart", "0", CVAR_ROM, 0, qfalse  },
+  { &g_restarted, "g_restarted", "0", CVAR_ROM, 0, qfalse, qfalse, qtrue },
+  { &g_lockTeamsAtStart, "g_lockTeamsAtStart", "0", CVAR_ROM, 0, qfalse, qfalse, qtrue },
   { NULL, "sv_mapname", "", CVAR_SERVERINFO | CVAR_ROM, 0, qfalse  },
   { NULL, "P", "", CVAR_SERVERINFO | CVAR_ROM, 0, qfalse  },
   { NULL, "ff", "0", CVAR_SERVERINFO | CVAR_ROM, 0, qfalse  },
@@ -280,18 +287,18 @@ static cvarTable_t   gameCvarTable[ ] =
   { &g_maxGameClients, "g_maxGameClients", "0", CVAR_SERVERINFO | CVAR_ARCHIVE | CVAR_NORESTART, 0, qtrue  },
 
   // change anytime vars
-  { &g_timelimit, "timelimit", "45", CVAR_SERVERINFO | CVAR_ARCHIVE | CVAR_NORESTART, 0, qtrue },
-  { &g_suddenDeathTime, "g_suddenDeathTime", "30", CVAR_SERVERINFO | CVAR_ARCHIVE | CVAR_NORESTART, 0, qtrue },
-  { &g_suddenDeathMode, "g_suddenDeathMode", "0", CVAR_SERVERINFO | CVAR_ARCHIVE | CVAR_NORESTART, 0, qtrue },
-  { &g_suddenDeath, "g_suddenDeath", "0", CVAR_SERVERINFO | CVAR_NORESTART, 0, qtrue },
+  { &g_timelimit, "timelimit", "45", CVAR_SERVERINFO | CVAR_ARCHIVE | CVAR_NORESTART, 0, qtrue, qfalse, qtrue },
+  { &g_suddenDeathTime, "g_suddenDeathTime", "30", CVAR_SERVERINFO | CVAR_ARCHIVE | CVAR_NORESTART, 0, qtrue, qfalse, qtrue, G_SuddenDeathTimeChanged },
+  { &g_suddenDeathMode, "g_suddenDeathMode", "0", CVAR_SERVERINFO | CVAR_ARCHIVE | CVAR_NORESTART, 0, qtrue, qfalse, qtrue },
+  { &g_suddenDeath, "g_suddenDeath", "0", CVAR_SERVERINFO | CVAR_NORESTART, 0, qtrue, qfalse, qtrue },
 
-  { &g_synchronousClients, "g_synchronousClients", "0", CVAR_SYSTEMINFO, 0, qfalse  },
+  { &g_synchronousClients, "g_synchronousClients", "0", CVAR_SYSTEMINFO, 0, qfalse, qfalse, qtrue },
 
-  { &g_friendlyFire, "g_friendlyFire", "0", CVAR_ARCHIVE | CVAR_SERVERINFO, 0, qtrue  },
-  { &g_friendlyFireAliens, "g_friendlyFireAliens", "0", CVAR_ARCHIVE, 0, qtrue  },
-  { &g_friendlyFireHumans, "g_friendlyFireHumans", "0", CVAR_ARCHIVE, 0, qtrue  },
+  { &g_friendlyFire, "g_friendlyFire", "0", CVAR_ARCHIVE | CVAR_SERVERINFO, 0, qtrue, qfalse, qtrue },
+  { &g_friendlyFireAliens, "g_friendlyFireAliens", "0", CVAR_ARCHIVE, 0, qtrue, qfalse, qtrue },
+  { &g_friendlyFireHumans, "g_friendlyFireHumans", "0", CVAR_ARCHIVE, 0, qtrue, qfalse, qtrue },
   { &g_retribution, "g_retribution", "0", CVAR_ARCHIVE, 0, qtrue  },
-  { &g_friendlyBuildableFire, "g_friendlyBuildableFire", "0", CVAR_ARCHIVE | CVAR_SERVERINFO, 0, qtrue  },
+  { &g_friendlyBuildableFire, "g_friendlyBuildableFire", "0", CVAR_ARCHIVE | CVAR_SERVERINFO, 0, qtrue, qfalse, qtrue },
   { &g_friendlyFireMovementAttacks, "g_friendlyFireMovementAttacks", "1", CVAR_ARCHIVE, 0, qtrue  },
   { &g_devmapNoGod, "g_devmapNoGod", "0", CVAR_ARCHIVE, 0, qtrue  },
   { &g_devmapNoStructDmg, "g_devmapNoStructDmg", "0", CVAR_ARCHIVE, 0, qtrue  },
@@ -308,20 +315,20 @@ static cvarTable_t   gameCvarTable[ ] =
   { &g_logFile, "g_logFile", "games.log", CVAR_ARCHIVE, 0, qfalse  },
   { &g_logFileSync, "g_logFileSync", "0", CVAR_ARCHIVE, 0, qfalse  },
 
-  { &g_password, "g_password", "", CVAR_USERINFO, 0, qfalse  },
+  { &g_password, "g_password", "", CVAR_USERINFO, 0, qfalse, qfalse, qfalse, G_PasswordChanged },
 
-  { &g_banIPs, "g_banIPs", "", CVAR_ARCHIVE, 0, qfalse  },
+  { &g_banIPs, "g_banIPs", "", CVAR_ARCHIVE, 0, qfalse, qfalse, qtrue },
   { &g_filterBan, "g_filterBan", "1", CVAR_ARCHIVE, 0, qfalse  },
 
-  { &g_needpass, "g_needpass", "0", CVAR_SERVERINFO | CVAR_ROM, 0, qfalse },
+  { &g_needpass, "g_needpass", "0", CVAR_SERVERINFO | CVAR_ROM, 0, qfalse, qfalse, qtrue },
   
   { &g_autoGhost, "g_autoGhost", "1", CVAR_SERVERINFO, 0, qfalse },
 
   { &g_dedicated, "dedicated", "0", 0, 0, qfalse  },
 
-  { &g_speed, "g_speed", "320", CVAR_SERVERINFO, 0, qtrue  },
-  { &g_gravity, "g_gravity", "800", CVAR_SERVERINFO, 0, qtrue  },
-  { &g_knockback, "g_knockback", "1000", CVAR_SERVERINFO, 0, qtrue  },
+  { &g_speed, "g_speed", "320", CVAR_SERVERINFO, 0, qtrue, qfalse, qtrue },
+  { &g_gravity, "g_gravity", "800", CVAR_SERVERINFO, 0, qtrue, qfalse, qtrue },
+  { &g_knockback, "g_knockback", "1000", CVAR_SERVERINFO, 0, qtrue, qfalse, qtrue },
   { &g_quadfactor, "g_quadfactor", "3", 0, 0, qtrue  },
   { &g_weaponRespawn, "g_weaponrespawn", "5", 0, 0, qtrue  },
   { &g_weaponTeamRespawn, "g_weaponTeamRespawn", "30", 0, 0, qtrue },
@@ -329,6 +336,7 @@ static cvarTable_t   gameCvarTable[ ] =
   { &g_debugMove, "g_debugMove", "0", 0, 0, qfalse },
   { &g_debugDamage, "g_debugDamage", "0", 0, 0, qfalse },
   { &g_debugAlloc, "g_debugAlloc", "0", 0, 0, qfalse },
+  { &g_debugBuildPoints, "g_debugBuildPoints", "0", 0, 0, qfalse },
   { &g_motd, "g_motd", "", 0, 0, qfalse },
   { &g_blood, "com_blood", "1", 0, 0, qfalse },
 
@@ -363,38 +371,38 @@ static cvarTable_t   gameCvarTable[ ] =
   { &g_readyPercent, "g_readyPercent", "0", CVAR_ARCHIVE, 0, qfalse },
   { &g_designateVotes, "g_designateVotes", "0", CVAR_ARCHIVE, 0, qfalse },
   
-  { &g_listEntity, "g_listEntity", "0", 0, 0, qfalse },
+  { &g_listEntity, "g_listEntity", "0", 0, 0, qfalse, qfalse, qtrue },
   { &g_minCommandPeriod, "g_minCommandPeriod", "500", 0, 0, qfalse},
   { &g_minNameChangePeriod, "g_minNameChangePeriod", "5", 0, 0, qfalse},
   { &g_maxNameChanges, "g_maxNameChanges", "5", 0, 0, qfalse},
   { &g_newbieNumbering, "g_newbieNumbering", "0", CVAR_ARCHIVE, 0, qfalse},
   { &g_newbieNamePrefix, "g_newbieNamePrefix", "Newbie#", CVAR_ARCHIVE, 0, qfalse},
 
-  { &g_smoothClients, "g_smoothClients", "1", 0, 0, qfalse},
+  { &g_smoothClients, "g_smoothClients", "1", 0, 0, qfalse, qfalse, qtrue },
   { &g_outdatedClientMessage, "g_outdatedClientMessage", "", CVAR_ARCHIVE, 0, qfalse},
-  { &pmove_fixed, "pmove_fixed", "0", CVAR_SYSTEMINFO, 0, qfalse},
-  { &pmove_msec, "pmove_msec", "8", CVAR_SYSTEMINFO, 0, qfalse},
-
-  { &g_humanBuildPoints, "g_humanBuildPoints", DEFAULT_HUMAN_BUILDPOINTS, CVAR_SERVERINFO, 0, qfalse  },
-  { &g_alienBuildPoints, "g_alienBuildPoints", DEFAULT_ALIEN_BUILDPOINTS, CVAR_SERVERINFO, 0, qfalse  },
-  { &g_humanStage, "g_humanStage", "0", 0, 0, qfalse  },
-  { &g_humanKills, "g_humanKills", "0", 0, 0, qfalse  },
-  { &g_humanMaxStage, "g_humanMaxStage", DEFAULT_HUMAN_MAX_STAGE, 0, 0, qfalse  },
+  { &pmove_fixed, "pmove_fixed", "0", CVAR_SYSTEMINFO, 0, qfalse, qfalse, qtrue },
+  { &pmove_msec, "pmove_msec", "8", CVAR_SYSTEMINFO, 0, qfalse, qfalse, qtrue },
+
+  { &g_humanBuildPoints, "g_humanBuildPoints", DEFAULT_HUMAN_BUILDPOINTS, CVAR_SERVERINFO, 0, qfalse, qfalse, qtrue },
+  { &g_alienBuildPoints, "g_alienBuildPoints", DEFAULT_ALIEN_BUILDPOINTS, CVAR_SERVERINFO, 0, qfalse, qfalse, qtrue },
+  { &g_humanStage, "g_humanStage", "0", 0, 0, qfalse, qfalse, qtrue },
+  { &g_humanKills, "g_humanKills", "0", 0, 0, qfalse, qfalse, qtrue },
+  { &g_humanMaxStage, "g_humanMaxStage", DEFAULT_HUMAN_MAX_STAGE, 0, 0, qfalse, qfalse, qtrue },
   { &g_humanStage2Threshold, "g_humanStage2Threshold", DEFAULT_HUMAN_STAGE2_THRESH, 0, 0, qfalse  },
   { &g_humanStage3Threshold, "g_humanStage3Threshold", DEFAULT_HUMAN_STAGE3_THRESH, 0, 0, qfalse  },
-  { &g_alienStage, "g_alienStage", "0", 0, 0, qfalse  },
-  { &g_alienKills, "g_alienKills", "0", 0, 0, qfalse  },
-  { &g_alienMaxStage, "g_alienMaxStage", DEFAULT_ALIEN_MAX_STAGE, 0, 0, qfalse  },
+  { &g_alienStage, "g_alienStage", "0", 0, 0, qfalse, qfalse, qtrue },
+  { &g_alienKills, "g_alienKills", "0", 0, 0, qfalse, qfalse, qtrue },
+  { &g_alienMaxStage, "g_alienMaxStage", DEFAULT_ALIEN_MAX_STAGE, 0, 0, qfalse, qfalse, qtrue },
   { &g_alienStage2Threshold, "g_alienStage2Threshold", DEFAULT_ALIEN_STAGE2_THRESH, 0, 0, qfalse  },
   { &g_alienStage3Threshold, "g_alienStage3Threshold", DEFAULT_ALIEN_STAGE3_THRESH, 0, 0, qfalse  },
   
   { &g_teamImbalanceWarnings, "g_teamImbalanceWarnings", "30", CVAR_ARCHIVE, 0, qfalse  },
   
-  { &g_unlagged, "g_unlagged", "1", CVAR_SERVERINFO | CVAR_ARCHIVE, 0, qtrue  },
+  { &g_unlagged, "g_unlagged", "1", CVAR_SERVERINFO | CVAR_ARCHIVE, 0, qtrue, qfalse, qtrue },
 
-  { &g_disabledEquipment, "g_disabledEquipment", "", CVAR_ROM, 0, qfalse  },
-  { &g_disabledClasses, "g_disabledClasses", "", CVAR_ROM, 0, qfalse  },
-  { &g_disabledBuildables, "g_disabledBuildables", "", CVAR_ROM, 0, qfalse  },
+  { &g_disabledEquipment, "g_disabledEquipment", "", CVAR_ROM, 0, qfalse, qfalse, qtrue },
+  { &g_disabledClasses, "g_disabledClasses", "", CVAR_ROM, 0, qfalse, qfalse, qtrue },
+  { &g_disabledBuildables, "g_disabledBuildables", "", CVAR_ROM, 0, qfalse, qfalse, qtrue },
 
   { &g_chatTeamPrefix, "g_chatTeamPrefix", "1", CVAR_ARCHIVE  },
   { &g_actionPrefix, "g_actionPrefix", "* ", CVAR_ARCHIVE, 0, qfalse },
@@ -402,21 +410,21 @@ static cvarTable_t   gameCvarTable[ ] =
   { &g_floodMinTime, "g_floodMinTime", "2000", CVAR_ARCHIVE, 0, qfalse  },
   { &g_spamTime, "g_spamTime", "2", CVAR_ARCHIVE, 0, qfalse  },
 
-  { &g_markDeconstruct, "g_markDeconstruct", "0", CVAR_ARCHIVE, 0, qtrue  },
+  { &g_markDeconstruct, "g_markDeconstruct", "0", CVAR_ARCHIVE, 0, qtrue, qfalse, qtrue, G_MarkDeconstructChanged },
   { &g_markDeconstructMode, "g_markDeconstructMode", "0", CVAR_ARCHIVE, 0, qfalse  },
   { &g_deconDead, "g_deconDead", "0", CVAR_ARCHIVE, 0, qtrue  }, //g_guidlessBuildersAllowed
   { &g_guidlessBuildersAllowed, "g_guidlessBuildersAllowed", "1", CVAR_ARCHIVE, 0, qtrue },
 
   { &g_debugMapRotation, "g_debugMapRotation", "0", 0, 0, qfalse  },
-  { &g_currentMapRotation, "g_currentMapRotation", "-1", 0, 0, qfalse  }, // -1 = NOT_ROTATING
-  { &g_currentMap, "g_currentMap", "0", 0, 0, qfalse  },
-  { &g_nextMap, "g_nextMap", "", 0 , 0, qtrue  },
-  { &g_initialMapRotation, "g_initialMapRotation", "", CVAR_ARCHIVE, 0, qfalse  },
+  { &g_currentMapRotation, "g_currentMapRotation", "-1", 0, 0, qfalse, qfalse, qtrue }, // -1 = NOT_ROTATING
+  { &g_currentMap, "g_currentMap", "0", 0, 0, qfalse, qfalse, qtrue },
+  { &g_nextMap, "g_nextMap", "", 0 , 0, qtrue, qfalse, qtrue },
+  { &g_initialMapRotation, "g_initialMapRotation", "", CVAR_ARCHIVE, 0, qfalse, qfalse, qtrue },
   { &g_shove, "g_shove", "15", CVAR_ARCHIVE, 0, qfalse  },
   { &g_mapConfigs, "g_mapConfigs", "", CVAR_ARCHIVE, 0, qfalse  },
   { NULL, "g_mapConfigsLoaded", "0", CVAR_ROM, 0, qfalse  },
 
-  { &g_layouts, "g_layouts", "", CVAR_LATCH, 0, qfalse  },
+  { &g_layouts, "g_layouts", "", CVAR_LATCH, 0, qfalse, qfalse, qtrue },
   { &g_layoutAuto, "g_layoutAuto", "1", CVAR_ARCHIVE, 0, qfalse  },
 
   { &g_admin, "g_admin", "admin.dat", CVAR_ARCHIVE, 0, qfalse  },
@@ -428,7 +436,7 @@ static cvarTable_t   gameCvarTable[ ] =
   { &g_adminTempBan, "g_adminTempBan", "2m", CVAR_ARCHIVE, 0, qfalse  },
   { &g_adminMaxBan, "g_adminMaxBan", "2w", CVAR_ARCHIVE, 0, qfalse  },
   { &g_adminTempSpec, "g_adminTempSpec", "2m", CVAR_ARCHIVE, 0, qfalse  },
-  { &g_adminMapLog, "g_adminMapLog", "", CVAR_ROM, 0, qfalse  },
+  { &g_adminMapLog, "g_adminMapLog", "", CVAR_ROM, 0, qfalse, qfalse, qtrue },
   { &g_adminSuperStealth, "g_adminSuperStealth", "0", CVAR_ARCHIVE, 0, qfalse  },
   { &g_minLevelToJoinTeam, "g_minLevelToJoinTeam", "0", CVAR_ARCHIVE, 0, qfalse  },
   { &g_minDeconLevel, "g_minDeconLevel", "0", CVAR_ARCHIVE, 0, qfalse},
@@ -440,7 +448,7 @@ static cvarTable_t   gameCvarTable[ ] =
   { &g_privateMessages, "g_privateMessages", "1", CVAR_ARCHIVE, 0, qfalse  },
   { &g_fullIgnore, "g_fullIgnore", "1", CVAR_ARCHIVE, 0, qtrue  },
   { &g_decolourLogfiles, "g_decolourLogfiles", "0", CVAR_ARCHIVE, 0, qfalse  },
-  { &g_buildLogMaxLength, "g_buildLogMaxLength", "50", CVAR_ARCHIVE, 0, qfalse  },
+  { &g_buildLogMaxLength, "g_buildLogMaxLength", "50", CVAR_ARCHIVE, 0, qfalse, qfalse, qtrue },
   { &g_myStats, "g_myStats", "1", CVAR_ARCHIVE, 0, qtrue  },
   { &g_AllStats, "g_AllStats", "0", CVAR_ARCHIVE, 0, qtrue  },
   { &g_AllStatsTime, "g_AllStatsTime", "60", CVAR_ARCHIVE, 0, qfalse  },
@@ -478,7 +486,7 @@ static cvarTable_t   gameCvarTable[ ] =
   { &g_aimbotAdvertBanReason, "g_aimbotAdvertBanReason", "AUTOBAN: AIMBOT", CVAR_ARCHIVE, 0, qfalse  },
 
   { &g_Bubbles, "g_Bubbles", "1", CVAR_ARCHIVE, 0, qfalse  },
-  { &g_scrimMode, "g_scrimMode", "0", CVAR_ARCHIVE, 0, qfalse },
+  { &g_scrimMode, "g_scrimMode", "0", CVAR_ARCHIVE, 0, qfalse, qfalse, qtrue },
   { &g_gradualFreeFunds, "g_gradualFreeFunds", "2", CVAR_ARCHIVE, 0, qtrue  },
   { &g_bleedingSpree, "g_bleedingSpree", "0", CVAR_ARCHIVE, 0, qfalse  },
   { &g_gradualFreeFunds, "g_gradualFreeFunds", "2", CVAR_ARCHIVE, 0, qtrue  },
@@ -488,7 +496,7 @@ static cvarTable_t   gameCvarTable[ ] =
   { &g_adminAutobahnNotify, "g_adminAutobahnNotify", "1", CVAR_ARCHIVE, 0, qfalse },
   { &g_maxGhosts, "g_maxGhosts", "0", CVAR_ARCHIVE, 0, qfalse },
   { &g_specNoclip, "g_specNoclip", "0", CVAR_ARCHIVE, 0, qtrue },
-  { &g_practise, "g_practise", "0", CVAR_ARCHIVE, 0, qfalse },
+  { &g_practise, "g_practise", "0", CVAR_ARCHIVE, 0, qfalse, qfalse, qtrue },
   { &g_tyrantNerf, "g_tyrantNerf", "0", CVAR_ARCHIVE, 0, qfalse },
 
   { &g_debugRewards, "g_debugRewards", "0", CVAR_ARCHIVE, 0, qfalse },
@@ -499,6 +507,15 @@ static cvarTable_t   gameCvarTable[ ] =
 
 static int gameCvarTableSize = sizeof( gameCvarTable ) / sizeof( gameCvarTable[ 0 ] );
 
+// cvars that aren't refreshed every frame are spread over this many msec
+#define SLOW_CVAR_CYCLE 1000
+
+static cvarTable_t  *frameCvars[ sizeof( gameCvarTable ) / sizeof( gameCvarTable[ 0 ] ) ];
+static cvarTable_t  *slowCvars[ sizeof( gameCvarTable ) / sizeof( gameCvarTable[ 0 ] ) ];
+static int          numFrameCvars, numSlowCvars;
+static int          nextSlowCvar;
+static qboolean     updateAllCvars;
+
 
 void G_InitGame( int levelTime, int randomSeed, int restart );
 void G_RunFrame( int levelTime );
@@ -672,61 +689,196 @@ void G_RegisterCvars( void )
   cvarTable_t *cv;
   qboolean    remapped = qfalse;
 
+  numFrameCvars = numSlowCvars = 0;
+  nextSlowCvar = 0;
+
   for( i = 0, cv = gameCvarTable; i < gameCvarTableSize; i++, cv++ )
   {
     trap_Cvar_Register( cv->vmCvar, cv->cvarName,
       cv->defaultString, cv->cvarFlags );
 
     if( cv->vmCvar )
+    {
       cv->modificationCount = cv->vmCvar->modificationCount;
 
+      if( cv->everyFrame )
+        frameCvars[ numFrameCvars++ ] = cv;
+      else
+        slowCvars[ numSlowCvars++ ] = cv;
+    }
+
     if( cv->teamShader )
       remapped = qtrue;
   }
 
   if( remapped )
     G_RemapTeamShaders( );
+
+  // worldspawn and the map config may set cvars after this
+  updateAllCvars = qtrue;
 }
 
 /*
 =================
-G_UpdateCvars
+G_InitCvarCallbacks
+
+Run every change callback once so the state they maintain starts out in
+line with the cvars, called once level has been cleared
 =================
 */
-void G_UpdateCvars( void )
+static void G_InitCvarCallbacks( void )
 {
   int         i;
   cvarTable_t *cv;
-  qboolean    remapped = qfalse;
 
   for( i = 0, cv = gameCvarTable; i < gameCvarTableSize; i++, cv++ )
   {
-    if( cv->vmCvar )
-    {
-      trap_Cvar_Update( cv->vmCvar );
+    if( cv->changed )
+      cv->changed( );
+  }
+}
 
-      if( cv->modificationCount != cv->vmCvar->modificationCount )
-      {
-        cv->modificationCount = cv->vmCvar->modificationCount;
+/*
+=================
+G_RequestCvarUpdate
 
-        if( cv->trackChange )
-        {
-          trap_SendServerCommand( -1, va( "print \"Server: %s changed to %s\n\"",
-            cv->cvarName, cv->vmCvar->string ) );
-          // update serverinfo in case this cvar is passed to clients indirectly
-          CalculateRanks( );
-        }
+Refresh every cvar on the next G_UpdateCvars, for when something that may
+have set cvars (a console command, an admin command or a vote) has run
+=================
+*/
+void G_RequestCvarUpdate( void )
+{
+  updateAllCvars = qtrue;
+}
 
-        if( cv->teamShader )
-          remapped = qtrue;
-      }
-    }
+/*
+=================
+G_UpdateCvar
+
+Refresh one cvar and dispatch whatever has to happen when it changes.
+Returns qtrue if the team shaders need remapping
+=================
+*/
+static qboolean G_UpdateCvar( cvarTable_t *cv )
+{
+  trap_Cvar_Update( cv->vmCvar );
+
+  if( cv->modificationCount == cv->vmCvar->modificationCount )
+    return qfalse;
+
+  cv->modificationCount = cv->vmCvar->modificationCount;
+
+  if( cv->trackChange )
+  {
+    trap_SendServerCommand( -1, va( "print \"Server: %s changed to %s\n\"",
+      cv->cvarName, cv->vmCvar->string ) );
+    // update serverinfo in case this cvar is passed to clients indirectly
+    CalculateRanks( );
+  }
+
+  if( cv->changed )
+    cv->changed( );
+
+  return cv->teamShader;
+}
+
+/*
+=================
+G_UpdateCvars
+
+Gameplay cvars and the ones the game sets itself are refreshed every
+frame and the rest a few at a time, so each is seen within
+SLOW_CVAR_CYCLE msec, or all at once after G_RequestCvarUpdate.
+
+set, seta and rcon set are handled by the engine without reaching
+ConsoleCommand, so a slow cvar changed that way can take up to
+SLOW_CVAR_CYCLE msec to take effect
+=================
+*/
+void G_UpdateCvars( void )
+{
+  int         i, count;
+  qboolean    remapped = qfalse;
+
+  for( i = 0; i < numFrameCvars; i++ )
+  {
+    if( G_UpdateCvar( frameCvars[ i ] ) )
+      remapped = qtrue;
+  }
+
+  if( updateAllCvars )
+  {
+    updateAllCvars = qfalse;
+    count = numSlowCvars;
+  }
+  else
+  {
+    count = ( numSlowCvars * ( level.time - level.previousTime ) +
+              SLOW_CVAR_CYCLE - 1 ) / SLOW_CVAR_CYCLE;
+    count = MIN( MAX( count, 1 ), numSlowCvars );
+  }
+
+  for( i = 0; i < count; i++ )
+  {
+    if( G_UpdateCvar( slowCvars[ nextSlowCvar ] ) )
+      remapped = qtrue;
+
+    nextSlowCvar = ( nextSlowCvar + 1 ) % numSlowCvars;
   }
 
   if( remapped )
     G_RemapTeamShaders( );
 }
 
+/*
+=================
+G_PasswordChanged
+=================
+*/
+static void G_PasswordChanged( void )
+{
+  if( *g_password.string && Q_stricmp( g_password.string, "none" ) )
+    trap_Cvar_Set( "g_needpass", "1" );
+  else
+    trap_Cvar_Set( "g_needpass", "0" );
+}
+
+/*
+=================
+G_MarkDeconstructChanged
+
+Unmark any structures for deconstruction when the server setting is changed
+=================
+*/
+static void G_MarkDeconstructChanged( void )
+{
+  int       i;
+  gentity_t *ent;
+
+  for( i = 1, ent = g_entities + i ; i < level.num_entities ; i++, ent++ )
+  {
+    if( !ent->inuse )
+      continue;
+
+    if( ent->s.eType != ET_BUILDABLE )
+      continue;
+
+    ent->deconstruct = qfalse;
+  }
+
+  level.buildableGeneration++;
+}
+
+/*
+=================
+G_SuddenDeathTimeChanged
+=================
+*/
+static void G_SuddenDeathTimeChanged( void )
+{
+  level.suddenDeathBeginTime = g_suddenDeathTime.integer * 60000;
+}
+
 /*
 =================
 G_MapConfigs
@@ -750,6 +902,33 @@ void G_MapConfigs( const char *mapname )
   trap_Cvar_Set( "g_mapConfigsLoaded", "1" );
 }
 
+static int  initStageTime;
+static int  initStartTime;
+static char initStageTimes[ MAX_STRING_CHARS ];
+
+/*
+============
+G_InitStage
+
+Note how long the init stage that has just finished took
+============
+*/
+static void G_InitStage( const char *stage )
+{
+  int now = trap_Milliseconds( );
+
+  if( stage )
+    Q_strcat( initStageTimes, sizeof( initStageTimes ),
+              va( " %s %d", stage, now - initStageTime ) );
+  else
+  {
+    initStartTime = now;
+    initStageTimes[ 0 ] = '\0';
+  }
+
+  initStageTime = now;
+}
+
 /*
 ============
 G_InitGame
@@ -760,6 +939,8 @@ void G_InitGame( int levelTime, int randomSeed, int restart )
 {
   int i;
 
+  G_InitStage( NULL );
+
   srand( randomSeed );
 
   G_RegisterCvars( );
@@ -781,6 +962,10 @@ void G_InitGame( int levelTime, int randomSeed, int restart )
 
   level.snd_fry = G_SoundIndex( "sound/misc/fry.wav" ); // FIXME standing in lava / slime
 
+  G_InitCvarCallbacks( );
+
+  G_InitStage( "cvars" );
+
   trap_Cvar_Set( "qvm_version",
                  QVM_NAME " " QVM_VERSIONNUM " (" __DATE__ ", " __TIME__ ")" );
 
@@ -823,12 +1008,17 @@ void G_InitGame( int levelTime, int randomSeed, int restart )
   // we're done with g_mapConfigs, so reset this for the next map
   trap_Cvar_Set( "g_mapConfigsLoaded", "0" );
 
+  G_InitStage( "mapconfigs" );
+
   if ( g_admin.string[ 0 ] ) {
     G_admin_readconfig( NULL, 0 );
   }
 
+  G_InitStage( "admin" );
+
   // initialize all entities for this game
   memset( g_entities, 0, MAX_GENTITIES * sizeof( g_entities[ 0 ] ) );
+  G_InitThinkScheduler( );
   level.gentities = g_entities;
 
   // initialize all clients for this game
@@ -860,6 +1050,8 @@ void G_InitGame( int levelTime, int randomSeed, int restart )
   // parse the key/value pairs and spawn gentities
   G_SpawnEntitiesFromString( );
 
+  G_InitStage( "entities" );
+
   // load up a custom building layout if there is one
   G_LayoutLoad( );
   
@@ -872,11 +1064,15 @@ void G_InitGame( int levelTime, int randomSeed, int restart )
   // general initialization
   G_FindTeams( );
 
+  G_InitStage( "layout" );
+
   //TA:
-  BG_InitClassOverrides( );
-  BG_InitBuildableOverrides( );
+  G_InitOverrides( );
+  G_InitStage( "overrides" );
   G_InitDamageLocations( );
+  G_InitStage( "locdamage" );
   G_InitMapRotations( );
+  G_InitStage( "rotations" );
   G_InitSpawnQueue( &level.alienSpawnQueue );
   G_InitSpawnQueue( &level.humanSpawnQueue );
 
@@ -904,9 +1100,11 @@ void G_InitGame( int levelTime, int randomSeed, int restart )
   G_RemapTeamShaders( );
 
   //TA: so the server counts the spawns without a client attached
+  level.lastAlienSpawns = level.lastHumanSpawns = -1;
   G_CountSpawns( );
 
   G_ResetPTRConnections( );
+  G_LoadSessionData( );
   
   if(g_lockTeamsAtStart.integer)
   {
@@ -914,6 +1112,10 @@ void G_InitGame( int levelTime, int randomSeed, int restart )
     level.humanTeamLocked=qtrue;
     trap_Cvar_Set( "g_lockTeamsAtStart", "0" );
   }
+
+  G_InitStage( "other" );
+  G_Printf( "Initialization took %d msec (%s)\n",
+            initStageTime - initStartTime, initStageTimes + 1 );
 }
 
 /*
@@ -960,6 +1162,7 @@ void G_ShutdownGame( int restart )
 
   // write all the client session data so we can get it back
   G_WriteSessionData( );
+  G_SaveSessionData( );
 
   G_admin_cleanup( );
   G_admin_namelog_cleanup( );
@@ -1042,10 +1245,14 @@ void G_InitSpawnQueue( spawnQueue_t *sq )
 
   sq->back = sq->front = 0;
   sq->back = QUEUE_MINUS1( sq->back );
+  sq->length = 0;
 
   //0 is a valid clientNum, so use something else
   for( i = 0; i < MAX_CLIENTS; i++ )
+  {
     sq->clients[ i ] = -1;
+    sq->slots[ i ] = -1;
+  }
 }
 
 /*
@@ -1057,15 +1264,7 @@ Return tha length of a spawn queue
 */
 int G_GetSpawnQueueLength( spawnQueue_t *sq )
 {
-  int length = sq->back - sq->front + 1;
-
-  while( length < 0 )
-    length += MAX_CLIENTS;
-
-  while( length >= MAX_CLIENTS )
-    length -= MAX_CLIENTS;
-
-  return length;
+  return sq->length;
 }
 
 /*
@@ -1079,10 +1278,12 @@ int G_PopSpawnQueue( spawnQueue_t *sq )
 {
   int clientNum = sq->clients[ sq->front ];
 
-  if( G_GetSpawnQueueLength( sq ) > 0 )
+  if( sq->length > 0 )
   {
     sq->clients[ sq->front ] = -1;
+    sq->slots[ clientNum ] = -1;
     sq->front = QUEUE_PLUS1( sq->front );
+    sq->length--;
     g_entities[ clientNum ].client->ps.pm_flags &= ~PMF_QUEUED;
 
     return clientNum;
@@ -1112,12 +1313,10 @@ Look to see if clientNum is already in the spawnQueue
 */
 qboolean G_SearchSpawnQueue( spawnQueue_t *sq, int clientNum )
 {
-  int i;
+  if( clientNum < 0 || clientNum >= MAX_CLIENTS )
+    return qfalse;
 
-  for( i = 0; i < MAX_CLIENTS; i++ )
-    if( sq->clients[ i ] == clientNum )
-      return qtrue;
-  return qfalse;
+  return sq->slots[ clientNum ] >= 0;
 }
 
 /*
@@ -1130,11 +1329,13 @@ Add an element to the back of the spawn queue
 qboolean G_PushSpawnQueue( spawnQueue_t *sq, int clientNum )
 {
   // don't add the same client more than once
-  if( G_SearchSpawnQueue( sq, clientNum ) )
+  if( G_SearchSpawnQueue( sq, clientNum ) || sq->length >= MAX_CLIENTS )
     return qfalse;
 
   sq->back = QUEUE_PLUS1( sq->back );
   sq->clients[ sq->back ] = clientNum;
+  sq->slots[ clientNum ] = sq->back;
+  sq->length++;
 
   g_entities[ clientNum ].client->ps.pm_flags |= PMF_QUEUED;
   return qtrue;
@@ -1149,35 +1350,25 @@ remove a specific client from a spawn queue
 */
 qboolean G_RemoveFromSpawnQueue( spawnQueue_t *sq, int clientNum )
 {
-  int i = sq->front;
-
-  if( G_GetSpawnQueueLength( sq ) )
-  {
-    do
-    {
-      if( sq->clients[ i ] == clientNum )
-      {
-        //and this kids is why it would have
-        //been better to use an LL for internal
-        //representation
-        do
-        {
-          sq->clients[ i ] = sq->clients[ QUEUE_PLUS1( i ) ];
-
-          i = QUEUE_PLUS1( i );
-        } while( i != QUEUE_PLUS1( sq->back ) );
-
-        sq->back = QUEUE_MINUS1( sq->back );
-        g_entities[ clientNum ].client->ps.pm_flags &= ~PMF_QUEUED;
+  int i;
 
-        return qtrue;
-      }
+  if( !G_SearchSpawnQueue( sq, clientNum ) )
+    return qfalse;
 
-      i = QUEUE_PLUS1( i );
-    } while( i != QUEUE_PLUS1( sq->back ) );
+  // close the gap, moving up only the clients queued behind this one
+  for( i = sq->slots[ clientNum ]; i != sq->back; i = QUEUE_PLUS1( i ) )
+  {
+    sq->clients[ i ] = sq->clients[ QUEUE_PLUS1( i ) ];
+    sq->slots[ sq->clients[ i ] ] = i;
   }
 
-  return qfalse;
+  sq->clients[ sq->back ] = -1;
+  sq->back = QUEUE_MINUS1( sq->back );
+  sq->slots[ clientNum ] = -1;
+  sq->length--;
+  g_entities[ clientNum ].client->ps.pm_flags &= ~PMF_QUEUED;
+
+  return qtrue;
 }
 
 /*
@@ -1189,25 +1380,10 @@ Get the position of a client in a spawn queue
 */
 int G_GetPosInSpawnQueue( spawnQueue_t *sq, int clientNum )
 {
-  int i = sq->front;
-
-  if( G_GetSpawnQueueLength( sq ) )
-  {
-    do
-    {
-      if( sq->clients[ i ] == clientNum )
-      {
-        if( i < sq->front )
-          return i + MAX_CLIENTS - sq->front;
-        else
-          return i - sq->front;
-      }
-
-      i = QUEUE_PLUS1( i );
-    } while( i != QUEUE_PLUS1( sq->back ) );
-  }
+  if( !G_SearchSpawnQueue( sq, clientNum ) )
+    return -1;
 
-  return -1;
+  return ( sq->slots[ clientNum ] - sq->front + MAX_CLIENTS ) % MAX_CLIENTS;
 }
 
 /*
@@ -1220,21 +1396,19 @@ Print the contents of a spawn queue
 void G_PrintSpawnQueue( spawnQueue_t *sq )
 {
   int i = sq->front;
+  int n;
   int length = G_GetSpawnQueueLength( sq );
 
   G_Printf( "l:%d f:%d b:%d    :", length, sq->front, sq->back );
 
-  if( length > 0 )
+  for( n = 0; n < length; n++ )
   {
-    do
-    {
-      if( sq->clients[ i ] == -1 )
-        G_Printf( "*:" );
-      else
-        G_Printf( "%d:", sq->clients[ i ] );
+    if( sq->clients[ i ] == -1 )
+      G_Printf( "*:" );
+    else
+      G_Printf( "%d:", sq->clients[ i ] );
 
-      i = QUEUE_PLUS1( i );
-    } while( i != QUEUE_PLUS1( sq->back ) );
+    i = QUEUE_PLUS1( i );
   }
 
   G_Printf( "\n" );
@@ -1297,28 +1471,18 @@ void G_SpawnClients( pTeam_t team )
 ============
 G_CountSpawns
 
-Counts the number of spawns for each team
+Sends the number of spawns for each team to the clients. The counts
+themselves are kept up to date by G_AccountBuildable
 ============
 */
 void G_CountSpawns( void )
 {
-  int i;
-  gentity_t *ent;
-
-  level.numAlienSpawns = 0;
-  level.numHumanSpawns = 0;
-
-  for( i = 1, ent = g_entities + i ; i < level.num_entities ; i++, ent++ )
-  {
-    if( !ent->inuse )
-      continue;
-
-    if( ent->s.modelindex == BA_A_SPAWN && ent->health > 0 )
-      level.numAlienSpawns++;
+  if( level.numAlienSpawns == level.lastAlienSpawns &&
+      level.numHumanSpawns == level.lastHumanSpawns )
+    return;
 
-    if( ent->s.modelindex == BA_H_SPAWN && ent->health > 0 )
-      level.numHumanSpawns++;
-  }
+  level.lastAlienSpawns = level.numAlienSpawns;
+  level.lastHumanSpawns = level.numHumanSpawns;
 
   //let the client know how many spawns there are
   trap_SetConfigstring( CS_SPAWNS, va( "%d %d",
@@ -1350,9 +1514,6 @@ Recalculate the quantity of building points available to the teams
 */
 void G_CalculateBuildPoints( void )
 {
-  int         i;
-  buildable_t buildable;
-  gentity_t   *ent;
   int         localHTP = g_humanBuildPoints.integer,
               localATP = g_alienBuildPoints.integer;
 
@@ -1389,21 +1550,8 @@ void G_CalculateBuildPoints( void )
 
         if( g_suddenDeathMode.integer == SDMODE_SELECTIVE )
         {
-          for( i = 1, ent = g_entities + i; i < level.num_entities; i++, ent++ )
-          {
-            if( ent->s.eType != ET_BUILDABLE )
-              continue;
-        
-            if( BG_FindReplaceableTestForBuildable( ent->s.modelindex ) )
-            {
-              int t = BG_FindTeamForBuildable( ent->s.modelindex );
-        
-              if( t == BIT_HUMANS )
-                localHTP += BG_FindBuildPointsForBuildable( ent->s.modelindex );
-              else if( t == BIT_ALIENS )
-                localATP += BG_FindBuildPointsForBuildable( ent->s.modelindex );
-            }
-          }
+          localHTP += level.replaceableBuildPointsUsed[ BIT_HUMANS ];
+          localATP += level.replaceableBuildPointsUsed[ BIT_ALIENS ];
         }
         level.suddenDeathHBuildPoints = localHTP;
         level.suddenDeathABuildPoints = localATP;
@@ -1439,46 +1587,23 @@ void G_CalculateBuildPoints( void )
     localATP = g_alienBuildPoints.integer;
   }
 
-  level.humanBuildPoints = level.humanBuildPointsPowered = localHTP;
-  level.alienBuildPoints = localATP;
-
-  level.reactorPresent = qfalse;
-  level.overmindPresent = qfalse;
-
-  for( i = 1, ent = g_entities + i ; i < level.num_entities ; i++, ent++ )
+  if( g_suddenDeath.integer )
   {
-    if( !ent->inuse )
-      continue;
-
-    if( ent->s.eType != ET_BUILDABLE )
-      continue;
-
-    buildable = ent->s.modelindex;
-
-    if( buildable != BA_NONE )
-    {
-      if( buildable == BA_H_REACTOR && ent->spawned && ent->health > 0 )
-        level.reactorPresent = qtrue;
-
-      if( buildable == BA_A_OVERMIND && ent->spawned && ent->health > 0 )
-        level.overmindPresent = qtrue;
-
-      if( !g_suddenDeath.integer || BG_FindReplaceableTestForBuildable( buildable ) )
-      {
-        if( BG_FindTeamForBuildable( buildable ) == BIT_HUMANS )
-        {
-          level.humanBuildPoints -= BG_FindBuildPointsForBuildable( buildable );
-          if( ent->powered )
-            level.humanBuildPointsPowered -= BG_FindBuildPointsForBuildable( buildable );
-        }
-        else
-        {
-          level.alienBuildPoints -= BG_FindBuildPointsForBuildable( buildable );
-        }
-      }
-    }
+    level.humanBuildPoints = localHTP - level.replaceableBuildPointsUsed[ BIT_HUMANS ];
+    level.humanBuildPointsPowered =
+      localHTP - level.poweredReplaceableBuildPointsUsed[ BIT_HUMANS ];
+    level.alienBuildPoints = localATP - level.replaceableBuildPointsUsed[ BIT_ALIENS ];
+  }
+  else
+  {
+    level.humanBuildPoints = localHTP - level.buildPointsUsed[ BIT_HUMANS ];
+    level.humanBuildPointsPowered = localHTP - level.poweredBuildPointsUsed[ BIT_HUMANS ];
+    level.alienBuildPoints = localATP - level.buildPointsUsed[ BIT_ALIENS ];
   }
 
+  level.reactorPresent = ( level.numReactors > 0 );
+  level.overmindPresent = ( level.numOverminds > 0 );
+
   if( level.humanBuildPoints < 0 )
   {
     localHTP -= level.humanBuildPoints;
@@ -2590,7 +2715,10 @@ void CheckVote( void )
     }
 
     if( level.voteString[0] )
+    {
       trap_SendConsoleCommand( EXEC_APPEND, va( "%s\n", level.voteString ) );
+      G_RequestCvarUpdate( );
+    }
 
     if( !Q_stricmp( level.voteString, "map_restart" ) ||
         !Q_stricmpn( level.voteString, "map", 3 ) )
@@ -2707,6 +2835,7 @@ void CheckTeamVote( int team )
       // execute the command, then remove the vote
       trap_SendServerCommand( -1, va("print \"Team vote ^Zpassed ^7(^ZYes: ^7%d | ^ANo: ^7%d)\n\"", level.teamVoteYes[ cs_offset ], level.teamVoteNo[ cs_offset ] ) );
       trap_SendConsoleCommand( EXEC_APPEND, va( "%s\n", level.teamVoteString[ cs_offset ] ) );
+      G_RequestCvarUpdate( );
     }
     else
     {
@@ -2723,6 +2852,7 @@ void CheckTeamVote( int team )
       G_LogPrintf( "Teamvote: Team vote passed (%d - %d)\n", level.teamVoteYes[ cs_offset ], level.teamVoteNo[ cs_offset ] );
       //
       trap_SendConsoleCommand( EXEC_APPEND, va( "%s\n", level.teamVoteString[ cs_offset ] ) );
+      G_RequestCvarUpdate( );
     }
     else if( level.teamVoteNo[ cs_offset ] >= level.numteamVotingClients[ cs_offset ] / 2 )
     {
@@ -2842,57 +2972,6 @@ void CheckCountdown( void )
 }
 
 
-/*
-==================
-CheckCvars
-==================
-*/
-void CheckCvars( void )
-{
-  static int lastPasswordModCount   = -1;
-  static int lastMarkDeconModCount  = -1;
-  static int lastSDTimeModCount = -1;
-
-  if( g_password.modificationCount != lastPasswordModCount )
-  {
-    lastPasswordModCount = g_password.modificationCount;
-
-    if( *g_password.string && Q_stricmp( g_password.string, "none" ) )
-      trap_Cvar_Set( "g_needpass", "1" );
-    else
-      trap_Cvar_Set( "g_needpass", "0" );
-  }
-
-  // Unmark any structures for deconstruction when
-  // the server setting is changed
-  if( g_markDeconstruct.modificationCount != lastMarkDeconModCount )
-  {
-    int       i;
-    gentity_t *ent;
-
-    lastMarkDeconModCount = g_markDeconstruct.modificationCount;
-
-    for( i = 1, ent = g_entities + i ; i < level.num_entities ; i++, ent++ )
-    {
-      if( !ent->inuse )
-        continue;
-
-      if( ent->s.eType != ET_BUILDABLE )
-        continue;
-
-      ent->deconstruct = qfalse;
-    }
-  }
-
-  if( g_suddenDeathTime.modificationCount != lastSDTimeModCount )
-  {
-    lastSDTimeModCount = g_suddenDeathTime.modificationCount;
-    level.suddenDeathBeginTime = g_suddenDeathTime.integer * 60000;
-  }
-
-  level.frameMsec = trap_Milliseconds( );
-}
-
 /*
 =============
 G_RunThink
@@ -2986,12 +3065,15 @@ void G_RunFrame( int levelTime )
   G_UpdateCvars( );
 
   //
-  // go through all allocated objects
+  // go through all allocated objects, skipping those parked until their
+  // next think
   //
-  ent = &g_entities[ 0 ];
+  G_WakeThinkers( );
 
-  for( i = 0; i < level.num_entities; i++, ent++ )
+  for( i = G_NextAwakeEntity( 0 ); i < level.num_entities; i = G_NextAwakeEntity( i + 1 ) )
   {
+    ent = &g_entities[ i ];
+
     if( !ent->inuse )
       continue;
 
@@ -3065,6 +3147,7 @@ void G_RunFrame( int levelTime )
     }
 
     G_RunThink( ent );
+    G_ParkEntity( ent );
   }
 
   // perform final fixups on the players
@@ -3080,6 +3163,9 @@ void G_RunFrame( int levelTime )
   G_UnlaggedStore( );
 
   //TA:
+  if( g_debugBuildPoints.integer )
+    G_CheckBuildableAccounting( );
+
   G_CountSpawns( );
   G_CalculateBuildPoints( );
   G_CalculateStages( );
@@ -3103,8 +3189,7 @@ void G_RunFrame( int levelTime )
 
   G_admin_schachtmeisterFrame();
 
-  // for tracking changes
-  CheckCvars( );
+  level.frameMsec = trap_Milliseconds( );
 
   if( g_listEntity.integer )
   {
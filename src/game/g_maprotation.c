@@ -42,26 +42,6 @@ qboolean G_MapExists( char *name )
   return trap_FS_FOpenFile( va( "maps/%s.bsp", name ), NULL, FS_READ );
 }
 
-/*
-===============
-G_RotationExists
-
-Check if a rotation exists
-===============
-*/
-static qboolean G_RotationExists( char *name )
-{
-  int i;
-
-  for( i = 0; i < mapRotations.numRotations; i++ )
-  {
-    if( Q_strncmp( mapRotations.rotations[ i ].name, name, MAX_QPATH ) == 0 )
-      return qtrue;
-  }
-
-  return qfalse;
-}
-
 /*
 ===============
 G_ParseCommandSection
@@ -427,7 +407,7 @@ Load the map rotations from a map rotation file
 static qboolean G_ParseMapRotationFile( const char *fileName )
 {
   char          *text_p;
-  int           i, j, k;
+  int           i;
   int           len;
   char          *token;
   char          text[ 20000 ];
@@ -521,37 +501,256 @@ static qboolean G_ParseMapRotationFile( const char *fileName )
     }
   }
 
+  return qtrue;
+}
+
+/*
+===============
+G_ResolveConditionDestination
+
+Resolve the destination of a condition on a map in rotation
+===============
+*/
+static mapConditionType_t G_ResolveConditionDestination( int rotation, int *n, char *name )
+{
+  int i;
+
+  //search the condition's own rotation first...
+  for( i = 0; i < mapRotations.rotations[ rotation ].numMaps; i++ )
+  {
+    if( !Q_stricmp( mapRotations.rotations[ rotation ].maps[ i ].name, name ) )
+    {
+      *n = i;
+      return MCT_MAP;
+    }
+  }
+
+  //...then search the rotation names
+  for( i = 0; i < mapRotations.numRotations; i++ )
+  {
+    if( !Q_stricmp( mapRotations.rotations[ i ].name, name ) )
+    {
+      *n = i;
+      return MCT_ROTATION;
+    }
+  }
+
+  *n = -1;
+  return MCT_ERR;
+}
+
+/*
+===============
+G_CompileMapRotations
+
+Resolve every conditional destination to a map or rotation index and note
+which maps are installed, so that nothing has to be looked up by name or
+opened on disk when the rotation advances
+===============
+*/
+static void G_CompileMapRotations( void )
+{
+  mapRotation_t           *mr;
+  mapRotationEntry_t      *mre;
+  mapRotationCondition_t  *mrc;
+  int                     i, j, k;
+
+  for( i = 0; i < mapRotations.numRotations; i++ )
+  {
+    mr = &mapRotations.rotations[ i ];
+
+    for( j = 0; j < mr->numMaps; j++ )
+    {
+      mre = &mr->maps[ j ];
+      mre->exists = !Q_stricmp( mre->name, "*VOTE*" ) ||
+                    !Q_stricmp( mre->name, "*RANDOM*" ) ||
+                    G_MapExists( mre->name );
+    }
+  }
+
+  for( i = 0; i < mapRotations.numRotations; i++ )
+  {
+    mr = &mapRotations.rotations[ i ];
+
+    for( j = 0; j < mr->numMaps; j++ )
+    {
+      mre = &mr->maps[ j ];
+
+      for( k = 0; k < mre->numConditions; k++ )
+      {
+        mrc = &mre->conditions[ k ];
+        mrc->destType = G_ResolveConditionDestination( i, &mrc->destIndex, mrc->dest );
+
+        // a map in the same rotation has already been checked
+        if( mrc->destType == MCT_MAP && mr->maps[ mrc->destIndex ].name[ 0 ] != '*' )
+          mrc->destExists = mr->maps[ mrc->destIndex ].exists;
+        else
+          mrc->destExists = G_MapExists( mrc->dest );
+      }
+    }
+  }
+}
+
+/*
+===============
+G_CheckMapRotations
+
+Check that every map and conditional destination in the loaded rotations
+exists. This depends on the installed maps as well as the rotation file, so
+it is repeated even when the rotations come from the cache
+===============
+*/
+static qboolean G_CheckMapRotations( void )
+{
+  mapRotationEntry_t      *mre;
+  mapRotationCondition_t  *mrc;
+  int                     i, j, k;
+
   for( i = 0; i < mapRotations.numRotations; i++ )
   {
     for( j = 0; j < mapRotations.rotations[ i ].numMaps; j++ )
     {
-      if( Q_stricmp( mapRotations.rotations[ i ].maps[ j ].name, "*VOTE*") != 0 &&
-          Q_stricmp( mapRotations.rotations[ i ].maps[ j ].name, "*RANDOM*") != 0 &&
-          !G_MapExists( mapRotations.rotations[ i ].maps[ j ].name ) )
+      mre = &mapRotations.rotations[ i ].maps[ j ];
+
+      if( !mre->exists )
       {
-        G_Printf( S_COLOR_RED "ERROR: map \"%s\" doesn't exist\n",
-          mapRotations.rotations[ i ].maps[ j ].name );
+        G_Printf( S_COLOR_RED "ERROR: map \"%s\" doesn't exist\n", mre->name );
         return qfalse;
       }
 
-      for( k = 0; k < mapRotations.rotations[ i ].maps[ j ].numConditions; k++ )
+      for( k = 0; k < mre->numConditions; k++ )
       {
-        if( !G_MapExists( mapRotations.rotations[ i ].maps[ j ].conditions[ k ].dest ) &&
-            !G_RotationExists( mapRotations.rotations[ i ].maps[ j ].conditions[ k ].dest ) )
+        mrc = &mre->conditions[ k ];
+
+        if( !mrc->destExists && mrc->destType != MCT_ROTATION )
         {
           G_Printf( S_COLOR_RED "ERROR: conditional destination \"%s\" doesn't exist\n",
-            mapRotations.rotations[ i ].maps[ j ].conditions[ k ].dest );
+            mrc->dest );
           return qfalse;
         }
+      }
+    }
+  }
+
+  return qtrue;
+}
+
+/*
+===============
+G_ReadMapRotationCache
 
+Load the rotations from the cache if fileName hasn't changed since it was
+written. Only the commands and conditions in use are stored
+===============
+*/
+static qboolean G_ReadMapRotationCache( configSources_t *sources )
+{
+  fileHandle_t        f;
+  int                 length, len, i, j, k;
+  mapRotation_t       *mr;
+  mapRotationEntry_t  *mre;
+  qboolean            ok;
+
+  length = G_ReadConfigCache( "maprotation.bin", sources, &f );
+  if( length < 0 )
+    return qfalse;
+
+  ok = G_ReadConfigCacheData( f, &mapRotations.numRotations, sizeof( int ), &length ) &&
+       mapRotations.numRotations >= 0 && mapRotations.numRotations <= MAX_MAP_ROTATIONS;
+
+  for( i = 0; ok && i < mapRotations.numRotations; i++ )
+  {
+    mr = &mapRotations.rotations[ i ];
+
+    ok = G_ReadConfigCacheData( f, mr->name, sizeof( mr->name ), &length ) &&
+         G_ReadConfigCacheData( f, &mr->numMaps, sizeof( int ), &length ) &&
+         mr->numMaps >= 0 && mr->numMaps <= MAX_MAP_ROTATION_MAPS;
+
+    for( j = 0; ok && j < mr->numMaps; j++ )
+    {
+      mre = &mr->maps[ j ];
+
+      ok = G_ReadConfigCacheData( f, mre->name, sizeof( mre->name ), &length ) &&
+           G_ReadConfigCacheData( f, mre->layouts, sizeof( mre->layouts ), &length ) &&
+           G_ReadConfigCacheData( f, &mre->numCmds, sizeof( int ), &length ) &&
+           G_ReadConfigCacheData( f, &mre->numConditions, sizeof( int ), &length ) &&
+           mre->numCmds >= 0 && mre->numCmds <= MAX_MAP_COMMANDS &&
+           mre->numConditions >= 0 && mre->numConditions <= MAX_MAP_ROTATION_CONDS;
+
+      for( k = 0; ok && k < mre->numCmds; k++ )
+      {
+        ok = G_ReadConfigCacheData( f, &len, sizeof( int ), &length ) &&
+             len > 0 && len <= MAX_STRING_CHARS &&
+             G_ReadConfigCacheData( f, mre->postCmds[ k ], len, &length );
+        if( ok )
+          mre->postCmds[ k ][ len - 1 ] = '\0';
       }
 
+      if( ok )
+        ok = G_ReadConfigCacheData( f, mre->conditions,
+               mre->numConditions * sizeof( mapRotationCondition_t ), &length );
     }
   }
 
+  trap_FS_FCloseFile( f );
+
+  if( !ok || length != 0 )
+  {
+    memset( &mapRotations, 0, sizeof( mapRotations ) );
+    return qfalse;
+  }
+
   return qtrue;
 }
 
+/*
+===============
+G_WriteMapRotationCache
+===============
+*/
+static void G_WriteMapRotationCache( configSources_t *sources )
+{
+  fileHandle_t        f;
+  int                 len, i, j, k;
+  mapRotation_t       *mr;
+  mapRotationEntry_t  *mre;
+
+  if( !( f = G_WriteConfigCache( "maprotation.bin", sources ) ) )
+    return;
+
+  trap_FS_Write( &mapRotations.numRotations, sizeof( int ), f );
+
+  for( i = 0; i < mapRotations.numRotations; i++ )
+  {
+    mr = &mapRotations.rotations[ i ];
+
+    trap_FS_Write( mr->name, sizeof( mr->name ), f );
+    trap_FS_Write( &mr->numMaps, sizeof( int ), f );
+
+    for( j = 0; j < mr->numMaps; j++ )
+    {
+      mre = &mr->maps[ j ];
+
+      trap_FS_Write( mre->name, sizeof( mre->name ), f );
+      trap_FS_Write( mre->layouts, sizeof( mre->layouts ), f );
+      trap_FS_Write( &mre->numCmds, sizeof( int ), f );
+      trap_FS_Write( &mre->numConditions, sizeof( int ), f );
+
+      for( k = 0; k < mre->numCmds; k++ )
+      {
+        len = strlen( mre->postCmds[ k ] ) + 1;
+        trap_FS_Write( &len, sizeof( int ), f );
+        trap_FS_Write( mre->postCmds[ k ], len, f );
+      }
+
+      trap_FS_Write( mre->conditions,
+                     mre->numConditions * sizeof( mapRotationCondition_t ), f );
+    }
+  }
+
+  trap_FS_FCloseFile( f );
+}
+
 /*
 ===============
 G_PrintRotations
@@ -595,6 +794,129 @@ void G_PrintRotations( void )
   G_Printf( "Total memory used: %d bytes\n", sizeof( mapRotations ) );
 }
 
+/*
+===============
+G_ValidateMapRotations
+
+Walk each rotation from its first map and report maps that are missing or
+can never be reached, and destinations that can't be resolved. Only the
+existence bits are refreshed, the current map and rotation are untouched
+===============
+*/
+void G_ValidateMapRotations( const char *name )
+{
+  mapRotation_t           *mr;
+  mapRotationEntry_t      *mre;
+  mapRotationCondition_t  *mrc;
+  qboolean                reached[ MAX_MAP_ROTATION_MAPS ];
+  int                     queue[ MAX_MAP_ROTATION_MAPS ];
+  int                     head, tail;
+  qboolean                overridden;
+  int                     i, j, k, checked = 0, problems = 0;
+
+  G_CompileMapRotations( );
+
+  for( i = 0; i < mapRotations.numRotations; i++ )
+  {
+    mr = &mapRotations.rotations[ i ];
+
+    if( name && name[ 0 ] && Q_stricmp( mr->name, name ) )
+      continue;
+
+    checked++;
+
+    if( !mr->numMaps )
+    {
+      G_Printf( "%s: rotation has no maps\n", mr->name );
+      problems++;
+      continue;
+    }
+
+    memset( reached, 0, sizeof( reached ) );
+    reached[ 0 ] = qtrue;
+    queue[ 0 ] = 0;
+    head = 0;
+    tail = 1;
+
+    while( head < tail )
+    {
+      j = queue[ head++ ];
+      mre = &mr->maps[ j ];
+
+      if( !mre->exists )
+      {
+        G_Printf( "%s: map %d \"%s\" is missing\n", mr->name, j + 1, mre->name );
+        problems++;
+      }
+
+      overridden = qfalse;
+      for( k = 0; k < mre->numConditions; k++ )
+      {
+        mrc = &mre->conditions[ k ];
+
+        // vote and random choices are map names, not rotation destinations
+        if( mrc->lhs == MCV_VOTE || mrc->lhs == MCV_SELECTEDRANDOM )
+        {
+          if( !mrc->destExists )
+          {
+            G_Printf( "%s: map %d \"%s\" offers missing map \"%s\"\n",
+                      mr->name, j + 1, mre->name, mrc->dest );
+            problems++;
+          }
+          continue;
+        }
+
+        if( mrc->destType == MCT_ERR )
+        {
+          G_Printf( "%s: map %d \"%s\" goes to \"%s\" which %s\n",
+                    mr->name, j + 1, mre->name, mrc->dest,
+                    mrc->destExists ? "is not in this rotation" :
+                                      "is not a map or rotation" );
+          problems++;
+          continue;
+        }
+
+        if( mrc->destType == MCT_MAP && !reached[ mrc->destIndex ] )
+        {
+          reached[ mrc->destIndex ] = qtrue;
+          queue[ tail++ ] = mrc->destIndex;
+        }
+
+        if( mrc->unconditional )
+        {
+          overridden = qtrue;
+
+          // later conditions are never evaluated
+          if( mrc->destType == MCT_ROTATION )
+            break;
+        }
+      }
+
+      if( !overridden && !reached[ ( j + 1 ) % mr->numMaps ] )
+      {
+        reached[ ( j + 1 ) % mr->numMaps ] = qtrue;
+        queue[ tail++ ] = ( j + 1 ) % mr->numMaps;
+      }
+    }
+
+    for( j = 0; j < mr->numMaps; j++ )
+    {
+      if( reached[ j ] )
+        continue;
+
+      G_Printf( "%s: map %d \"%s\" is unreachable%s\n", mr->name, j + 1,
+                mr->maps[ j ].name, mr->maps[ j ].exists ? "" : " and missing" );
+      problems++;
+    }
+  }
+
+  if( name && name[ 0 ] && !checked )
+    G_Printf( "no map rotation named \"%s\"\n", name );
+  else
+    G_Printf( "%d rotation%s checked, %d problem%s found\n",
+              checked, checked == 1 ? "" : "s", problems, problems == 1 ? "" : "s" );
+}
+
 /*
 ===============
 G_GetCurrentMapArray
@@ -745,40 +1067,6 @@ static void G_IssueMapChange( int rotation )
   }
 }
 
-/*
-===============
-G_ResolveConditionDestination
-
-Resolve the destination of some condition
-===============
-*/
-static mapConditionType_t G_ResolveConditionDestination( int *n, char *name )
-{
-  int i;
-
-  //search the current rotation first...
-  for( i = 0; i < mapRotations.rotations[ g_currentMapRotation.integer ].numMaps; i++ )
-  {
-    if( !Q_stricmp( mapRotations.rotations[ g_currentMapRotation.integer ].maps[ i ].name, name ) )
-    {
-      *n = i;
-      return MCT_MAP;
-    }
-  }
-
-  //...then search the rotation names
-  for( i = 0; i < mapRotations.numRotations; i++ )
-  {
-    if( !Q_stricmp( mapRotations.rotations[ i ].name, name ) )
-    {
-      *n = i;
-      return MCT_ROTATION;
-    }
-  }
-
-  return MCT_ERR;
-}
-
 /*
 ===============
 G_EvaluateMapCondition
@@ -831,6 +1119,22 @@ static qboolean G_EvaluateMapCondition( mapRotationCondition_t *mrc )
   return qfalse;
 }
 
+/*
+===============
+G_SwitchMapRotation
+
+Make rotation the current map rotation
+===============
+*/
+static void G_SwitchMapRotation( int rotation, qboolean changeMap )
+{
+  trap_Cvar_Set( "g_currentMapRotation", va( "%d", rotation ) );
+  trap_Cvar_Update( &g_currentMapRotation );
+
+  if( changeMap )
+    G_IssueMapChange( rotation );
+}
+
 /*
 ===============
 G_AdvanceMapRotation
@@ -844,8 +1148,7 @@ qboolean G_AdvanceMapRotation( void )
   mapRotationEntry_t      *mre;
   mapRotationCondition_t  *mrc;
   int                     currentRotation, currentMap, nextMap;
-  int                     i, n;
-  mapConditionType_t      mct;
+  int                     i;
 
   if( ( currentRotation = g_currentMapRotation.integer ) == NOT_ROTATING )
     return qfalse;
@@ -862,19 +1165,17 @@ qboolean G_AdvanceMapRotation( void )
 
     if( mrc->unconditional || G_EvaluateMapCondition( mrc ) )
     {
-      mct = G_ResolveConditionDestination( &n, mrc->dest );
-
-      switch( mct )
+      switch( mrc->destType )
       {
         case MCT_MAP:
-          nextMap = n;
+          nextMap = mrc->destIndex;
           break;
 
         case MCT_ROTATION:
           //need to increment the current map before changing the rotation
           //or you get infinite loops with some conditionals
           G_SetCurrentMap( nextMap, currentRotation );
-          G_StartMapRotation( mrc->dest, qtrue );
+          G_SwitchMapRotation( mrc->destIndex, qtrue );
           return qtrue;
           break;
 
@@ -908,11 +1209,7 @@ qboolean G_StartMapRotation( char *name, qboolean changeMap )
   {
     if( !Q_stricmp( mapRotations.rotations[ i ].name, name ) )
     {
-      trap_Cvar_Set( "g_currentMapRotation", va( "%d", i ) );
-      trap_Cvar_Update( &g_currentMapRotation );
-
-      if( changeMap )
-        G_IssueMapChange( i );
+      G_SwitchMapRotation( i, changeMap );
       break;
     }
   }
@@ -957,12 +1254,26 @@ Load and intialise the map rotations
 */
 void G_InitMapRotations( void )
 {
-  const char    *fileName = "maprotation.cfg";
+  const char      *fileName = "maprotation.cfg";
+  configSources_t sources;
+  qboolean        loaded = qtrue;
 
   //load the file if it exists
   if( trap_FS_FOpenFile( fileName, NULL, FS_READ ) )
   {
-    if( !G_ParseMapRotationFile( fileName ) )
+    sources.numSources = 0;
+    G_AddConfigSource( &sources, fileName );
+
+    if( !G_ReadMapRotationCache( &sources ) )
+    {
+      if( ( loaded = G_ParseMapRotationFile( fileName ) ) )
+        G_WriteMapRotationCache( &sources );
+    }
+
+    if( loaded )
+      G_CompileMapRotations( );
+
+    if( !loaded || !G_CheckMapRotations( ) )
       G_Printf( S_COLOR_RED "ERROR: failed to parse %s file\n", fileName );
   }
   else
@@ -981,11 +1292,20 @@ void G_InitMapRotations( void )
 }
 
 static char rotationVoteList[ MAX_MAP_ROTATION_CONDS ][ MAX_QPATH ];
+static qboolean rotationVoteExists[ MAX_MAP_ROTATION_CONDS ];
 static int rotationVoteLen = 0;
 
 static int rotationVoteClientPosition[ MAX_CLIENTS ];
 static int rotationVoteClientSelection[ MAX_CLIENTS ];
 
+// running tallies, kept up to date as votes are cast
+static int rotationVoteCounts[ MAX_MAP_ROTATION_CONDS ];
+static int rotationVoteRanks[ MAX_MAP_ROTATION_CONDS ];
+static int rotationVoteTotal;
+static int rotationVoteWinner;
+
+static void G_RankMapVotes( void );
+
 /*
 ===============
 G_CheckMapRotationVote
@@ -1021,6 +1341,7 @@ qboolean G_CheckMapRotationVote( void )
     {
       Q_strncpyz( rotationVoteList[ rotationVoteLen ], mrc->dest,
         sizeof(  rotationVoteList[ rotationVoteLen ] ) );
+      rotationVoteExists[ rotationVoteLen ] = mrc->destExists;
       rotationVoteLen++;
       if( rotationVoteLen >= MAX_MAP_ROTATION_CONDS )
         break;
@@ -1036,75 +1357,49 @@ qboolean G_CheckMapRotationVote( void )
     rotationVoteClientSelection[ i ] = -1;
   }
 
-  return qtrue;
-}
-
-typedef struct {
-  int votes;
-  int map;
-} MapVoteResultsSort_t;
-
-static int SortMapVoteResults( const void *av, const void *bv )
-{
-  const MapVoteResultsSort_t *a = av;
-  const MapVoteResultsSort_t *b = bv;
-
-  if( a->votes > b->votes )
-    return -1;
-  if( a->votes < b->votes )
-    return 1;
+  for( i = 0; i < MAX_MAP_ROTATION_CONDS; i++ )
+    rotationVoteCounts[ i ] = 0;
 
-  if( a->map > b->map )
-    return 1;
-  if( a->map < b->map )
-    return -1;
+  rotationVoteTotal = 0;
+  G_RankMapVotes( );
 
-  return 0;
+  return qtrue;
 }
 
-static int G_GetMapVoteWinner( int *winvotes, int *totalvotes, int *resultorder )
+/*
+===============
+G_RankMapVotes
+
+Rank the vote choices by their running tallies, most votes first and the
+earlier choice on a tie. Only needed when a vote changes
+===============
+*/
+static void G_RankMapVotes( void )
 {
-  MapVoteResultsSort_t results[ MAX_MAP_ROTATION_CONDS ];
-  int tv = 0;
-  int i, n;
+  int i, j, rank;
 
   for( i = 0; i < MAX_MAP_ROTATION_CONDS; i++ )
   {
-    results[ i ].votes = 0;
-    results[ i ].map = i;
-  }
-  for( i = 0; i < MAX_CLIENTS; i++ )
-  {
-    n = rotationVoteClientSelection[ i ];
-    if( n >=0 && n < MAX_MAP_ROTATION_CONDS )
+    rank = 0;
+    for( j = 0; j < MAX_MAP_ROTATION_CONDS; j++ )
     {
-      results[ n ].votes += 1;
-      tv++;
+      if( rotationVoteCounts[ j ] > rotationVoteCounts[ i ] ||
+          ( rotationVoteCounts[ j ] == rotationVoteCounts[ i ] && j < i ) )
+        rank++;
     }
-  }
-
-  qsort ( results, MAX_MAP_ROTATION_CONDS, sizeof( results[ 0 ] ), SortMapVoteResults );
 
-  if( winvotes != NULL )
-    *winvotes = results[ 0 ].votes;
-  if( totalvotes != NULL )
-    *totalvotes = tv;
-
-  if( resultorder != NULL )
-  {
-    for( i = 0; i < MAX_MAP_ROTATION_CONDS; i++ )
-      resultorder[ results[ i ].map ] = i;
+    rotationVoteRanks[ i ] = rank;
+    if( !rank )
+      rotationVoteWinner = i;
   }
-
-  return results[ 0 ].map;
 }
 
 qboolean G_IntermissionMapVoteWinner( void )
 {
-  int winvotes, totalvotes;
+  int winvotes = rotationVoteCounts[ rotationVoteWinner ];
+  int totalvotes = rotationVoteTotal;
   int nonvotes;
 
-  G_GetMapVoteWinner( &winvotes, &totalvotes, NULL );
   if( winvotes * 2 > level.numConnectedClients )
     return qtrue;
   nonvotes = level.numConnectedClients - totalvotes;
@@ -1122,14 +1417,12 @@ static qboolean G_GetVotedMap( char *name, int size, int rotation, int map )
   mapRotationEntry_t      *mre;
   mapRotationCondition_t  *mrc;
   int                     i, n;
-  int                     winner;
+  int                     winner = rotationVoteWinner;
   qboolean                found = qfalse;
 
   if( !rotationVoteLen )
     return qfalse;
 
-  winner = G_GetMapVoteWinner( NULL, NULL, NULL );
-
   mr = &mapRotations.rotations[ rotation ];
   mre = &mr->maps[ map ];
 
@@ -1155,37 +1448,30 @@ static qboolean G_GetVotedMap( char *name, int size, int rotation, int map )
   return found;
 }
 
-static void G_IntermissionMapVoteMessageReal( gentity_t *ent, int winner, int winvotes, int totalvotes, int *ranklist )
+/*
+===============
+G_MapVoteMessageString
+
+Build the vote menu from the running tallies, marking the choice under the
+cursor (selection) and the choice voted for (index)
+===============
+*/
+static void G_MapVoteMessageString( char *string, int size, int index, int selection )
 {
-  int  clientNum;
-  char string[ MAX_STRING_CHARS ];
   char entry[ MAX_STRING_CHARS ];
-  int  ourlist[ MAX_MAP_ROTATION_CONDS ];
-  int  len = 0;
-  int  index, selection;
+  int  winvotes = rotationVoteCounts[ rotationVoteWinner ];
   int  i;
   char *color;
   char *rank;
 
-  clientNum = ent-g_entities;
-
-  index = rotationVoteClientSelection[ clientNum ];
-  selection = rotationVoteClientPosition[ clientNum ];
-
-  if( winner < 0 || winner >= MAX_MAP_ROTATION_CONDS || ranklist == NULL )
-  {
-    ranklist = &ourlist[0];
-    winner = G_GetMapVoteWinner( &winvotes, &totalvotes, ranklist );
-  }
-
   Q_strncpyz( string, "^7Attack = down ^0/^7 Repair = up ^0/^7 F1 = vote\n\n"
     "^2Map Vote Menu\n"
-    "^7+------------------+\n", sizeof( string ) );
+    "^7+------------------+\n", size );
   for( i = 0; i < rotationVoteLen; i++ )
   {
-    if( !G_MapExists( rotationVoteList[ i ] ) )
+    if( !rotationVoteExists[ i ] )
       continue;
-    
+
     if( i == selection )
       color = "^5";
     else if( i == index )
@@ -1193,7 +1479,7 @@ static void G_IntermissionMapVoteMessageReal( gentity_t *ent, int winner, int wi
     else
       color = "^7";
 
-    switch( ranklist[ i ] )
+    switch( rotationVoteRanks[ i ] )
     {
       case 0:
         rank = "^7---";
@@ -1219,40 +1505,68 @@ static void G_IntermissionMapVoteMessageReal( gentity_t *ent, int winner, int wi
      ( i == selection ) ? "^7)" : " ",
      ( i == index ) ? "^1<<<" : "" );
 
-    Q_strcat( string, sizeof( string ), entry );
-    len += strlen( entry );
+    Q_strcat( string, size, entry );
   }
 
   Com_sprintf( entry, sizeof( entry ),
     "\n^7+----------------+\nleader: ^3%s^7 with %d vote%s\nvoters: %d\ntime left: %d",
-    rotationVoteList[ winner ],
+    rotationVoteList[ rotationVoteWinner ],
     winvotes,
     ( winvotes == 1 ) ? "" : "s",
-    totalvotes,
+    rotationVoteTotal,
     ( level.mapRotationVoteTime - level.time ) / 1000 );
-  Q_strcat( string, sizeof( string ), entry );
-
-  trap_SendServerCommand( ent-g_entities, va( "cp \"%s\"\n", string ) );
+  Q_strcat( string, size, entry );
 }
 
+/*
+===============
+G_IntermissionMapVoteMessageAll
+
+Clients only differ in their two menu markers, so the menu is built once
+for each combination of markers in use and sent to every client sharing it
+===============
+*/
 void G_IntermissionMapVoteMessageAll( void )
 {
-  int ranklist[ MAX_MAP_ROTATION_CONDS ];
-  int winner;
-  int winvotes, totalvotes;
-  int i;
+  char      string[ MAX_STRING_CHARS ];
+  qboolean  sent[ MAX_CLIENTS ];
+  int       index, selection;
+  int       i, j;
+
+  for( i = 0; i < level.maxclients; i++ )
+    sent[ i ] = ( level.clients[ i ].pers.connected != CON_CONNECTED );
 
-  winner = G_GetMapVoteWinner( &winvotes, &totalvotes, &ranklist[ 0 ] );
   for( i = 0; i < level.maxclients; i++ )
   {
-    if( level.clients[ i ].pers.connected == CON_CONNECTED )
-      G_IntermissionMapVoteMessageReal( g_entities + i, winner, winvotes, totalvotes, ranklist );
+    if( sent[ i ] )
+      continue;
+
+    index = rotationVoteClientSelection[ i ];
+    selection = rotationVoteClientPosition[ i ];
+    G_MapVoteMessageString( string, sizeof( string ), index, selection );
+
+    for( j = i; j < level.maxclients; j++ )
+    {
+      if( sent[ j ] ||
+          rotationVoteClientSelection[ j ] != index ||
+          rotationVoteClientPosition[ j ] != selection )
+        continue;
+
+      trap_SendServerCommand( j, va( "cp \"%s\"\n", string ) );
+      sent[ j ] = qtrue;
+    }
   }
 }
 
 void G_IntermissionMapVoteMessage( gentity_t *ent )
 {
-   G_IntermissionMapVoteMessageReal( ent, -1, 0, 0, NULL );
+  char string[ MAX_STRING_CHARS ];
+  int  clientNum = ent - g_entities;
+
+  G_MapVoteMessageString( string, sizeof( string ),
+    rotationVoteClientSelection[ clientNum ], rotationVoteClientPosition[ clientNum ] );
+
+  trap_SendServerCommand( clientNum, va( "cp \"%s\"\n", string ) );
 }
 
 void G_IntermissionMapVoteCommand( gentity_t *ent, qboolean next, qboolean choose )
@@ -1264,7 +1578,20 @@ void G_IntermissionMapVoteCommand( gentity_t *ent, qboolean next, qboolean choos
 
   if( choose )
   {
-    rotationVoteClientSelection[ clientNum ] = rotationVoteClientPosition[ clientNum ];
+    n = rotationVoteClientPosition[ clientNum ];
+
+    if( n != rotationVoteClientSelection[ clientNum ] &&
+        n >= 0 && n < MAX_MAP_ROTATION_CONDS )
+    {
+      if( rotationVoteClientSelection[ clientNum ] >= 0 )
+        rotationVoteCounts[ rotationVoteClientSelection[ clientNum ] ]--;
+      else
+        rotationVoteTotal++;
+
+      rotationVoteCounts[ n ]++;
+      rotationVoteClientSelection[ clientNum ] = n;
+      G_RankMapVotes( );
+    }
   }
   else
   {
@@ -1306,7 +1633,7 @@ static qboolean G_GetRandomMap( char *name, int size, int rotation, int map )
     if( mrc->lhs == MCV_SELECTEDRANDOM )
     {
       //map doesnt exist
-      if( !G_MapExists( mrc->dest ) ) {
+      if( !mrc->destExists ) {
         continue;
       }
       maplist[ nummaps ] = i;
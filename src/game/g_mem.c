@@ -38,6 +38,14 @@ static char    memoryPool[POOLSIZE];
 static struct freememnode *freehead;
 static int    freemem;
 
+// strings that live for the whole level, such as entity keys from the map,
+// are packed end to end here instead of each taking a G_Alloc block
+#define  STRINGPOOLSIZE ( 256 * 1024 )
+
+static char     stringPool[STRINGPOOLSIZE];
+static int      stringPoolUsed;
+static qboolean stringPoolFull;
+
 void *G_Alloc( int size )
 {
   // Find a free block and allocate.
@@ -147,6 +155,27 @@ void G_Free( void *ptr )
   freehead = fmn;
 }
 
+void *G_StringAlloc( int size )
+{
+  // Strings can't be freed individually, the whole pool is
+  // released by G_InitMemory
+
+  char *ptr;
+
+  if( stringPoolUsed + size > STRINGPOOLSIZE )
+  {
+    if( !stringPoolFull )
+      G_Printf( S_COLOR_YELLOW "WARNING: G_StringAlloc: string pool is full, "
+        "using G_Alloc\n" );
+    stringPoolFull = qtrue;
+    return G_Alloc( size );
+  }
+
+  ptr = stringPool + stringPoolUsed;
+  stringPoolUsed += size;
+  return ptr;
+}
+
 void G_InitMemory( void )
 {
   // Set up the initial node
@@ -157,6 +186,9 @@ void G_InitMemory( void )
   freehead->next = NULL;
   freehead->prev = NULL;
   freemem = sizeof( memoryPool );
+
+  stringPoolUsed = 0;
+  stringPoolFull = qfalse;
 }
 
 void G_DefragmentMemory( void )
@@ -208,6 +240,7 @@ void Svcmd_GameMem_f( void )
   struct freememnode *fmn;
 
   G_Printf( "Game memory status: %i out of %i bytes allocated\n", POOLSIZE - freemem, POOLSIZE );
+  G_Printf( "String pool: %i out of %i bytes used\n", stringPoolUsed, STRINGPOOLSIZE );
 
   for( fmn = freehead; fmn; fmn = fmn->next )
     G_Printf( "  %dd: %d bytes free.\n", fmn, fmn->size );
@@ -206,7 +206,7 @@ void SP_misc_portal_surface( gentity_t *ent )
   else
   {
     ent->think = locateCamera;
-    ent->nextthink = level.time + 100;
+    G_SetNextThink( ent, level.time + 100 );
   }
 }
 
@@ -241,7 +241,7 @@ void SP_toggle_particle_system( gentity_t *self )
   //toggle EF_NODRAW
   self->s.eFlags ^= EF_NODRAW;
 
-  self->nextthink = 0;
+  G_SetNextThink( self, 0 );
 }
 
 /*
@@ -258,7 +258,7 @@ void SP_use_particle_system( gentity_t *self, gentity_t *other, gentity_t *activ
   if( self->wait > 0.0f )
   {
     self->think = SP_toggle_particle_system;
-    self->nextthink = level.time + (int)( self->wait * 1000 );
+    G_SetNextThink( self, level.time + (int)( self->wait * 1000 ) );
   }
 }
 
@@ -176,7 +176,7 @@ void G_MissileImpact( gentity_t *ent, trace_t *trace )
       ent->r.ownerNum = other->s.number;
 
       ent->think = AHive_ReturnToHive;
-      ent->nextthink = level.time + FRAMETIME;
+      G_SetNextThink( ent, level.time + FRAMETIME );
 
       //only damage humans
       if( other->client && other->client->ps.stats[ STAT_PTEAM ] == PTE_HUMANS )
@@ -311,7 +311,7 @@ gentity_t *fire_flamer( gentity_t *self, vec3_t start, vec3_t dir )
 
   bolt = G_Spawn();
   bolt->classname = "flame";
-  bolt->nextthink = level.time + FLAMER_LIFETIME;
+  G_SetNextThink( bolt, level.time + FLAMER_LIFETIME );
   bolt->think = G_ExplodeMissile;
   bolt->s.eType = ET_MISSILE;
   bolt->r.svFlags = SVF_USE_CURRENT_ORIGIN;
@@ -357,7 +357,7 @@ gentity_t *fire_blaster( gentity_t *self, vec3_t start, vec3_t dir )
 
   bolt = G_Spawn();
   bolt->classname = "blaster";
-  bolt->nextthink = level.time + 10000;
+  G_SetNextThink( bolt, level.time + 10000 );
   bolt->think = G_ExplodeMissile;
   bolt->s.eType = ET_MISSILE;
   bolt->r.svFlags = SVF_USE_CURRENT_ORIGIN;
@@ -400,7 +400,7 @@ gentity_t *fire_pulseRifle( gentity_t *self, vec3_t start, vec3_t dir )
 
   bolt = G_Spawn();
   bolt->classname = "pulse";
-  bolt->nextthink = level.time + 10000;
+  G_SetNextThink( bolt, level.time + 10000 );
   bolt->think = G_ExplodeMissile;
   bolt->s.eType = ET_MISSILE;
   bolt->r.svFlags = SVF_USE_CURRENT_ORIGIN;
@@ -447,9 +447,9 @@ gentity_t *fire_luciferCannon( gentity_t *self, vec3_t start, vec3_t dir, int da
   bolt->classname = "lcannon";
 
   if( damage == LCANNON_TOTAL_CHARGE )
-    bolt->nextthink = level.time;
+    G_SetNextThink( bolt, level.time );
   else
-    bolt->nextthink = level.time + 10000;
+    G_SetNextThink( bolt, level.time + 10000 );
 
   bolt->think = G_ExplodeMissile;
   bolt->s.eType = ET_MISSILE;
@@ -492,7 +492,7 @@ gentity_t *launch_grenade( gentity_t *self, vec3_t start, vec3_t dir )
 
   bolt = G_Spawn( );
   bolt->classname = "grenade";
-  bolt->nextthink = level.time + 5000;
+  G_SetNextThink( bolt, level.time + 5000 );
   bolt->think = G_ExplodeMissile;
   bolt->s.eType = ET_MISSILE;
   bolt->r.svFlags = SVF_USE_CURRENT_ORIGIN;
@@ -556,7 +556,7 @@ void AHive_ReturnToHive( gentity_t *self )
     self->s.pos.trTime = level.time;
 
     self->think = G_ExplodeMissile;
-    self->nextthink = level.time + 2000;
+    G_SetNextThink( self, level.time + 2000 );
     self->parent->active = qfalse; //allow the parent to start again
   }
   else
@@ -571,7 +571,7 @@ void AHive_ReturnToHive( gentity_t *self )
     self->s.pos.trTime = level.time;
 
     self->think = G_ExplodeMissile;
-    self->nextthink = level.time + 15000;
+    G_SetNextThink( self, level.time + 15000 );
   }
 }
 
@@ -598,7 +598,7 @@ void AHive_SearchAndDestroy( gentity_t *self )
     self->r.ownerNum = ENTITYNUM_WORLD;
 
     self->think = AHive_ReturnToHive;
-    self->nextthink = level.time + FRAMETIME;
+    G_SetNextThink( self, level.time + FRAMETIME );
   }
   else
   {
@@ -611,7 +611,7 @@ void AHive_SearchAndDestroy( gentity_t *self )
     VectorCopy( self->r.currentOrigin, self->s.pos.trBase );
     self->s.pos.trTime = level.time;
 
-    self->nextthink = level.time + HIVE_DIR_CHANGE_PERIOD;
+    G_SetNextThink( self, level.time + HIVE_DIR_CHANGE_PERIOD );
   }
 }
 
@@ -628,7 +628,7 @@ gentity_t *fire_hive( gentity_t *self, vec3_t start, vec3_t dir )
 
   bolt = G_Spawn( );
   bolt->classname = "hive";
-  bolt->nextthink = level.time + HIVE_DIR_CHANGE_PERIOD;
+  G_SetNextThink( bolt, level.time + HIVE_DIR_CHANGE_PERIOD );
   bolt->think = AHive_SearchAndDestroy;
   bolt->s.eType = ET_MISSILE;
   bolt->s.eFlags |= EF_BOUNCE|EF_NO_BOUNCE_SOUND;
@@ -669,7 +669,7 @@ gentity_t *fire_lockblob( gentity_t *self, vec3_t start, vec3_t dir )
 
   bolt = G_Spawn( );
   bolt->classname = "lockblob";
-  bolt->nextthink = level.time + 15000;
+  G_SetNextThink( bolt, level.time + 15000 );
   bolt->think = G_ExplodeMissile;
   bolt->s.eType = ET_MISSILE;
   bolt->r.svFlags = SVF_USE_CURRENT_ORIGIN;
@@ -707,7 +707,7 @@ gentity_t *fire_slowBlob( gentity_t *self, vec3_t start, vec3_t dir )
 
   bolt = G_Spawn( );
   bolt->classname = "slowblob";
-  bolt->nextthink = level.time + 15000;
+  G_SetNextThink( bolt, level.time + 15000 );
   bolt->think = G_ExplodeMissile;
   bolt->s.eType = ET_MISSILE;
   bolt->r.svFlags = SVF_USE_CURRENT_ORIGIN;
@@ -746,7 +746,7 @@ gentity_t *fire_paraLockBlob( gentity_t *self, vec3_t start, vec3_t dir )
 
   bolt = G_Spawn( );
   bolt->classname = "lockblob";
-  bolt->nextthink = level.time + 15000;
+  G_SetNextThink( bolt, level.time + 15000 );
   bolt->think = G_ExplodeMissile;
   bolt->s.eType = ET_MISSILE;
   bolt->r.svFlags = SVF_USE_CURRENT_ORIGIN;
@@ -783,7 +783,7 @@ gentity_t *fire_bounceBall( gentity_t *self, vec3_t start, vec3_t dir )
 
   bolt = G_Spawn( );
   bolt->classname = "bounceball";
-  bolt->nextthink = level.time + 3000;
+  G_SetNextThink( bolt, level.time + 3000 );
   bolt->think = G_ExplodeMissile;
   bolt->s.eType = ET_MISSILE;
   bolt->r.svFlags = SVF_USE_CURRENT_ORIGIN;
@@ -662,7 +662,7 @@ void Think_CloseModelDoor( gentity_t *ent )
     //set brush non-solid
     trap_UnlinkEntity( ent->clipBrush );
 
-    ent->nextthink = level.time + ent->wait;
+    G_SetNextThink( ent, level.time + ent->wait );
     return;
   }
 
@@ -676,7 +676,7 @@ void Think_CloseModelDoor( gentity_t *ent )
   ent->moverState = MODEL_2TO1;
 
   ent->think = Think_ClosedModelDoor;
-  ent->nextthink = level.time + ent->speed;
+  G_SetNextThink( ent, level.time + ent->speed );
 }
 
 
@@ -701,7 +701,7 @@ void Think_OpenModelDoor( gentity_t *ent )
 
   // return to pos1 after a delay
   ent->think = Think_CloseModelDoor;
-  ent->nextthink = level.time + ent->wait;
+  G_SetNextThink( ent, level.time + ent->wait );
 
   // fire targets
   if( !ent->activator )
@@ -732,7 +732,7 @@ void Reached_BinaryMover( gentity_t *ent )
 
     // return to pos1 after a delay
     ent->think = ReturnToPos1;
-    ent->nextthink = level.time + ent->wait;
+    G_SetNextThink( ent, level.time + ent->wait );
 
     // fire targets
     if( !ent->activator )
@@ -764,7 +764,7 @@ void Reached_BinaryMover( gentity_t *ent )
 
     // return to apos1 after a delay
     ent->think = ReturnToApos1;
-    ent->nextthink = level.time + ent->wait;
+    G_SetNextThink( ent, level.time + ent->wait );
 
     // fire targets
     if( !ent->activator )
@@ -833,7 +833,7 @@ void Use_BinaryMover( gentity_t *ent, gentity_t *other, gentity_t *activator )
   else if( ent->moverState == MOVER_POS2 )
   {
     // if all the way up, just delay before coming down
-    ent->nextthink = level.time + ent->wait;
+    G_SetNextThink( ent, level.time + ent->wait );
   }
   else if( ent->moverState == MOVER_2TO1 )
   {
@@ -883,7 +883,7 @@ void Use_BinaryMover( gentity_t *ent, gentity_t *other, gentity_t *activator )
   else if( ent->moverState == ROTATOR_POS2 )
   {
     // if all the way up, just delay before coming down
-    ent->nextthink = level.time + ent->wait;
+    G_SetNextThink( ent, level.time + ent->wait );
   }
   else if( ent->moverState == ROTATOR_2TO1 )
   {
@@ -919,7 +919,7 @@ void Use_BinaryMover( gentity_t *ent, gentity_t *other, gentity_t *activator )
     ent->s.legsAnim = qtrue;
 
     ent->think = Think_OpenModelDoor;
-    ent->nextthink = level.time + ent->speed;
+    G_SetNextThink( ent, level.time + ent->speed );
 
     // starting sound
     if( ent->sound1to2 )
@@ -937,7 +937,7 @@ void Use_BinaryMover( gentity_t *ent, gentity_t *other, gentity_t *activator )
   else if( ent->moverState == MODEL_POS2 )
   {
     // if all the way up, just delay before coming down
-    ent->nextthink = level.time + ent->wait;
+    G_SetNextThink( ent, level.time + ent->wait );
   }
 }
 
@@ -1460,7 +1460,7 @@ void SP_func_door( gentity_t *ent )
 
   InitMover( ent );
 
-  ent->nextthink = level.time + FRAMETIME;
+  G_SetNextThink( ent, level.time + FRAMETIME );
 
   if( !( ent->flags & FL_TEAMSLAVE ) )
   {
@@ -1578,7 +1578,7 @@ void SP_func_door_rotating( gentity_t *ent )
 
   InitRotator( ent );
 
-  ent->nextthink = level.time + FRAMETIME;
+  G_SetNextThink( ent, level.time + FRAMETIME );
 
   if( !( ent->flags & FL_TEAMSLAVE ) )
   {
@@ -1733,7 +1733,7 @@ void SP_func_door_model( gentity_t *ent )
 
     if( !( ent->targetname || health ) )
     {
-      ent->nextthink = level.time + FRAMETIME;
+      G_SetNextThink( ent, level.time + FRAMETIME );
       ent->think = Think_SpawnNewDoorTrigger;
     }
   }
@@ -1765,7 +1765,7 @@ void Touch_Plat( gentity_t *ent, gentity_t *other, trace_t *trace )
 
   // delay return-to-pos1 by one second
   if( ent->moverState == MOVER_POS2 )
-    ent->nextthink = level.time + 1000;
+    G_SetNextThink( ent, level.time + 1000 );
 }
 
 /*
@@ -2071,7 +2071,7 @@ void Reached_Train( gentity_t *ent )
   // if there is a "wait" value on the target, don't start moving yet
   if( next->wait )
   {
-    ent->nextthink = level.time + next->wait * 1000;
+    G_SetNextThink( ent, level.time + next->wait * 1000 );
     ent->think = Think_BeginMoving;
     ent->s.pos.trType = TR_STATIONARY;
   }
@@ -2297,7 +2297,7 @@ void SP_func_train( gentity_t *self )
 
   // start trains on the second frame, to make sure their targets have had
   // a chance to spawn
-  self->nextthink = level.time + FRAMETIME;
+  G_SetNextThink( self, level.time + FRAMETIME );
   self->think = Think_SetupTrainTargets;
 }
 
@@ -107,6 +107,42 @@ connectionRecord_t *G_GenerateNewConnection( gclient_t *client )
   return NULL;
 }
 
+/*
+===============
+G_RestorePTRConnection
+
+Give a client carried over from the last level back the PTR code it had,
+so it doesn't need a new one. What was saved against the code belonged to
+the last level, so the record starts out empty
+===============
+*/
+connectionRecord_t *G_RestorePTRConnection( gclient_t *client, int code )
+{
+  int     i;
+
+  if( !G_CheckForUniquePTRC( code ) )
+    return NULL;
+
+  for( i = 0; i < MAX_CLIENTS; i++ )
+  {
+    //found an unused slot
+    if( !connections[ i ].ptrCode )
+    {
+      connections[ i ].ptrCode = code;
+      connections[ i ].clientNum = client - level.clients;
+      connections[ i ].clientTeam = PTE_NONE;
+      connections[ i ].clientCredit = 0;
+      connections[ i ].clientScore = 0;
+      connections[ i ].clientEnterTime = 0;
+      client->pers.connection = &connections[ i ];
+
+      return &connections[ i ];
+    }
+  }
+
+  return NULL;
+}
+
 /*
 ===============
 G_FindConnectionForCode
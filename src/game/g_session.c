@@ -31,9 +31,39 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 Session data is the only data that stays persistant across level loads
 and tournament restarts.
+
+Every slot's session is kept in sessions[], which G_WriteSessionData()
+fills in as the level ends and G_SaveSessionData() writes to a single
+binary file on shutdown. G_LoadSessionData() reads that file back when the
+next level starts, before any clients reconnect.
 =======================================================================
 */
 
+#define SESSION_FILE    "session.dat"
+#define SESSION_IDENT   ( ( 'S' << 24 ) + ( 'E' << 16 ) + ( 'S' << 8 ) + 'T' )
+#define SESSION_VERSION 1
+
+typedef struct sessionRecord_s
+{
+  qboolean        inUse;
+  clientSession_t sess;
+
+  int             ptrCode;      // 0 if the client had no PTR connection
+  qboolean        muted;
+  int             muteTime;     // msec of the mute left, 0 for none
+  qboolean        denyBuild;
+} sessionRecord_t;
+
+typedef struct sessionHeader_s
+{
+  int ident;
+  int version;
+  int recordSize;
+  int numRecords;
+} sessionHeader_t;
+
+static sessionRecord_t sessions[ MAX_CLIENTS ];
+
 /*
 ================
 G_WriteClientSessionData
@@ -43,70 +73,43 @@ Called on game shutdown
 */
 void G_WriteClientSessionData( gclient_t *client )
 {
-  const char  *s;
-  const char  *var;
-
-  s = va( "%i %i %i %i %i %i %i %i %i %s",
-    client->sess.sessionTeam,
-    client->sess.restartTeam,
-    client->sess.spectatorTime,
-    client->sess.spectatorState,
-    client->sess.spectatorClient,
-    client->sess.wins,
-    client->sess.losses,
-    client->sess.teamLeader,
-    client->sess.invisible,
-    BG_ClientListString( &client->sess.ignoreList )
-    );
-
-  var = va( "session%i", (int)(client - level.clients) );
-
-  trap_Cvar_Set( var, s );
+  sessionRecord_t *record = &sessions[ client - level.clients ];
+
+  record->inUse = qtrue;
+  record->sess = client->sess;
+  record->ptrCode = client->pers.connection ? client->pers.connection->ptrCode : 0;
+  record->muted = client->pers.muted;
+  record->muteTime = client->pers.muteExpires ?
+    MAX( client->pers.muteExpires - level.time, 1 ) : 0;
+  record->denyBuild = client->pers.denyBuild;
 }
 
 /*
 ================
 G_ReadSessionData
 
-Called on a reconnect
+Called on a reconnect, returns qfalse if there is no session for the
+client's slot
 ================
 */
-void G_ReadSessionData( gclient_t *client )
+qboolean G_ReadSessionData( gclient_t *client )
 {
-  char  s[ MAX_STRING_CHARS ];
-  const char  *var;
-
-  // bk001205 - format
-  int teamLeader;
-  int spectatorState;
-  int sessionTeam;
-  int restartTeam;
-  int invisible;
-
-  var = va( "session%i", (int)(client - level.clients) );
-  trap_Cvar_VariableStringBuffer( var, s, sizeof(s) );
-
-  // FIXME: should be using BG_ClientListParse() for ignoreList, but
-  //        bg_lib.c's sscanf() currently lacks %s
-  sscanf( s, "%i %i %i %i %i %i %i %i %i %x%x",
-    &sessionTeam,
-    &restartTeam,
-    &client->sess.spectatorTime,
-    &spectatorState,
-    &client->sess.spectatorClient,
-    &client->sess.wins,
-    &client->sess.losses,
-    &teamLeader,
-    &invisible,
-    &client->sess.ignoreList.hi,
-    &client->sess.ignoreList.lo
-    );
-  // bk001205 - format issues
-  client->sess.sessionTeam = (team_t)sessionTeam;
-  client->sess.restartTeam = (pTeam_t)restartTeam;
-  client->sess.spectatorState = (spectatorState_t)spectatorState;
-  client->sess.teamLeader = (qboolean)teamLeader;
-  client->sess.invisible = (qboolean)invisible;
+  sessionRecord_t *record = &sessions[ client - level.clients ];
+
+  if( !record->inUse )
+    return qfalse;
+
+  client->sess = record->sess;
+
+  if( record->ptrCode )
+    G_RestorePTRConnection( client, record->ptrCode );
+
+  client->pers.muted = record->muted;
+  if( record->muteTime )
+    client->pers.muteExpires = level.time + record->muteTime;
+  client->pers.denyBuild = record->denyBuild;
+
+  return qtrue;
 }
 
 
@@ -160,12 +163,71 @@ void G_WriteSessionData( void )
 {
   int    i;
 
-  //TA: ?
-  trap_Cvar_Set( "session", va( "%i", 0 ) );
-
   for( i = 0 ; i < level.maxclients ; i++ )
   {
     if( level.clients[ i ].pers.connected == CON_CONNECTED )
       G_WriteClientSessionData( &level.clients[ i ] );
   }
 }
+
+/*
+==================
+G_SaveSessionData
+
+Write every slot's session to SESSION_FILE in one go
+==================
+*/
+void G_SaveSessionData( void )
+{
+  fileHandle_t    f;
+  sessionHeader_t header;
+
+  trap_FS_FOpenFile( SESSION_FILE, &f, FS_WRITE );
+  if( !f )
+  {
+    G_Printf( S_COLOR_YELLOW "WARNING: couldn't write " SESSION_FILE "\n" );
+    return;
+  }
+
+  header.ident = SESSION_IDENT;
+  header.version = SESSION_VERSION;
+  header.recordSize = sizeof( sessionRecord_t );
+  header.numRecords = MAX_CLIENTS;
+
+  trap_FS_Write( &header, sizeof( header ), f );
+  trap_FS_Write( sessions, sizeof( sessions ), f );
+  trap_FS_FCloseFile( f );
+}
+
+/*
+==================
+G_LoadSessionData
+
+Read back the sessions saved by the last level. A missing or mismatched
+file just means reconnecting clients are treated as new sessions
+==================
+*/
+void G_LoadSessionData( void )
+{
+  fileHandle_t    f;
+  sessionHeader_t header;
+  int             len;
+
+  memset( sessions, 0, sizeof( sessions ) );
+
+  len = trap_FS_FOpenFile( SESSION_FILE, &f, FS_READ );
+  if( !f )
+    return;
+
+  if( len == sizeof( header ) + sizeof( sessions ) )
+  {
+    trap_FS_Read( &header, sizeof( header ), f );
+
+    if( header.ident == SESSION_IDENT && header.version == SESSION_VERSION &&
+        header.recordSize == sizeof( sessionRecord_t ) &&
+        header.numRecords == MAX_CLIENTS )
+      trap_FS_Read( sessions, sizeof( sessions ), f );
+  }
+
+  trap_FS_FCloseFile( f );
+}
@@ -305,6 +305,162 @@ spawn_t spawns[ ] =
   { NULL, 0 }
 };
 
+// classnames and field keys are looked up through open addressed hash tables
+// built from spawns[], the buildable list and fields[] before the map's
+// entities are parsed
+#define SPAWN_HASH_SIZE   256   // must be a power of two
+#define FIELD_HASH_SIZE   128
+
+typedef struct
+{
+  const char  *name;
+  buildable_t buildable;    // BA_NONE for an entry in spawns[]
+  spawn_t     *spawn;
+} spawnName_t;
+
+static spawnName_t  spawnHash[ SPAWN_HASH_SIZE ];
+static field_t      *fieldHash[ FIELD_HASH_SIZE ];
+
+/*
+===============
+G_SpawnHashValue
+
+Case insensitive, so the same chain is searched however a classname or key
+is capitalised
+===============
+*/
+static unsigned int G_SpawnHashValue( const char *name )
+{
+  unsigned int hash = 0x811c9dc5u;
+
+  for( ; *name; name++ )
+  {
+    hash ^= (byte)tolower( *name );
+    hash *= 0x01000193u;
+  }
+
+  return hash;
+}
+
+/*
+===============
+G_AddSpawnName
+===============
+*/
+static void G_AddSpawnName( const char *name, buildable_t buildable, spawn_t *spawn )
+{
+  unsigned int i = G_SpawnHashValue( name );
+  int          n;
+
+  for( n = 0; n < SPAWN_HASH_SIZE; n++, i++ )
+  {
+    if( !spawnHash[ i & ( SPAWN_HASH_SIZE - 1 ) ].name )
+    {
+      spawnHash[ i & ( SPAWN_HASH_SIZE - 1 ) ].name = name;
+      spawnHash[ i & ( SPAWN_HASH_SIZE - 1 ) ].buildable = buildable;
+      spawnHash[ i & ( SPAWN_HASH_SIZE - 1 ) ].spawn = spawn;
+      return;
+    }
+  }
+
+  G_Error( "G_AddSpawnName: SPAWN_HASH_SIZE is too small" );
+}
+
+/*
+===============
+G_InitSpawnHash
+
+Buildables go in first, so they win over spawns[] as they did when the two
+were searched in turn
+===============
+*/
+static void G_InitSpawnHash( void )
+{
+  spawn_t       *s;
+  field_t       *f;
+  unsigned int  j;
+  int           i, n;
+
+  memset( spawnHash, 0, sizeof( spawnHash ) );
+  memset( fieldHash, 0, sizeof( fieldHash ) );
+
+  for( i = BA_NONE + 1; i < BA_NUM_BUILDABLES; i++ )
+    G_AddSpawnName( BG_FindEntityNameForBuildable( i ), i, NULL );
+
+  for( s = spawns; s->name; s++ )
+    G_AddSpawnName( s->name, BA_NONE, s );
+
+  for( f = fields; f->name; f++ )
+  {
+    j = G_SpawnHashValue( f->name );
+
+    for( n = 0; n < FIELD_HASH_SIZE; n++, j++ )
+    {
+      if( !fieldHash[ j & ( FIELD_HASH_SIZE - 1 ) ] )
+      {
+        fieldHash[ j & ( FIELD_HASH_SIZE - 1 ) ] = f;
+        break;
+      }
+    }
+
+    if( n == FIELD_HASH_SIZE )
+      G_Error( "G_InitSpawnHash: FIELD_HASH_SIZE is too small" );
+  }
+}
+
+/*
+===============
+G_FindSpawnName
+
+Buildable entity names match regardless of case, spawns[] names exactly
+===============
+*/
+static spawnName_t *G_FindSpawnName( const char *name )
+{
+  unsigned int  i = G_SpawnHashValue( name );
+  spawnName_t   *sn;
+  int           n;
+
+  for( n = 0; n < SPAWN_HASH_SIZE; n++, i++ )
+  {
+    sn = &spawnHash[ i & ( SPAWN_HASH_SIZE - 1 ) ];
+
+    if( !sn->name )
+      break;
+
+    if( sn->buildable != BA_NONE ? !Q_stricmp( sn->name, name ) :
+                                   !strcmp( sn->name, name ) )
+      return sn;
+  }
+
+  return NULL;
+}
+
+/*
+===============
+G_FindField
+===============
+*/
+static field_t *G_FindField( const char *key )
+{
+  unsigned int  i = G_SpawnHashValue( key );
+  field_t       *f;
+  int           n;
+
+  for( n = 0; n < FIELD_HASH_SIZE; n++, i++ )
+  {
+    f = fieldHash[ i & ( FIELD_HASH_SIZE - 1 ) ];
+
+    if( !f )
+      break;
+
+    if( !Q_stricmp( f->name, key ) )
+      return f;
+  }
+
+  return NULL;
+}
+
 /*
 ===============
 G_CallSpawn
@@ -315,7 +471,7 @@ returning qfalse if not found
 */
 qboolean G_CallSpawn( gentity_t *ent )
 {
-  spawn_t     *s;
+  spawnName_t *sn;
   buildable_t buildable;
 
   if( !ent->classname )
@@ -324,8 +480,14 @@ qboolean G_CallSpawn( gentity_t *ent )
     return qfalse;
   }
 
+  if( !( sn = G_FindSpawnName( ent->classname ) ) )
+  {
+    G_Printf( "%s doesn't have a spawn function\n", ent->classname );
+    return qfalse;
+  }
+
   //check buildable spawn functions
-  if( ( buildable = BG_FindBuildNumForEntityName( ent->classname ) ) != BA_NONE )
+  if( ( buildable = sn->buildable ) != BA_NONE )
   {
     // don't spawn built-in buildings if we are using a custom layout
     if( level.layout[ 0 ] && Q_stricmp( level.layout, "*BUILTIN*" ) )
@@ -341,19 +503,9 @@ qboolean G_CallSpawn( gentity_t *ent )
     return qtrue;
   }
 
-  // check normal spawn functions
-  for( s = spawns; s->name; s++ )
-  {
-    if( !strcmp( s->name, ent->classname ) )
-    {
-      // found it
-      s->spawn( ent );
-      return qtrue;
-    }
-  }
-
-  G_Printf( "%s doesn't have a spawn function\n", ent->classname );
-  return qfalse;
+  // normal spawn function
+  sn->spawn->spawn( ent );
+  return qtrue;
 }
 
 /*
@@ -371,7 +523,7 @@ char *G_NewString( const char *string )
 
   l = strlen( string ) + 1;
 
-  newb = G_Alloc( l );
+  newb = G_StringAlloc( l );
 
   new_p = newb;
 
@@ -412,58 +564,52 @@ void G_ParseField( const char *key, const char *value, gentity_t *ent )
   vec3_t  vec;
   vec4_t  vec4;
 
-  for( f = fields; f->name; f++ )
+  if( !( f = G_FindField( key ) ) )
+    return;
+
+  b = (byte *)ent;
+
+  switch( f->type )
   {
-    if( !Q_stricmp( f->name, key ) )
-    {
-      // found it
-      b = (byte *)ent;
+    case F_LSTRING:
+      *(char **)( b + f->ofs ) = G_NewString( value );
+      break;
 
-      switch( f->type )
-      {
-        case F_LSTRING:
-          *(char **)( b + f->ofs ) = G_NewString( value );
-          break;
-
-        case F_VECTOR:
-          sscanf( value, "%f %f %f", &vec[ 0 ], &vec[ 1 ], &vec[ 2 ] );
-
-          ( (float *)( b + f->ofs ) )[ 0 ] = vec[ 0 ];
-          ( (float *)( b + f->ofs ) )[ 1 ] = vec[ 1 ];
-          ( (float *)( b + f->ofs ) )[ 2 ] = vec[ 2 ];
-          break;
-
-        case F_VECTOR4:
-          sscanf( value, "%f %f %f %f", &vec4[ 0 ], &vec4[ 1 ], &vec4[ 2 ], &vec4[ 3 ] );
-
-          ( (float *)( b + f->ofs ) )[ 0 ] = vec4[ 0 ];
-          ( (float *)( b + f->ofs ) )[ 1 ] = vec4[ 1 ];
-          ( (float *)( b + f->ofs ) )[ 2 ] = vec4[ 2 ];
-          ( (float *)( b + f->ofs ) )[ 3 ] = vec4[ 3 ];
-          break;
-
-        case F_INT:
-          *(int *)( b + f->ofs ) = atoi( value );
-          break;
-
-        case F_FLOAT:
-          *(float *)( b + f->ofs ) = atof( value );
-          break;
-
-        case F_ANGLEHACK:
-          v = atof( value );
-          ( (float *)( b + f->ofs ) )[ 0 ] = 0;
-          ( (float *)( b + f->ofs ) )[ 1 ] = v;
-          ( (float *)( b + f->ofs ) )[ 2 ] = 0;
-          break;
-
-        default:
-        case F_IGNORE:
-          break;
-      }
+    case F_VECTOR:
+      sscanf( value, "%f %f %f", &vec[ 0 ], &vec[ 1 ], &vec[ 2 ] );
 
-      return;
-    }
+      ( (float *)( b + f->ofs ) )[ 0 ] = vec[ 0 ];
+      ( (float *)( b + f->ofs ) )[ 1 ] = vec[ 1 ];
+      ( (float *)( b + f->ofs ) )[ 2 ] = vec[ 2 ];
+      break;
+
+    case F_VECTOR4:
+      sscanf( value, "%f %f %f %f", &vec4[ 0 ], &vec4[ 1 ], &vec4[ 2 ], &vec4[ 3 ] );
+
+      ( (float *)( b + f->ofs ) )[ 0 ] = vec4[ 0 ];
+      ( (float *)( b + f->ofs ) )[ 1 ] = vec4[ 1 ];
+      ( (float *)( b + f->ofs ) )[ 2 ] = vec4[ 2 ];
+      ( (float *)( b + f->ofs ) )[ 3 ] = vec4[ 3 ];
+      break;
+
+    case F_INT:
+      *(int *)( b + f->ofs ) = atoi( value );
+      break;
+
+    case F_FLOAT:
+      *(float *)( b + f->ofs ) = atof( value );
+      break;
+
+    case F_ANGLEHACK:
+      v = atof( value );
+      ( (float *)( b + f->ofs ) )[ 0 ] = 0;
+      ( (float *)( b + f->ofs ) )[ 1 ] = v;
+      ( (float *)( b + f->ofs ) )[ 2 ] = 0;
+      break;
+
+    default:
+    case F_IGNORE:
+      break;
   }
 }
 
@@ -681,6 +827,8 @@ void G_SpawnEntitiesFromString( void )
   level.spawning = qtrue;
   level.numSpawnVars = 0;
 
+  G_InitSpawnHash( );
+
   // the worldspawn is not an actual entity, but it still
   // has a "spawn" function to perform any global setup
   // needed by a level (setting configstrings or cvars, etc)
@@ -475,6 +475,33 @@ void  Svcmd_ForceTeam_f( void )
   //FIXME: tremulise this
 }
 
+/*
+===================
+Svcmd_LayoutName
+
+Strip anything from a layout name that shouldn't be in a file name
+===================
+*/
+static qboolean Svcmd_LayoutName( const char *name, char *out, int len )
+{
+  int i = 0;
+
+  out[ 0 ] = '\0';
+  while( *name && i < len - 1 )
+  {
+    if( ( *name >= '0' && *name <= '9' ) ||
+      ( *name >= 'a' && *name <= 'z' ) ||
+      ( *name >= 'A' && *name <= 'Z' ) || *name == '-' || *name == '_' )
+    {
+      out[ i++ ] = *name;
+      out[ i ] = '\0';
+    }
+    name++;
+  }
+
+  return out[ 0 ] != '\0';
+}
+
 /*
 ===================
 Svcmd_LayoutSave_f
@@ -486,8 +513,6 @@ void  Svcmd_LayoutSave_f( void )
 {
   char str[ MAX_QPATH ];
   char str2[ MAX_QPATH - 4 ];
-  char *s;
-  int i = 0;
 
   if( trap_Argc( ) != 2 )
   {
@@ -496,27 +521,71 @@ void  Svcmd_LayoutSave_f( void )
   }
   trap_Argv( 1, str, sizeof( str ) );
 
-  // sanitize name
-  s = &str[ 0 ];
-  while( *s && i < sizeof( str2 ) - 1 )
+  if( !Svcmd_LayoutName( str, str2, sizeof( str2 ) ) )
   {
-    if( ( *s >= '0' && *s <= '9' ) ||
-      ( *s >= 'a' && *s <= 'z' ) ||
-      ( *s >= 'A' && *s <= 'Z' ) || *s == '-' || *s == '_' )
-    {
-      str2[ i++ ] = *s;
-      str2[ i ] = '\0';
-    }
-    s++;
+    G_Printf("layoutsave: invalid name \"%s\"\n", str );
+    return;
   }
 
-  if( !str2[ 0 ] )
+  G_LayoutSave( str2 );
+}
+
+/*
+===================
+Svcmd_Layout_f
+
+layout info <name> [<map>]
+layout convert <name> <newname> <binary|text> [<map>]
+===================
+*/
+static void Svcmd_Layout_f( void )
+{
+  char cmd[ MAX_TOKEN_CHARS ];
+  char map[ MAX_QPATH ];
+  char name[ MAX_QPATH ];
+  char newName[ MAX_QPATH ];
+  char safeName[ MAX_QPATH - 4 ];
+  char format[ 16 ];
+  int  argc = trap_Argc( );
+
+  trap_Argv( 1, cmd, sizeof( cmd ) );
+  trap_Argv( 2, name, sizeof( name ) );
+  trap_Cvar_VariableStringBuffer( "mapname", map, sizeof( map ) );
+
+  if( !Q_stricmp( cmd, "info" ) && ( argc == 3 || argc == 4 ) )
   {
-    G_Printf("layoutsave: invalid name \"%s\"\n", str );
+    if( argc == 4 )
+      trap_Argv( 3, map, sizeof( map ) );
+
+    G_LayoutInfo( map, name );
     return;
   }
 
-  G_LayoutSave( str2 );
+  if( !Q_stricmp( cmd, "convert" ) && ( argc == 5 || argc == 6 ) )
+  {
+    trap_Argv( 3, newName, sizeof( newName ) );
+    trap_Argv( 4, format, sizeof( format ) );
+    if( argc == 6 )
+      trap_Argv( 5, map, sizeof( map ) );
+
+    if( Q_stricmp( format, "binary" ) && Q_stricmp( format, "text" ) )
+    {
+      G_Printf( "layout: format must be binary or text\n" );
+      return;
+    }
+
+    if( !Svcmd_LayoutName( newName, safeName, sizeof( safeName ) ) )
+    {
+      G_Printf( "layout: invalid name \"%s\"\n", newName );
+      return;
+    }
+
+    G_LayoutConvert( map, name, safeName, !Q_stricmp( format, "text" ) );
+    return;
+  }
+
+  G_Printf( "usage: layout info <name> [<map>]\n"
+            "       layout convert <name> <newname> <binary|text> [<map>]\n" );
 }
 
 char  *ConcatArgs( int start );
@@ -588,6 +657,9 @@ qboolean  ConsoleCommand( void )
 
   trap_Argv( 0, cmd, sizeof( cmd ) );
 
+  // whatever this is, the console may have been setting cvars
+  G_RequestCvarUpdate( );
+
   if( Q_stricmp( cmd, "entitylist" ) == 0 )
   {
     Svcmd_EntityList_f( );
@@ -648,6 +720,13 @@ qboolean  ConsoleCommand( void )
     return qtrue;
   }
 
+  if( Q_stricmp( cmd, "checkMapRotation" ) == 0 )
+  {
+    G_ValidateMapRotations( ConcatArgs( 1 ) );
+
+    return qtrue;
+  }
+
   if( Q_stricmp( cmd, "alienWin" ) == 0 )
   {
     int       i;
@@ -687,6 +766,12 @@ qboolean  ConsoleCommand( void )
     Svcmd_LayoutLoad_f( );
     return qtrue;
   }
+
+  if( !Q_stricmp( cmd, "layout" ) )
+  {
+    Svcmd_Layout_f( );
+    return qtrue;
+  }
   
   if( !Q_stricmp( cmd, "admitdefeat" ) )
   {
@@ -694,6 +779,34 @@ qboolean  ConsoleCommand( void )
     return qtrue;
   }
 
+  if( !Q_stricmp( cmd, "unlaggedbench" ) )
+  {
+    char shots[ 16 ];
+
+    trap_Argv( 1, shots, sizeof( shots ) );
+    G_UnlaggedBenchmark( atoi( shots ) );
+    return qtrue;
+  }
+
+  if( !Q_stricmp( cmd, "thinkbench" ) )
+  {
+    char count[ 16 ], frames[ 16 ];
+
+    trap_Argv( 1, count, sizeof( count ) );
+    trap_Argv( 2, frames, sizeof( frames ) );
+    G_ThinkBenchmark( atoi( count ), atoi( frames ) );
+    return qtrue;
+  }
+
+  if( !Q_stricmp( cmd, "placementstats" ) )
+  {
+    char reset[ 16 ];
+
+    trap_Argv( 1, reset, sizeof( reset ) );
+    G_PlacementStats( !Q_stricmp( reset, "reset" ) );
+    return qtrue;
+  }
+
   if( !Q_stricmp( cmd, "evacuation" ) )
   {
     trap_SendServerCommand( -1, "print \"Evacuation ordered\n\"" );
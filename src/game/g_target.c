@@ -36,7 +36,7 @@ void Think_Target_Delay( gentity_t *ent )
 
 void Use_Target_Delay( gentity_t *ent, gentity_t *other, gentity_t *activator )
 {
-  ent->nextthink = level.time + ( ent->wait + ent->random * crandom( ) ) * 1000;
+  G_SetNextThink( ent, level.time + ( ent->wait + ent->random * crandom( ) ) * 1000 );
   ent->think = Think_Target_Delay;
   ent->activator = activator;
 }
@@ -328,7 +328,7 @@ in site, closest in distance
 void SP_target_location( gentity_t *self )
 {
   self->think = target_location_linkup;
-  self->nextthink = level.time + 200;  // Let them all spawn first
+  G_SetNextThink( self, level.time + 200 );  // Let them all spawn first
 
   G_SetOrigin( self, self->s.origin );
 }
@@ -365,7 +365,7 @@ void target_rumble_think( gentity_t *self )
   }
 
   if( level.time < self->timestamp )
-    self->nextthink = level.time + FRAMETIME;
+    G_SetNextThink( self, level.time + FRAMETIME );
 }
 
 /*
@@ -376,7 +376,7 @@ target_rumble_use
 void target_rumble_use( gentity_t *self, gentity_t *other, gentity_t *activator )
 {
   self->timestamp = level.time + ( self->count * FRAMETIME );
-  self->nextthink = level.time + FRAMETIME;
+  G_SetNextThink( self, level.time + FRAMETIME );
   self->activator = activator;
   self->last_move_time = 0;
 }
@@ -0,0 +1,475 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+Copyright (C) 2000-2006 Tim Angus
+
+This file is part of Tremulous.
+
+Tremulous is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Tremulous is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Tremulous; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// g_think.c -- keeps idle entities out of G_RunFrame until they're due
+
+#include "g_local.h"
+
+// Every entity starts out awake and is visited by G_RunFrame in entity
+// order, exactly as before. An entity that only ends up in G_RunThink, with
+// no event pending and nothing else to do per frame, is parked after its
+// visit: it drops out of the awake set and, if it has a nextthink, goes on
+// a heap keyed by that time. It is woken when the time comes round, when
+// G_SetNextThink or G_AddEvent touch it, or when the slot is reused. Woken
+// entities are visited in entity order along with the rest, so the order
+// things think in doesn't change.
+//
+// Heap entries aren't removed when an entity wakes early; they're dropped
+// when they come off the heap if the entity was parked again since.
+
+typedef struct thinkHeapEntry_s
+{
+  int time;
+  int num;
+} thinkHeapEntry_t;
+
+#define THINK_HEAP_SIZE   ( MAX_GENTITIES * 2 )
+#define THINK_WORDS       ( MAX_GENTITIES / 32 )
+
+typedef struct thinkScheduler_s
+{
+  unsigned int      awake[ THINK_WORDS ];
+  qboolean          parked[ MAX_GENTITIES ];
+  int               parkedTime[ MAX_GENTITIES ];  // nextthink when parked
+
+  thinkHeapEntry_t  heap[ THINK_HEAP_SIZE ];
+  int               heapSize;
+} thinkScheduler_t;
+
+static thinkScheduler_t thinkScheduler;
+
+/*
+===============
+G_ThinkHeapPush
+===============
+*/
+static void G_ThinkHeapPush( thinkScheduler_t *ts, int time, int num )
+{
+  thinkHeapEntry_t  e;
+  int               i, parent;
+
+  e.time = time;
+  e.num = num;
+
+  for( i = ts->heapSize++; i > 0; i = parent )
+  {
+    parent = ( i - 1 ) / 2;
+    if( ts->heap[ parent ].time <= time )
+      break;
+
+    ts->heap[ i ] = ts->heap[ parent ];
+  }
+
+  ts->heap[ i ] = e;
+}
+
+/*
+===============
+G_ThinkHeapPop
+===============
+*/
+static thinkHeapEntry_t G_ThinkHeapPop( thinkScheduler_t *ts )
+{
+  thinkHeapEntry_t  top = ts->heap[ 0 ];
+  thinkHeapEntry_t  last = ts->heap[ --ts->heapSize ];
+  int               i, child;
+
+  for( i = 0; ( child = 2 * i + 1 ) < ts->heapSize; i = child )
+  {
+    if( child + 1 < ts->heapSize &&
+        ts->heap[ child + 1 ].time < ts->heap[ child ].time )
+      child++;
+
+    if( last.time <= ts->heap[ child ].time )
+      break;
+
+    ts->heap[ i ] = ts->heap[ child ];
+  }
+
+  ts->heap[ i ] = last;
+
+  return top;
+}
+
+/*
+===============
+G_ThinkInit
+===============
+*/
+static void G_ThinkInit( thinkScheduler_t *ts )
+{
+  memset( ts->awake, 0xff, sizeof( ts->awake ) );
+  memset( ts->parked, 0, sizeof( ts->parked ) );
+  ts->heapSize = 0;
+}
+
+/*
+===============
+G_ThinkWake
+===============
+*/
+static void G_ThinkWake( thinkScheduler_t *ts, int num )
+{
+  if( !ts->parked[ num ] )
+    return;
+
+  ts->parked[ num ] = qfalse;
+  ts->awake[ num >> 5 ] |= ( 1 << ( num & 31 ) );
+}
+
+/*
+===============
+G_ThinkPark
+
+A time of 0 or less parks an entity until something wakes it
+===============
+*/
+static void G_ThinkPark( thinkScheduler_t *ts, int num, int time )
+{
+  int i;
+
+  ts->parked[ num ] = qtrue;
+  ts->parkedTime[ num ] = time;
+  ts->awake[ num >> 5 ] &= ~( 1 << ( num & 31 ) );
+
+  if( time <= 0 )
+    return;
+
+  // too many stale entries, start again from the parked entities
+  if( ts->heapSize == THINK_HEAP_SIZE )
+  {
+    ts->heapSize = 0;
+    for( i = 0; i < MAX_GENTITIES; i++ )
+    {
+      if( ts->parked[ i ] && ts->parkedTime[ i ] > 0 )
+        G_ThinkHeapPush( ts, ts->parkedTime[ i ], i );
+    }
+  }
+  else
+    G_ThinkHeapPush( ts, time, num );
+}
+
+/*
+===============
+G_ThinkWakeDue
+
+Wake everything parked with a time at or before time
+===============
+*/
+static void G_ThinkWakeDue( thinkScheduler_t *ts, int time )
+{
+  thinkHeapEntry_t e;
+
+  while( ts->heapSize > 0 && ts->heap[ 0 ].time <= time )
+  {
+    e = G_ThinkHeapPop( ts );
+
+    if( ts->parked[ e.num ] && ts->parkedTime[ e.num ] == e.time )
+      G_ThinkWake( ts, e.num );
+  }
+}
+
+/*
+===============
+G_ThinkNextAwake
+===============
+*/
+static int G_ThinkNextAwake( thinkScheduler_t *ts, int num )
+{
+  unsigned int bits;
+
+  while( num < MAX_GENTITIES )
+  {
+    bits = ts->awake[ num >> 5 ] >> ( num & 31 );
+
+    if( !bits )
+    {
+      num = ( num | 31 ) + 1;
+      continue;
+    }
+
+    while( !( bits & 1 ) )
+    {
+      bits >>= 1;
+      num++;
+    }
+
+    return num;
+  }
+
+  return MAX_GENTITIES;
+}
+
+/*
+===============
+G_InitThinkScheduler
+===============
+*/
+void G_InitThinkScheduler( void )
+{
+  G_ThinkInit( &thinkScheduler );
+}
+
+/*
+===============
+G_SetNextThink
+
+Set when ent next thinks. All changes to nextthink go through here so that
+a parked entity can't miss one
+===============
+*/
+void G_SetNextThink( gentity_t *ent, int time )
+{
+  ent->nextthink = time;
+  G_ThinkWake( &thinkScheduler, ent - g_entities );
+}
+
+/*
+===============
+G_WakeEntity
+===============
+*/
+void G_WakeEntity( gentity_t *ent )
+{
+  G_ThinkWake( &thinkScheduler, ent - g_entities );
+}
+
+/*
+===============
+G_ParkEntity
+
+Called by G_RunFrame once it has finished with an entity that only thinks.
+Unless there is still something for G_RunFrame to do with it every frame,
+it is left alone until its nextthink comes round or something wakes it
+===============
+*/
+void G_ParkEntity( gentity_t *ent )
+{
+  if( !ent->inuse || ent->s.number < MAX_CLIENTS )
+    return;
+
+  if( ent->s.event || ent->freeAfterEvent || ent->unlinkAfterEvent ||
+      ent->evaluateAcceleration || ent->physicsObject )
+    return;
+
+  if( ent->s.eType == ET_MISSILE || ent->s.eType == ET_BUILDABLE ||
+      ent->s.eType == ET_CORPSE || ent->s.eType == ET_MOVER )
+    return;
+
+  // due this frame or next, no point parking it
+  if( ent->nextthink > 0 && ent->nextthink <= level.time )
+    return;
+
+  G_ThinkPark( &thinkScheduler, ent->s.number, ent->nextthink );
+}
+
+/*
+===============
+G_WakeThinkers
+
+Wake the entities due to think this frame
+===============
+*/
+void G_WakeThinkers( void )
+{
+  G_ThinkWakeDue( &thinkScheduler, level.time );
+}
+
+/*
+===============
+G_NextAwakeEntity
+
+The first entity at or after num that G_RunFrame needs to visit
+===============
+*/
+int G_NextAwakeEntity( int num )
+{
+  return G_ThinkNextAwake( &thinkScheduler, num );
+}
+
+#define THINK_BENCH_FRAME_MSEC  50
+
+static thinkScheduler_t thinkBenchScheduler;
+static int              thinkBenchNext[ MAX_GENTITIES ];
+
+/*
+===============
+G_ThinkBenchPeriod
+
+Think intervals between 100 and 1000 msec, the range of most buildables,
+movers and target entities
+===============
+*/
+static int G_ThinkBenchPeriod( int num, int frame )
+{
+  return 100 + ( ( num * 7919 + frame * 104729 ) % 10 ) * 100;
+}
+
+/*
+===============
+G_ThinkBenchVisit
+
+The tests G_RunFrame makes of an entity before it does anything with it
+===============
+*/
+static int G_ThinkBenchVisit( gentity_t *ent )
+{
+  if( !ent->inuse )
+    return 0;
+
+  if( level.time - ent->eventTime > EVENT_VALID_MSEC &&
+      ( ent->s.event || ent->freeAfterEvent || ent->unlinkAfterEvent ) )
+    return 1;
+
+  if( ent->freeAfterEvent || ent->evaluateAcceleration )
+    return 1;
+
+  if( ent->s.eType == ET_MISSILE || ent->s.eType == ET_BUILDABLE ||
+      ent->s.eType == ET_CORPSE || ent->physicsObject ||
+      ent->s.eType == ET_MOVER || ent->s.number < MAX_CLIENTS )
+    return 2;
+
+  return ( ent->nextthink > 0 && ent->nextthink <= level.time ) ? 3 : 4;
+}
+
+/*
+===============
+G_ThinkBenchmark
+
+First walk the current map's entities frames times, once over every slot
+as G_RunFrame used to and once over the awake slots only, without running
+anything. Then run count synthetic thinkers for frames frames both ways and
+check that they think in the same order. Neither half times G_RunFrame
+itself, so this shows the cost of the entity walk, not of a whole frame
+===============
+*/
+void G_ThinkBenchmark( int count, int frames )
+{
+  thinkScheduler_t  *ts = &thinkBenchScheduler;
+  int               i, frame, time;
+  int               start, scanMsec, schedMsec;
+  int               scanThinks = 0, schedThinks = 0, visits = 0;
+  unsigned int      scanOrder = 0, schedOrder = 0;
+  int               awake = 0, parked = 0, result = 0;
+
+  if( count <= 0 )
+    count = 900;
+  if( count > MAX_GENTITIES - MAX_CLIENTS )
+    count = MAX_GENTITIES - MAX_CLIENTS;
+  if( frames <= 0 )
+    frames = 1000;
+
+  for( i = MAX_CLIENTS; i < level.num_entities; i++ )
+  {
+    if( !g_entities[ i ].inuse )
+      continue;
+
+    if( thinkScheduler.parked[ i ] )
+      parked++;
+    else
+      awake++;
+  }
+
+  start = trap_Milliseconds( );
+  for( frame = 0; frame < frames; frame++ )
+  {
+    for( i = 0; i < level.num_entities; i++ )
+      result += G_ThinkBenchVisit( &g_entities[ i ] );
+  }
+  scanMsec = trap_Milliseconds( ) - start;
+
+  start = trap_Milliseconds( );
+  for( frame = 0; frame < frames; frame++ )
+  {
+    for( i = G_NextAwakeEntity( 0 ); i < level.num_entities; i = G_NextAwakeEntity( i + 1 ) )
+      result += G_ThinkBenchVisit( &g_entities[ i ] );
+  }
+  schedMsec = trap_Milliseconds( ) - start;
+
+  G_Printf( "think: this map has %d entities, %d awake and %d parked (%d)\n",
+            awake + parked, awake, parked, result & 1 );
+  G_Printf( "  %d frames walking every slot: %dms\n", frames, scanMsec );
+  G_Printf( "  %d frames walking awake slots: %dms\n", frames, schedMsec );
+
+  // every slot, every frame
+  for( i = 0; i < count; i++ )
+    thinkBenchNext[ i ] = G_ThinkBenchPeriod( i, 0 );
+
+  start = trap_Milliseconds( );
+
+  for( frame = 1; frame <= frames; frame++ )
+  {
+    time = frame * THINK_BENCH_FRAME_MSEC;
+
+    for( i = 0; i < count; i++ )
+    {
+      if( thinkBenchNext[ i ] <= 0 || thinkBenchNext[ i ] > time )
+        continue;
+
+      thinkBenchNext[ i ] = time + G_ThinkBenchPeriod( i, frame );
+      scanOrder = scanOrder * 31 + i;
+      scanThinks++;
+    }
+  }
+
+  scanMsec = trap_Milliseconds( ) - start;
+
+  // only the awake slots, parking each one after it has thought
+  G_ThinkInit( ts );
+  for( i = 0; i < count; i++ )
+  {
+    thinkBenchNext[ i ] = G_ThinkBenchPeriod( i, 0 );
+    G_ThinkPark( ts, i, thinkBenchNext[ i ] );
+  }
+
+  start = trap_Milliseconds( );
+
+  for( frame = 1; frame <= frames; frame++ )
+  {
+    time = frame * THINK_BENCH_FRAME_MSEC;
+    G_ThinkWakeDue( ts, time );
+
+    for( i = G_ThinkNextAwake( ts, 0 ); i < count; i = G_ThinkNextAwake( ts, i + 1 ) )
+    {
+      visits++;
+
+      if( thinkBenchNext[ i ] > 0 && thinkBenchNext[ i ] <= time )
+      {
+        thinkBenchNext[ i ] = time + G_ThinkBenchPeriod( i, frame );
+        schedOrder = schedOrder * 31 + i;
+        schedThinks++;
+      }
+
+      G_ThinkPark( ts, i, thinkBenchNext[ i ] );
+    }
+  }
+
+  schedMsec = trap_Milliseconds( ) - start;
+
+  G_Printf( "think: %d synthetic thinkers for %d frames, %d thinks\n",
+            count, frames, scanThinks );
+  G_Printf( "  scan:      %dms, %d visits\n", scanMsec, count * frames );
+  G_Printf( "  scheduled: %dms, %d visits\n", schedMsec, visits );
+  G_Printf( "  think order %s\n", ( scanThinks == schedThinks && scanOrder == schedOrder ) ?
+            "matches" : S_COLOR_RED "DIFFERS" );
+}
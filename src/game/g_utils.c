@@ -411,6 +411,7 @@ void G_InitGentity( gentity_t *e )
   e->classname = "noclass";
   e->s.number = e - g_entities;
   e->r.ownerNum = ENTITYNUM_NONE;
+  G_WakeEntity( e );
 }
 
 /*
@@ -520,6 +521,9 @@ void G_FreeEntity( gentity_t *ent )
   if( ent->neverFree )
     return;
 
+  if( ent->bpAccount )
+    G_UnaccountBuildable( ent );
+
   memset( ent, 0, sizeof( *ent ) );
   ent->classname = "freent";
   ent->freetime = level.time;
@@ -663,6 +667,9 @@ void G_AddEvent( gentity_t *ent, int event, int eventParm )
     bits = ( bits + EV_EVENT_BIT1 ) & EV_EVENT_BITS;
     ent->s.event = event | bits;
     ent->s.eventParm = eventParm;
+
+    // G_RunFrame has to clear it again
+    G_WakeEntity( ent );
   }
 
   ent->eventTime = level.time;
@@ -1063,6 +1063,134 @@ LEVEL2
 
 static zap_t  zaps[ MAX_CLIENTS ];
 
+// number of zap chains each entity slot is currently a target of
+static int    zapTargeted[ MAX_GENTITIES ];
+
+// live human targets near the zaps being solved, gathered with a single
+// trap_EntitiesInBox and shared by every target search in that solve
+static struct
+{
+  qboolean  valid;
+  vec3_t    mins, maxs;
+  int       num;
+  gentity_t *ents[ MAX_GENTITIES ];
+} zapNeighbors;
+
+// line of sight between a zap source and target, valid until either moves
+#define ZAP_REACH_CACHE 256
+
+typedef struct
+{
+  int       source, target;
+  vec3_t    sourceOrigin, targetOrigin;
+  qboolean  reachable;
+} zapReach_t;
+
+static zapReach_t zapReach[ ZAP_REACH_CACHE ];
+
+/*
+===============
+G_IsZapTarget
+===============
+*/
+static qboolean G_IsZapTarget( gentity_t *ent )
+{
+  return ( ( ent->client && ent->client->ps.stats[ STAT_PTEAM ] == PTE_HUMANS ) ||
+           ( ent->s.eType == ET_BUILDABLE &&
+             BG_FindTeamForBuildable( ent->s.modelindex ) == BIT_HUMANS ) ) &&
+         ent->health > 0;
+}
+
+/*
+===============
+G_ZapSearchBox
+
+The box a zap source searches for new targets in
+===============
+*/
+static void G_ZapSearchBox( const vec3_t origin, float scale, vec3_t mins, vec3_t maxs )
+{
+  vec3_t range = { LEVEL2_AREAZAP_RANGE, LEVEL2_AREAZAP_RANGE, LEVEL2_AREAZAP_RANGE };
+
+  VectorScale( range, scale / M_ROOT3, range );
+  VectorAdd( origin, range, maxs );
+  VectorSubtract( origin, range, mins );
+}
+
+/*
+===============
+G_BuildZapNeighbors
+
+Gather every live human target within chain reach of the points in
+[mins, maxs] into zapNeighbors
+===============
+*/
+static void G_BuildZapNeighbors( const vec3_t mins, const vec3_t maxs )
+{
+  int       entityList[ MAX_GENTITIES ];
+  vec3_t    reachMins, reachMaxs;
+  int       i, num;
+  gentity_t *ent;
+
+  // a chain can hop MAX_ZAP_TARGETS times from any of its members
+  G_ZapSearchBox( vec3_origin, MAX_ZAP_TARGETS + 1, reachMins, reachMaxs );
+  VectorAdd( mins, reachMins, zapNeighbors.mins );
+  VectorAdd( maxs, reachMaxs, zapNeighbors.maxs );
+
+  num = trap_EntitiesInBox( zapNeighbors.mins, zapNeighbors.maxs,
+                            entityList, MAX_GENTITIES );
+
+  zapNeighbors.num = 0;
+  for( i = 0; i < num; i++ )
+  {
+    ent = &g_entities[ entityList[ i ] ];
+
+    if( G_IsZapTarget( ent ) )
+      zapNeighbors.ents[ zapNeighbors.num++ ] = ent;
+  }
+
+  zapNeighbors.valid = qtrue;
+}
+
+/*
+===============
+G_ZapReachable
+
+Whether a zap can arc from source to target, cached per pair until either
+of them moves
+===============
+*/
+static qboolean G_ZapReachable( gentity_t *source, gentity_t *target )
+{
+  zapReach_t  *reach;
+  vec3_t      start;
+  trace_t     tr;
+
+  reach = &zapReach[ ( source->s.number * 31 + target->s.number ) &
+                     ( ZAP_REACH_CACHE - 1 ) ];
+
+  if( reach->source == source->s.number && reach->target == target->s.number &&
+      VectorCompare( reach->sourceOrigin, source->s.origin ) &&
+      VectorCompare( reach->targetOrigin, target->s.origin ) )
+    return reach->reachable;
+
+  // arc from the middle of the source so buildables don't start in the floor
+  VectorAdd( source->r.absmin, source->r.absmax, start );
+  VectorScale( start, 0.5f, start );
+
+  trap_Trace( &tr, start, NULL, NULL, target->s.origin, source->s.number, MASK_SHOT );
+
+  reach->source = source->s.number;
+  reach->target = target->s.number;
+  VectorCopy( source->s.origin, reach->sourceOrigin );
+  VectorCopy( target->s.origin, reach->targetOrigin );
+
+  //can't see target from here
+  reach->reachable = ( tr.entityNum != ENTITYNUM_WORLD );
+
+  return reach->reachable;
+}
+
 /*
 ===============
 G_FindNewZapTarget
@@ -1070,61 +1198,80 @@ G_FindNewZapTarget
 */
 static gentity_t *G_FindNewZapTarget( gentity_t *ent )
 {
-  int       entityList[ MAX_GENTITIES ];
-  vec3_t    range = { LEVEL2_AREAZAP_RANGE, LEVEL2_AREAZAP_RANGE, LEVEL2_AREAZAP_RANGE };
   vec3_t    mins, maxs;
-  int       i, j, k, num;
+  int       i;
   gentity_t *enemy;
-  trace_t   tr;
 
-  VectorScale( range, 1.0f / M_ROOT3, range );
-  VectorAdd( ent->s.origin, range, maxs );
-  VectorSubtract( ent->s.origin, range, mins );
+  G_ZapSearchBox( ent->s.origin, 1.0f, mins, maxs );
 
-  num = trap_EntitiesInBox( mins, maxs, entityList, MAX_GENTITIES );
+  if( !zapNeighbors.valid ||
+      mins[ 0 ] < zapNeighbors.mins[ 0 ] || maxs[ 0 ] > zapNeighbors.maxs[ 0 ] ||
+      mins[ 1 ] < zapNeighbors.mins[ 1 ] || maxs[ 1 ] > zapNeighbors.maxs[ 1 ] ||
+      mins[ 2 ] < zapNeighbors.mins[ 2 ] || maxs[ 2 ] > zapNeighbors.maxs[ 2 ] )
+    G_BuildZapNeighbors( ent->s.origin, ent->s.origin );
 
-  for( i = 0; i < num; i++ )
+  for( i = 0; i < zapNeighbors.num; i++ )
   {
-    enemy = &g_entities[ entityList[ i ] ];
+    enemy = zapNeighbors.ents[ i ];
 
-    if( ( ( enemy->client && enemy->client->ps.stats[ STAT_PTEAM ] == PTE_HUMANS ) ||
-        ( enemy->s.eType == ET_BUILDABLE &&
-          BG_FindTeamForBuildable( enemy->s.modelindex ) == BIT_HUMANS ) ) && enemy->health > 0 )
-    {
-      qboolean foundOldTarget = qfalse;
+    // may have died to an earlier link this frame
+    if( !enemy->inuse || !G_IsZapTarget( enemy ) )
+      continue;
 
-      trap_Trace( &tr, muzzle, NULL, NULL, enemy->s.origin, ent->s.number, MASK_SHOT );
+    if( enemy->r.absmin[ 0 ] > maxs[ 0 ] || enemy->r.absmax[ 0 ] < mins[ 0 ] ||
+        enemy->r.absmin[ 1 ] > maxs[ 1 ] || enemy->r.absmax[ 1 ] < mins[ 1 ] ||
+        enemy->r.absmin[ 2 ] > maxs[ 2 ] || enemy->r.absmax[ 2 ] < mins[ 2 ] )
+      continue;
 
-      //can't see target from here
-      if( tr.entityNum == ENTITYNUM_WORLD )
-        continue;
+    // enemy is already targetted
+    if( zapTargeted[ enemy - g_entities ] )
+      continue;
 
-      for( j = 0; j < MAX_ZAPS; j++ )
-      {
-        zap_t *zap = &zaps[ j ];
+    if( !G_ZapReachable( ent, enemy ) )
+      continue;
 
-        for( k = 0; k < zap->numTargets; k++ )
-        {
-          if( zap->targets[ k ] == enemy )
-          {
-            foundOldTarget = qtrue;
-            break;
-          }
-        }
+    return enemy;
+  }
 
-        if( foundOldTarget )
-          break;
-      }
+  return NULL;
+}
 
-      // enemy is already targetted
-      if( foundOldTarget )
-        continue;
+/*
+===============
+G_SetZapTarget
 
-      return enemy;
-    }
+Replace one link of a zap chain, keeping zapTargeted in step
+===============
+*/
+static void G_SetZapTarget( zap_t *zap, int index, gentity_t *target )
+{
+  if( index < zap->numTargets && zap->targets[ index ] )
+    zapTargeted[ zap->targets[ index ] - g_entities ]--;
+
+  zap->targets[ index ] = target;
+
+  if( target )
+    zapTargeted[ target - g_entities ]++;
+}
+
+/*
+===============
+G_TruncateZap
+
+Forget every link of a zap chain from index on
+===============
+*/
+static void G_TruncateZap( zap_t *zap, int index )
+{
+  int j;
+
+  for( j = index; j < zap->numTargets; j++ )
+  {
+    if( zap->targets[ j ] )
+      zapTargeted[ zap->targets[ j ] - g_entities ]--;
   }
 
-  return NULL;
+  zap->numTargets = index;
 }
 
 /*
@@ -1169,6 +1316,7 @@ static void G_CreateNewZap( gentity_t *creator, gentity_t *target )
 {
   int       i, j;
   zap_t     *zap;
+  gentity_t *next;
 
   for( i = 0; i < MAX_ZAPS; i++ )
   {
@@ -1183,17 +1331,25 @@ static void G_CreateNewZap( gentity_t *creator, gentity_t *target )
 
       zap->creator = creator;
 
-      zap->targets[ 0 ] = target;
+      zap->numTargets = 0;
+      G_SetZapTarget( zap, 0, target );
       zap->numTargets = 1;
 
-      for( j = 1; j < MAX_ZAP_TARGETS && zap->targets[ j - 1 ]; j++ )
+      G_BuildZapNeighbors( target->s.origin, target->s.origin );
+
+      for( j = 1; j < MAX_ZAP_TARGETS; j++ )
       {
-        zap->targets[ j ] = G_FindNewZapTarget( zap->targets[ j - 1 ] );
+        next = G_FindNewZapTarget( zap->targets[ j - 1 ] );
 
-        if( zap->targets[ j ] )
-          zap->numTargets++;
+        if( !next )
+          break;
+
+        G_SetZapTarget( zap, j, next );
+        zap->numTargets++;
       }
 
+      zapNeighbors.valid = qfalse;
+
       zap->effectChannel = G_Spawn( );
       G_UpdateZapEffect( zap );
 
@@ -1206,6 +1362,9 @@ static void G_CreateNewZap( gentity_t *creator, gentity_t *target )
 /*
 ===============
 G_UpdateZaps
+
+Revalidate every zap chain against a neighbour list shared by all of them,
+then apply this frame's damage
 ===============
 */
 void G_UpdateZaps( int msec )
@@ -1213,6 +1372,35 @@ void G_UpdateZaps( int msec )
   int   i, j;
   zap_t *zap;
   int   damage;
+  vec3_t mins, maxs;
+  qboolean retarget = qfalse;
+
+  ClearBounds( mins, maxs );
+
+  // find which links need a new target and the area they could search
+  for( i = 0; i < MAX_ZAPS; i++ )
+  {
+    zap = &zaps[ i ];
+
+    if( !zap->used )
+      continue;
+
+    for( j = 0; j < zap->numTargets; j++ )
+    {
+      gentity_t *source = j ? zap->targets[ j - 1 ] : zap->creator;
+      gentity_t *target = zap->targets[ j ];
+
+      if( target->health <= 0 || !target->inuse || //early out
+          Distance( source->s.origin, target->s.origin ) > LEVEL2_AREAZAP_RANGE )
+      {
+        AddPointToBounds( source->s.origin, mins, maxs );
+        retarget = qtrue;
+      }
+    }
+  }
+
+  if( retarget )
+    G_BuildZapNeighbors( mins, maxs );
 
   for( i = 0; i < MAX_ZAPS; i++ )
   {
@@ -1234,11 +1422,13 @@ void G_UpdateZaps( int msec )
         if( target->health <= 0 || !target->inuse || //early out
             Distance( source->s.origin, target->s.origin ) > LEVEL2_AREAZAP_RANGE )
         {
-          target = zap->targets[ j ] = G_FindNewZapTarget( source );
+          target = G_FindNewZapTarget( source );
 
           //couldn't find a target, so forget about the rest of the chain
           if( !target )
-            zap->numTargets = j;
+            G_TruncateZap( zap, j );
+          else
+            G_SetZapTarget( zap, j, target );
         }
       }
 
@@ -1283,11 +1473,14 @@ void G_UpdateZaps( int msec )
 
       if( zap->timeToLive <= 0 || zap->numTargets == 0 || zap->creator->health <= 0 )
       {
+        G_TruncateZap( zap, 0 );
         zap->used = qfalse;
         G_FreeEntity( zap->effectChannel );
       }
     }
   }
+
+  zapNeighbors.valid = qfalse;
 }
 
 /*